@@ -0,0 +1,274 @@
+#pragma once
+#include "handle.hpp"
+#include "iostream.hpp"
+#include <map>
+
+namespace tr {
+	/** @ingroup misc
+	 *  @defgroup asset_archive Asset Archives
+	 *  Packed asset archives and memory-mapped loading.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Malformed asset archive exception.
+	 ******************************************************************************************************************/
+	struct AssetArchiveError : FileError {
+		using FileError::FileError;
+
+		/**************************************************************************************************************
+		 * Gets an error message.
+		 *
+		 * @return An explanatory error message.
+		 **************************************************************************************************************/
+		const char* what() const noexcept override;
+	};
+
+	/******************************************************************************************************************
+	 * The alignment of asset data within an asset archive in bytes.
+	 ******************************************************************************************************************/
+	inline constexpr std::size_t ASSET_ARCHIVE_ALIGNMENT{16};
+
+	/******************************************************************************************************************
+	 * Read-only, memory-mapped asset archive.
+	 *
+	 * An archive packs many assets into a single file made of a header, an index sorted by name and the asset data,
+	 * with every asset aligned to ASSET_ARCHIVE_ALIGNMENT bytes. Opening an archive maps the whole file into memory
+	 * and validates its index, after which assets are looked up with a binary search and returned as spans into the
+	 * mapping, without any copying or further file I/O. These can be passed straight to the loadEmbedded* functions:
+	 *
+	 * @code
+	 * tr::AssetArchive archive{"assets.tra"};
+	 * tr::Bitmap       bitmap{tr::loadEmbeddedBitmap(archive["textures/player.png"])};
+	 * tr::AudioBuffer  audio{tr::loadEmbeddedAudio(archive["sounds/jump.ogg"])};
+	 * @endcode
+	 *
+	 * Archives are created with AssetArchiveWriter. They are stored in the byte order of the machine that wrote them.
+	 *
+	 * The spans returned by the archive are valid for as long as the archive is alive. Since the archive is never
+	 * modified after opening, it can safely be read from multiple threads at once.
+	 *
+	 * AssetArchive is non-copyable and movable.
+	 ******************************************************************************************************************/
+	class AssetArchive {
+	  public:
+		/**************************************************************************************************************
+		 * Opens and maps an asset archive.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception FileNotFound If the file isn't found.
+		 * @exception FileOpenError If opening or mapping the file fails.
+		 * @exception AssetArchiveError If the file isn't a valid asset archive.
+		 *
+		 * @param[in] path The path to the archive file.
+		 **************************************************************************************************************/
+		explicit AssetArchive(const std::filesystem::path& path);
+
+		/**************************************************************************************************************
+		 * Gets the number of assets in the archive.
+		 *
+		 * @return The number of assets in the archive.
+		 **************************************************************************************************************/
+		std::size_t size() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the name of an asset.
+		 *
+		 * @param[in] index
+		 * @parblock
+		 * The index of the asset. Assets are sorted by name.
+		 *
+		 * @pre @em index must be less than size().
+		 * @endparblock
+		 *
+		 * @return A view over the name of the asset.
+		 **************************************************************************************************************/
+		std::string_view name(std::size_t index) const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the data of an asset.
+		 *
+		 * @param[in] index
+		 * @parblock
+		 * The index of the asset. Assets are sorted by name.
+		 *
+		 * @pre @em index must be less than size().
+		 * @endparblock
+		 *
+		 * @return A span over the data of the asset.
+		 **************************************************************************************************************/
+		std::span<const std::byte> data(std::size_t index) const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets whether the archive contains an asset.
+		 *
+		 * @param[in] name The name of the asset.
+		 *
+		 * @return True if the archive contains an asset named @em name, false otherwise.
+		 **************************************************************************************************************/
+		bool contains(std::string_view name) const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the data of an asset by name.
+		 *
+		 * @param[in] name
+		 * @parblock
+		 * The name of the asset.
+		 *
+		 * @pre The archive must contain an asset named @em name.
+		 * @endparblock
+		 *
+		 * @return A span over the data of the asset.
+		 **************************************************************************************************************/
+		std::span<const std::byte> operator[](std::string_view name) const noexcept;
+
+	  private:
+		// Index entry of an asset, as stored in the archive.
+		struct Entry {
+			std::uint64_t nameOffset; // The offset of the name of the asset within the archive.
+			std::uint32_t nameLength; // The length of the name of the asset.
+			std::uint32_t flags;      // Reserved, always 0.
+			std::uint64_t dataOffset; // The offset of the data of the asset within the archive.
+			std::uint64_t dataSize;   // The size of the data of the asset.
+		};
+
+		struct Unmapper {
+			std::size_t size; // The size of the mapping.
+
+			void operator()(const std::byte* data) const noexcept;
+		};
+
+		Handle<const std::byte*, nullptr, Unmapper> _mapping; // The mapped archive file.
+		std::span<const Entry>                      _index;   // The index of the archive.
+
+		// Gets the name of an index entry.
+		std::string_view entryName(const Entry& entry) const noexcept;
+		// Finds the index entry of an asset, or returns _index.end() if it's not in the archive.
+		std::span<const Entry>::iterator find(std::string_view name) const noexcept;
+
+		friend class AssetArchiveWriter;
+	};
+
+	/******************************************************************************************************************
+	 * Builder of asset archives.
+	 *
+	 * Assets added from files are only read when the archive is written, so packing large asset directories doesn't
+	 * require holding them in memory. A minimal packing tool looks like this:
+	 *
+	 * @code
+	 * int main(int argc, char** argv)
+	 * {
+	 *     tr::AssetArchiveWriter writer;
+	 *     writer.addDirectory(argv[1]);
+	 *     writer.write(argv[2]);
+	 * }
+	 * @endcode
+	 *
+	 * AssetArchiveWriter is copyable and movable.
+	 ******************************************************************************************************************/
+	class AssetArchiveWriter {
+	  public:
+		/**************************************************************************************************************
+		 * Gets the number of assets added to the writer.
+		 *
+		 * @return The number of assets.
+		 **************************************************************************************************************/
+		std::size_t size() const noexcept;
+
+		/**************************************************************************************************************
+		 * Adds an asset from memory.
+		 *
+		 * The data is copied into the writer.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] name
+		 * @parblock
+		 * The name of the asset.
+		 *
+		 * @pre No asset named @em name may have been added to the writer.
+		 * @endparblock
+		 * @param[in] data The data of the asset.
+		 **************************************************************************************************************/
+		void add(std::string name, std::span<const std::byte> data);
+
+		/**************************************************************************************************************
+		 * Adds an asset from a file.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception FileNotFound If the file isn't found.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] name
+		 * @parblock
+		 * The name of the asset.
+		 *
+		 * @pre No asset named @em name may have been added to the writer.
+		 * @endparblock
+		 * @param[in] path The path to the file. The file must not change until the archive is written.
+		 **************************************************************************************************************/
+		void addFile(std::string name, const std::filesystem::path& path);
+
+		/**************************************************************************************************************
+		 * Adds every regular file within a directory and its subdirectories.
+		 *
+		 * Every asset is named after the path of its file relative to the directory, using forward slashes as
+		 * separators (for example, "textures/player.png").
+		 *
+		 * @par Exception Safety
+		 *
+		 * Basic exception guarantee.
+		 *
+		 * @exception FileNotFound If the path doesn't lead to a directory.
+		 * @exception std::filesystem::filesystem_error If iterating the directory fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] directory The path to the directory.
+		 * @param[in] prefix
+		 * @parblock
+		 * A prefix prepended to every asset name.
+		 *
+		 * @pre No asset whose name is formed this way may have been added to the writer.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void addDirectory(const std::filesystem::path& directory, std::string_view prefix = {});
+
+		/**************************************************************************************************************
+		 * Writes the archive to a file.
+		 *
+		 * @par Exception Safety
+		 *
+		 * No exception guarantee: the file may be left partially written.
+		 *
+		 * @exception FileOpenError If the archive file or a file added with addFile() can't be opened.
+		 * @exception FileNotFound If a file added with addFile() was removed.
+		 * @exception AssetArchiveError If a file added with addFile() changed size since it was added.
+		 * @exception std::ios_base::failure If writing the archive or reading a file fails.
+		 *
+		 * @param[in] path The path to the archive file.
+		 **************************************************************************************************************/
+		void write(const std::filesystem::path& path) const;
+
+	  private:
+		// Source of an asset's data.
+		struct Source {
+			std::vector<std::byte> data; // The data of the asset, if it was added from memory.
+			std::filesystem::path  path; // The path to the asset file, if it was added from a file.
+			std::uint64_t          size; // The size of the asset.
+		};
+
+		std::map<std::string, Source, std::less<>> _sources; // The assets to write, sorted by name.
+	};
+
+	/// @}
+} // namespace tr
@@ -0,0 +1,252 @@
+#pragma once
+#include "audio_buffer.hpp"
+#include "bitmap.hpp"
+#include "chrono.hpp"
+#include "texture.hpp"
+#include <condition_variable>
+#include <deque>
+#include <future>
+
+namespace tr {
+	/** @ingroup misc
+	 *  @defgroup asset_loader Asset Loader
+	 *  Asynchronous asset loading.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Asynchronous asset loader backed by a pool of worker threads.
+	 *
+	 * Loading an asset is split into two stages: decoding, which doesn't touch the graphics or audio context and
+	 * runs on a worker thread (file I/O, image and audio decoding), and finalization, which runs on the main thread
+	 * when finalize() is called (GPU texture and audio buffer creation). Assets that don't need finalizing are
+	 * available as soon as they're decoded.
+	 *
+	 * Results are returned through futures. If loading an asset throws, the exception is rethrown by the future. If
+	 * the loader is destroyed before an asset is loaded, the future reports std::future_errc::broken_promise.
+	 *
+	 * AssetLoader is non-copyable and non-movable.
+	 *
+	 * @note The loader must be created and destroyed on the main thread, and finalize() must be called on it.
+	 ******************************************************************************************************************/
+	class AssetLoader {
+	  public:
+		/**************************************************************************************************************
+		 * Creates an asset loader.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::system_error If launching a worker thread fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] threads The number of worker threads, or 0 to use one less than the number of hardware threads.
+		 **************************************************************************************************************/
+		explicit AssetLoader(unsigned int threads = 0);
+
+		/**************************************************************************************************************
+		 * Cancels all assets that haven't started loading yet, waits for the ones being decoded and destroys the
+		 * loader.
+		 **************************************************************************************************************/
+		~AssetLoader() noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of worker threads.
+		 *
+		 * @return The number of worker threads.
+		 **************************************************************************************************************/
+		unsigned int threads() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of assets that are waiting to be decoded, being decoded or waiting to be finalized.
+		 *
+		 * @return The number of pending assets.
+		 **************************************************************************************************************/
+		std::size_t pending() const noexcept;
+
+		/**************************************************************************************************************
+		 * Queues an asset that only needs decoding.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] decode The decoding function, called on a worker thread.
+		 *
+		 * @return A future to the decoded asset.
+		 **************************************************************************************************************/
+		template <std::invocable Decode> std::future<std::invoke_result_t<Decode>> submit(Decode&& decode);
+
+		/**************************************************************************************************************
+		 * Queues an asset that needs decoding and finalizing.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] decode The decoding function, called on a worker thread.
+		 * @param[in] finalize
+		 * The finalizing function, called on the main thread by finalize() with the result of @em decode as an
+		 * rvalue.
+		 *
+		 * @return A future to the finalized asset.
+		 **************************************************************************************************************/
+		template <std::invocable Decode, std::invocable<std::invoke_result_t<Decode>&&> Finalize>
+		std::future<std::invoke_result_t<Finalize, std::invoke_result_t<Decode>&&>> submit(Decode&&   decode,
+																						   Finalize&& finalize);
+
+		/**************************************************************************************************************
+		 * Queues a bitmap file to be loaded.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] path The path to the bitmap file.
+		 *
+		 * @return A future to the bitmap, which rethrows the exceptions of loadBitmapFile().
+		 **************************************************************************************************************/
+		std::future<Bitmap> loadBitmap(std::filesystem::path path);
+
+		/**************************************************************************************************************
+		 * Queues a bitmap file to be loaded into a texture.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] path The path to the bitmap file.
+		 * @param[in] mipmapped Whether the texture should have mipmaps.
+		 * @param[in] format The internal format of the texture.
+		 *
+		 * @return A future to the texture, which rethrows the exceptions of loadBitmapFile() and TextureBadAlloc.
+		 **************************************************************************************************************/
+		std::future<ColorTexture2D> loadTexture(std::filesystem::path path, bool mipmapped = false,
+												ColorTextureFormat format = ColorTextureFormat::RGBA8);
+
+		/**************************************************************************************************************
+		 * Queues an audio file to be decoded.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] path The path to the audio file.
+		 *
+		 * @return A future to the audio data, which rethrows the exceptions of decodeAudioFile().
+		 **************************************************************************************************************/
+		std::future<AudioData> loadAudio(std::filesystem::path path);
+
+		/**************************************************************************************************************
+		 * Queues an audio file to be loaded into an audio buffer.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] path The path to the audio file.
+		 *
+		 * @return A future to the audio buffer, which rethrows the exceptions of loadAudioFile().
+		 **************************************************************************************************************/
+		std::future<AudioBuffer> loadAudioBuffer(std::filesystem::path path);
+
+		/**************************************************************************************************************
+		 * Finalizes decoded assets until there are none left or the time budget is spent.
+		 *
+		 * At least one asset is finalized if any are waiting, even if doing so exceeds the budget, so that loading
+		 * always makes progress.
+		 *
+		 * @param[in] budget The amount of time to spend finalizing assets.
+		 *
+		 * @return The number of finalized assets.
+		 **************************************************************************************************************/
+		std::size_t finalize(Duration budget) noexcept;
+
+	  private:
+		using Task = std::packaged_task<void()>;
+
+		mutable std::mutex       _mutex;      // Protects the queues and counters.
+		std::condition_variable  _condition;  // Signals queued tasks and shutdown to the workers.
+		std::deque<Task>         _tasks;      // The decoding tasks waiting for a worker.
+		std::deque<Task>         _finalizers; // The finalizing tasks waiting for finalize().
+		std::size_t              _running;    // The number of decoding tasks being run.
+		bool                     _stopping;   // Whether the workers should exit.
+		std::vector<std::thread> _workers;    // The worker threads.
+
+		// Queues a decoding task.
+		void enqueue(Task task);
+		// Queues a finalizing task.
+		void enqueueFinalizer(Task task);
+		// Stops and joins the workers.
+		void stop() noexcept;
+		// Runs decoding tasks until the loader is stopped.
+		void work() noexcept;
+	};
+
+	/// @}
+} // namespace tr
+
+/// @cond IMPLEMENTATION
+
+template <std::invocable Decode>
+std::future<std::invoke_result_t<Decode>> tr::AssetLoader::submit(Decode&& decode)
+{
+	std::packaged_task<std::invoke_result_t<Decode>()> task{std::forward<Decode>(decode)};
+	std::future<std::invoke_result_t<Decode>>          future{task.get_future()};
+	enqueue(Task{std::move(task)});
+	return future;
+}
+
+template <std::invocable Decode, std::invocable<std::invoke_result_t<Decode>&&> Finalize>
+std::future<std::invoke_result_t<Finalize, std::invoke_result_t<Decode>&&>> tr::AssetLoader::submit(
+	Decode&& decode, Finalize&& finalize)
+{
+	using Decoded   = std::invoke_result_t<Decode>;
+	using Finalized = std::invoke_result_t<Finalize, Decoded&&>;
+
+	std::promise<Finalized> promise;
+	std::future<Finalized>  future{promise.get_future()};
+	enqueue(Task{[this, decode = std::forward<Decode>(decode), finalize = std::forward<Finalize>(finalize),
+				  promise = std::move(promise)]() mutable {
+		std::optional<Decoded> decoded;
+		try {
+			decoded.emplace(std::invoke(decode));
+		}
+		catch (...) {
+			promise.set_exception(std::current_exception());
+			return;
+		}
+		// If queueing the finalizer fails, the promise is destroyed along with it and the future reports it as broken.
+		enqueueFinalizer(Task{[decoded = std::move(*decoded), finalize = std::move(finalize),
+							   promise = std::move(promise)]() mutable {
+			try {
+				if constexpr (std::is_void_v<Finalized>) {
+					std::invoke(finalize, std::move(decoded));
+					promise.set_value();
+				}
+				else {
+					promise.set_value(std::invoke(finalize, std::move(decoded)));
+				}
+			}
+			catch (...) {
+				promise.set_exception(std::current_exception());
+			}
+		}});
+	}});
+	return future;
+}
+
+/// @endcond
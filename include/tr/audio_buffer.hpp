@@ -52,6 +52,26 @@ namespace tr {
 		STEREO16 = 0x1103 // 16-bit stereo audio.
 	};
 
+	/******************************************************************************************************************
+	 * Decoded audio data residing in CPU memory.
+	 ******************************************************************************************************************/
+	struct AudioData {
+		/**************************************************************************************************************
+		 * The interleaved samples of the audio.
+		 **************************************************************************************************************/
+		std::vector<std::int16_t> samples;
+
+		/**************************************************************************************************************
+		 * The format of the audio.
+		 **************************************************************************************************************/
+		AudioFormat format;
+
+		/**************************************************************************************************************
+		 * The frequency of the audio.
+		 **************************************************************************************************************/
+		int frequency;
+	};
+
 	/******************************************************************************************************************
 	 * Non-owning audio buffer view.
 	 ******************************************************************************************************************/
@@ -185,6 +205,48 @@ namespace tr {
 		Handle<unsigned int, 0, Deleter> _id;
 	};
 
+	/******************************************************************************************************************
+	 * Decodes audio data from an embedded file without creating an audio buffer.
+	 *
+	 * Unlike loadEmbeddedAudio(), this function doesn't touch OpenAL, so it may be called from any thread.
+	 *
+	 * @par Exception Safety
+	 *
+	 * Strong exception guarantee.
+	 *
+	 * @exception std::bad_alloc If allocating the sample storage fails.
+	 *
+	 * @param[in] data
+	 * @parblock
+	 * The embedded file data.
+	 *
+	 * @pre @em data is assumed to always be a valid audio file.
+	 * @endparblock
+	 *
+	 * @return The decoded audio data.
+	 ******************************************************************************************************************/
+	AudioData decodeEmbeddedAudio(std::span<const std::byte> data);
+
+	/******************************************************************************************************************
+	 * Decodes audio data from file without creating an audio buffer.
+	 *
+	 * Unlike loadAudioFile(), this function doesn't touch OpenAL, so it may be called from any thread.
+	 *
+	 * @par Exception Safety
+	 *
+	 * Strong exception guarantee.
+	 *
+	 * @exception FileNotFound If the file isn't found.
+	 * @exception FileOpenError If opening the file fails.
+	 * @exception UnsupportedAudioFile If the file is an unsupported or invalid format.
+	 * @exception std::bad_alloc If allocating the sample storage fails.
+	 *
+	 * @param[in] path The path to an audio file.
+	 *
+	 * @return The decoded audio data.
+	 ******************************************************************************************************************/
+	AudioData decodeAudioFile(const std::filesystem::path& path);
+
 	/******************************************************************************************************************
 	 * Loads audio data from an embedded file to a buffer.
 	 *
@@ -0,0 +1,283 @@
+#pragma once
+#include "draw_geometry.hpp"
+#include "graphics_context.hpp"
+#include "streaming_buffer.hpp"
+#include "texture_unit.hpp"
+#include "vertex.hpp"
+
+namespace tr {
+	class Texture;
+
+	/** @ingroup graphics
+	 *  @defgroup batch_renderer Batch Renderer
+	 *  Batched 2D sprite and shape renderer.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * The render state a batched mesh is drawn with.
+	 ******************************************************************************************************************/
+	struct BatchState {
+		/**************************************************************************************************************
+		 * The draw layer of the mesh.
+		 *
+		 * Meshes are drawn in order of ascending layer. Within a layer, meshes are reordered to minimize state
+		 * changes, so meshes that must be drawn on top of each other in a specific order should be put in separate
+		 * layers.
+		 **************************************************************************************************************/
+		std::int32_t layer = 0;
+
+		/**************************************************************************************************************
+		 * The shader pipeline used to draw the mesh.
+		 *
+		 * The pipeline's vertex shader is fed TintVtx2 vertices.
+		 **************************************************************************************************************/
+		const ShaderPipeline* pipeline = nullptr;
+
+		/**************************************************************************************************************
+		 * The texture bound to the batch renderer's texture unit while drawing the mesh, or nullptr to leave the
+		 * texture unit as-is (useful for untextured shapes).
+		 **************************************************************************************************************/
+		const Texture* texture = nullptr;
+
+		/**************************************************************************************************************
+		 * The blending mode used to draw the mesh.
+		 **************************************************************************************************************/
+		BlendMode blendMode = ALPHA_BLENDING;
+
+		friend bool operator==(const BatchState& l, const BatchState& r) noexcept = default;
+	};
+
+	/******************************************************************************************************************
+	 * Writable mesh storage returned by BatchRenderer::addMesh().
+	 ******************************************************************************************************************/
+	struct BatchMesh {
+		/**************************************************************************************************************
+		 * The vertices of the mesh.
+		 **************************************************************************************************************/
+		std::span<TintVtx2> vertices;
+
+		/**************************************************************************************************************
+		 * The indices of the mesh, relative to the first vertex of the mesh.
+		 **************************************************************************************************************/
+		std::span<std::uint16_t> indices;
+	};
+
+	/******************************************************************************************************************
+	 * Batched 2D sprite and shape renderer.
+	 *
+	 * Meshes are accumulated on the CPU over a frame, then sorted by layer and render state, written into a single
+	 * streaming buffer and drawn with the minimum number of draw calls: a new draw call is only started when the render
+	 * state changes or the 16-bit index range of the current one is exhausted.
+	 *
+	 * All meshes are drawn as triangles made of TintVtx2 vertices, with the texture (if any) bound to textureUnit().
+	 *
+	 * BatchRenderer is non-copyable and movable.
+	 ******************************************************************************************************************/
+	class BatchRenderer {
+	  public:
+		/**************************************************************************************************************
+		 * The default capacity of the streaming buffer used by the renderer.
+		 **************************************************************************************************************/
+		static constexpr std::size_t DEFAULT_CAPACITY{16 * 1024 * 1024};
+
+		/**************************************************************************************************************
+		 * Creates a batch renderer.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception GraphicsBufferBadAlloc If allocating the streaming buffer fails.
+		 * @exception GraphicsBufferMapBadAlloc If mapping the streaming buffer fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] capacity
+		 * @parblock
+		 * The capacity of the streaming buffer in bytes.
+		 *
+		 * @pre @em capacity must be large enough to hold the vertices and indices of all frames in flight.
+		 * @endparblock
+		 **************************************************************************************************************/
+		explicit BatchRenderer(std::size_t capacity = DEFAULT_CAPACITY);
+
+		/**************************************************************************************************************
+		 * Gets the texture unit the batch textures are bound to.
+		 *
+		 * Shaders used with the renderer should sample from this unit.
+		 *
+		 * @return A reference to the texture unit.
+		 **************************************************************************************************************/
+		const TextureUnit& textureUnit() const noexcept;
+
+		/**************************************************************************************************************
+		 * Adds an arbitrary triangle mesh to the batch.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] state The render state of the mesh.
+		 * @param[in] vertices
+		 * @parblock
+		 * The number of vertices in the mesh.
+		 *
+		 * @pre @em vertices must be greater than 0 and no greater than 65536.
+		 * @endparblock
+		 * @param[in] indices
+		 * @parblock
+		 * The number of indices in the mesh.
+		 *
+		 * @pre @em indices must be a multiple of 3.
+		 * @endparblock
+		 *
+		 * @return Storage for the mesh, valid until the next call to a function that adds to or draws the batch.
+		 **************************************************************************************************************/
+		BatchMesh addMesh(const BatchState& state, std::size_t vertices, std::size_t indices);
+
+		/**************************************************************************************************************
+		 * Adds a solid colored rectangle to the batch.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] state The render state of the rectangle.
+		 * @param[in] rect The rectangle.
+		 * @param[in] color The color of the rectangle.
+		 **************************************************************************************************************/
+		void addRect(const BatchState& state, const RectF2& rect, RGBA8 color);
+
+		/**************************************************************************************************************
+		 * Adds a rectangle outline to the batch.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] state The render state of the outline.
+		 * @param[in] rect The rectangle.
+		 * @param[in] thickness The thickness of the outline.
+		 * @param[in] color The color of the outline.
+		 **************************************************************************************************************/
+		void addRectOutline(const BatchState& state, const RectF2& rect, float thickness, RGBA8 color);
+
+		/**************************************************************************************************************
+		 * Adds a textured sprite to the batch.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] state The render state of the sprite.
+		 * @param[in] rect The rectangle the sprite is drawn to.
+		 * @param[in] uv The normalized texture rectangle of the sprite.
+		 * @param[in] tint The tint of the sprite.
+		 **************************************************************************************************************/
+		void addSprite(const BatchState& state, const RectF2& rect, const RectF2& uv, RGBA8 tint = {255, 255, 255, 255});
+
+		/**************************************************************************************************************
+		 * Adds a solid colored regular polygon to the batch.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] state The render state of the polygon.
+		 * @param[in] vertices
+		 * @parblock
+		 * The number of vertices of the polygon.
+		 *
+		 * @pre @em vertices must be in the range [3, 65535].
+		 * @endparblock
+		 * @param[in] circle The bounding circle of the polygon.
+		 * @param[in] rotation The rotation of the polygon.
+		 * @param[in] color The color of the polygon.
+		 **************************************************************************************************************/
+		void addPolygon(const BatchState& state, std::size_t vertices, CircleF circle, AngleF rotation, RGBA8 color);
+
+		/**************************************************************************************************************
+		 * Adds a regular polygon outline to the batch.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] state The render state of the outline.
+		 * @param[in] vertices
+		 * @parblock
+		 * The number of vertices of the polygon.
+		 *
+		 * @pre @em vertices must be in the range [3, 32768].
+		 * @endparblock
+		 * @param[in] circle The bounding circle of the polygon.
+		 * @param[in] rotation The rotation of the polygon.
+		 * @param[in] thickness The thickness of the outline.
+		 * @param[in] color The color of the outline.
+		 **************************************************************************************************************/
+		void addPolygonOutline(const BatchState& state, std::size_t vertices, CircleF circle, AngleF rotation,
+							   float thickness, RGBA8 color);
+
+		/**************************************************************************************************************
+		 * Draws and clears the batch.
+		 *
+		 * The blending mode, shader pipeline, vertex format, vertex buffer and index buffer are left in an unspecified
+		 * state afterwards.
+		 *
+		 * @param[in] context The graphics context to draw with.
+		 **************************************************************************************************************/
+		void draw(GraphicsContext& context) noexcept;
+
+		/**************************************************************************************************************
+		 * Clears the batch without drawing it.
+		 **************************************************************************************************************/
+		void clear() noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of draw calls issued by the last call to draw().
+		 *
+		 * @return The number of draw calls.
+		 **************************************************************************************************************/
+		std::size_t drawCalls() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of render state changes made by the last call to draw().
+		 *
+		 * @return The number of state changes.
+		 **************************************************************************************************************/
+		std::size_t stateChanges() const noexcept;
+
+	  private:
+		// A mesh queued for drawing.
+		struct Mesh {
+			BatchState    state;       // The render state of the mesh.
+			std::uint32_t firstVertex; // The offset of the mesh within the vertex vector.
+			std::uint32_t vertexCount; // The number of vertices in the mesh.
+			std::uint32_t firstIndex;  // The offset of the mesh within the index vector.
+			std::uint32_t indexCount;  // The number of indices in the mesh.
+		};
+
+		StreamingBuffer            _buffer;       // The streaming buffer the batches are written into.
+		TextureUnit                _textureUnit;  // The texture unit batch textures are bound to.
+		std::vector<Mesh>          _meshes;       // The queued meshes.
+		std::vector<TintVtx2>      _vertices;     // The vertices of the queued meshes.
+		std::vector<std::uint16_t> _indices;      // The indices of the queued meshes, relative to their mesh.
+		std::vector<glm::vec2>     _positions;    // Scratch storage for generated positions.
+		std::size_t                _drawCalls;    // The number of draw calls issued by the last draw().
+		std::size_t                _stateChanges; // The number of state changes made by the last draw().
+	};
+
+	/// @}
+} // namespace tr
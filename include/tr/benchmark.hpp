@@ -1,6 +1,5 @@
 #pragma once
 #include "chrono.hpp"
-#include <deque>
 
 namespace tr {
 	/** @ingroup misc
@@ -12,20 +11,58 @@ namespace tr {
 	/******************************************************************************************************************
 	 * Minimal benchmarking class.
 	 *
-	 * The benchmark stores intervals between calls to start() and stop() going up to 2.5s back for calculations like
-	 * average/min/max.
+	 * The benchmark stores intervals between calls to start() and stop() going up to a configurable window (2.5s by
+	 * default) back for calculations like average/min/max/percentiles.
+	 *
+	 * Measurements are stored in a fixed-capacity ring buffer allocated on construction, so recording a measurement
+	 * never allocates. If the ring buffer fills up before measurements leave the window, the oldest measurements are
+	 * dropped early: statistics then only cover the most recent capacity() measurements, and the number of dropped
+	 * measurements can be checked with dropped(). The default capacity holds a full default window of measurements
+	 * taken at up to ~6500 per second.
+	 *
+	 * Minimum, maximum and average queries are O(1), while percentile queries are approximate (within ~3% of the true
+	 * value) and run in constant time relative to the number of measurements.
 	 *******************************************************************************************************************/
 	class Benchmark {
 	  public:
 		/**************************************************************************************************************
-		 * Shorthand for the deque type used by the benchmark.
+		 * Shorthand for a measurement (start time and duration) stored by the benchmark.
+		 **************************************************************************************************************/
+		using Measurement = std::pair<TimePoint, Duration>;
+
+		/**************************************************************************************************************
+		 * The default measurement window.
+		 **************************************************************************************************************/
+		static constexpr Duration DEFAULT_WINDOW{std::chrono::milliseconds{2500}};
+
+		/**************************************************************************************************************
+		 * The default maximum number of stored measurements.
 		 **************************************************************************************************************/
-		using Deque = std::deque<std::pair<TimePoint, Duration>>;
+		static constexpr std::size_t DEFAULT_CAPACITY{16384};
 
 		/**************************************************************************************************************
 		 * Constructs an empty benchmark.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If allocating the measurement storage fails.
+		 *
+		 * @param[in] window
+		 * @parblock
+		 * The length of time measurements are kept for.
+		 *
+		 * @pre @em window must be greater than 0.
+		 * @endparblock
+		 * @param[in] capacity
+		 * @parblock
+		 * The maximum number of measurements that can be kept at once.
+		 *
+		 * @pre @em capacity must be greater than 0.
+		 * @endparblock
 		 **************************************************************************************************************/
-		Benchmark() noexcept = default;
+		explicit Benchmark(Duration window = DEFAULT_WINDOW, std::size_t capacity = DEFAULT_CAPACITY);
 
 		/**************************************************************************************************************
 		 * Starts a new measurement.
@@ -38,14 +75,17 @@ namespace tr {
 		 * Stops a measurement.
 		 *
 		 * @pre This function cannot be called if a measurement was not started.
+		 **************************************************************************************************************/
+		void stop() noexcept;
+
+		/**************************************************************************************************************
+		 * Adds an externally measured duration as a measurement ending at the current time.
 		 *
-		 * @par Exception Safety
+		 * This is useful for durations that can't be bracketed by start() and stop(), such as GPU timings.
 		 *
-		 * Strong exception guarantee.
-		 *
-		 * @exception std::bad_alloc If an internal allocation fails.
+		 * @param[in] duration The measured duration.
 		 **************************************************************************************************************/
-		void stop();
+		void add(Duration duration) noexcept;
 
 		/**************************************************************************************************************
 		 * Clears all previous measurements from the queue.
@@ -54,6 +94,34 @@ namespace tr {
 		 **************************************************************************************************************/
 		void clear() noexcept;
 
+		/**************************************************************************************************************
+		 * Gets the length of time measurements are kept for.
+		 *
+		 * @return The measurement window.
+		 **************************************************************************************************************/
+		Duration window() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the maximum number of measurements that can be kept at once.
+		 *
+		 * @return The measurement capacity.
+		 **************************************************************************************************************/
+		std::size_t capacity() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of available measurements.
+		 *
+		 * @return The number of available measurements.
+		 **************************************************************************************************************/
+		std::size_t size() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of measurements dropped before leaving the window because the benchmark was full.
+		 *
+		 * @return The number of measurements dropped early since construction or the last call to clear().
+		 **************************************************************************************************************/
+		std::size_t dropped() const noexcept;
+
 		/**************************************************************************************************************
 		 * Gets the duration of the latest measurement.
 		 *
@@ -82,23 +150,83 @@ namespace tr {
 		 **************************************************************************************************************/
 		Duration average() const noexcept;
 
+		/**************************************************************************************************************
+		 * Gets an approximate percentile of the durations of the available measurements.
+		 *
+		 * @param[in] fraction
+		 * @parblock
+		 * The percentile as a fraction (0.5 for the median, 0.99 for p99, etc.).
+		 *
+		 * @pre @em fraction must be in the range [0, 1].
+		 * @endparblock
+		 *
+		 * @return The approximate percentile duration, or 0s if no measurements are in the queue.
+		 **************************************************************************************************************/
+		Duration percentile(double fraction) const noexcept;
+
 		/**************************************************************************************************************
 		 * Gets the average number of measurements per second.
 		 *
+		 * If the benchmark is full, the rate is calculated over the span of the stored measurements instead of the
+		 * whole window, as measurements may have been dropped early.
+		 *
 		 * @return The average number of measurements per second, or 0 if no measurements are in the queue.
 		 **************************************************************************************************************/
 		double fps() const noexcept;
 
 		/**************************************************************************************************************
-		 * Gets the available measurements.
+		 * Gets a copy of the available measurements, from oldest to newest.
 		 *
-		 * @return A reference to the measurement queue.
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If allocating the vector fails.
+		 *
+		 * @return A vector containing the available measurements.
 		 **************************************************************************************************************/
-		const Deque& measurements() const noexcept;
+		std::vector<Measurement> measurements() const;
 
 	  private:
-		Deque     _durations;  // The measurement deque.
+		// Fixed-capacity queue of measurement slot indices used for the running min/max.
+		struct SlotQueue {
+			std::vector<std::uint32_t> slots; // The slot ring buffer.
+			std::size_t                first; // The index of the first element in the ring buffer.
+			std::size_t                size;  // The number of elements in the ring buffer.
+
+			std::uint32_t front() const noexcept;
+			std::uint32_t back() const noexcept;
+			void          pushBack(std::uint32_t slot) noexcept;
+			void          popFront() noexcept;
+			void          popBack() noexcept;
+		};
+
+		// Number of linear sub-buckets per power of two in the histogram.
+		static constexpr std::size_t HISTOGRAM_SUB_BUCKETS{16};
+		// The total number of histogram buckets, enough for durations up to ~36 minutes.
+		static constexpr std::size_t HISTOGRAM_BUCKETS{HISTOGRAM_SUB_BUCKETS * 38};
+
+		std::vector<Measurement>                     _measurements; // The measurement ring buffer.
+		std::size_t                                  _first;        // The index of the oldest measurement.
+		std::size_t                                  _size;         // The number of stored measurements.
+		std::size_t                                  _dropped;      // The number of measurements dropped early.
+		Duration                                     _window;       // The measurement window.
+		Duration                                     _sum;          // The sum of the stored durations.
+		SlotQueue                                    _minQueue;     // Monotonically increasing durations.
+		SlotQueue                                    _maxQueue;     // Monotonically decreasing durations.
+		std::array<std::uint32_t, HISTOGRAM_BUCKETS> _histogram;    // Log-linear duration histogram.
 		TimePoint _startPoint; // The start point of the latest started (but not ended) measurement.
+
+		// Appends a measurement, dropping the oldest one if the buffer is full.
+		void push(const Measurement& measurement) noexcept;
+		// Evicts the measurements that started before the window ending at a time point.
+		void evictOutdated(TimePoint now) noexcept;
+		// Evicts the oldest measurement.
+		void pop() noexcept;
+		// Gets the histogram bucket a duration belongs to.
+		static std::size_t histogramBucket(Duration duration) noexcept;
+		// Gets the representative duration of a histogram bucket.
+		static Duration histogramValue(std::size_t bucket) noexcept;
 	};
 
 	/// @}
@@ -57,6 +57,225 @@ namespace tr {
 		const char* what() const noexcept override;
 	};
 
+	/******************************************************************************************************************
+	 * Concept denoting a type that can be used to directly access the pixels of a bitmap.
+	 *
+	 * Any trivially copyable type can be used as long as its size matches the size of a pixel of the bitmap format,
+	 * but the contents are only meaningful if its memory layout matches the format as well.
+	 ******************************************************************************************************************/
+	template <class T>
+	concept BitmapPixel = std::is_trivially_copyable_v<T> && sizeof(T) <= 4;
+
+	/******************************************************************************************************************
+	 * The bitmap format matching the memory layout of a pixel type, or BitmapFormat::UNKNOWN if it isn't tied to one.
+	 ******************************************************************************************************************/
+	template <BitmapPixel T> inline constexpr BitmapFormat::Type BITMAP_PIXEL_FORMAT{BitmapFormat::UNKNOWN};
+
+	/// @cond IMPLEMENTATION
+	template <>
+	inline constexpr BitmapFormat::Type BITMAP_PIXEL_FORMAT<RGBA8>{
+		std::endian::native == std::endian::little ? BitmapFormat::ABGR_8888 : BitmapFormat::RGBA_8888};
+	template <>
+	inline constexpr BitmapFormat::Type BITMAP_PIXEL_FORMAT<BGRA<std::uint8_t>>{
+		std::endian::native == std::endian::little ? BitmapFormat::ARGB_8888 : BitmapFormat::BGRA_8888};
+	template <> inline constexpr BitmapFormat::Type BITMAP_PIXEL_FORMAT<RGB8>{BitmapFormat::RGB_24};
+	template <> inline constexpr BitmapFormat::Type BITMAP_PIXEL_FORMAT<BGR<std::uint8_t>>{BitmapFormat::BGR_24};
+	/// @endcond
+
+	/******************************************************************************************************************
+	 * Typed view over the rows of a bitmap region.
+	 *
+	 * Each row is a contiguous span of pixels, so algorithms over it can run at memory bandwidth instead of going
+	 * through the per-pixel format lookups of the generic pixel iterators.
+	 *
+	 * @tparam T The pixel type, const-qualified for read-only access.
+	 ******************************************************************************************************************/
+	template <class T> class BitmapRows : public std::ranges::view_interface<BitmapRows<T>> {
+	  public:
+		/**************************************************************************************************************
+		 * Byte pointer type with the constness of the pixel type.
+		 **************************************************************************************************************/
+		using BytePtr = std::conditional_t<std::is_const_v<T>, const std::byte*, std::byte*>;
+
+		/**************************************************************************************************************
+		 * Row iterator.
+		 *
+		 * The iterator fulfills the @em RandomAccessIterator requirements.
+		 **************************************************************************************************************/
+		class Iterator {
+		  public:
+			using iterator_concept = std::random_access_iterator_tag;
+			using value_type       = std::span<T>;
+			using difference_type  = int;
+
+			/**********************************************************************************************************
+			 * Default-constructs an iterator.
+			 *
+			 * An iterator constructed in this manner is in an non-dereferencable state until a valid value is
+			 * assigned to it.
+			 **********************************************************************************************************/
+			constexpr Iterator() noexcept = default;
+
+			/**********************************************************************************************************
+			 * Constructs an iterator to a row.
+			 *
+			 * @param[in] row A pointer to the first pixel of the row.
+			 * @param[in] pitch The distance between rows in bytes.
+			 * @param[in] width The number of pixels in a row.
+			 **********************************************************************************************************/
+			constexpr Iterator(BytePtr row, int pitch, int width) noexcept;
+
+			/**********************************************************************************************************
+			 * Three-way comparison operator.
+			 **********************************************************************************************************/
+			constexpr std::strong_ordering operator<=>(const Iterator& r) const noexcept;
+
+			/**********************************************************************************************************
+			 * Equality comparison operator.
+			 **********************************************************************************************************/
+			constexpr bool operator==(const Iterator& r) const noexcept;
+
+			/**********************************************************************************************************
+			 * Dereferences the iterator.
+			 *
+			 * @return A span over the pixels of the row.
+			 **********************************************************************************************************/
+			constexpr value_type operator*() const noexcept;
+
+			/**********************************************************************************************************
+			 * Dereferences the iterator with a subscript.
+			 *
+			 * @param[in] diff The row relative to the iterator to access.
+			 *
+			 * @return A span over the pixels of the row.
+			 **********************************************************************************************************/
+			constexpr value_type operator[](difference_type diff) const noexcept;
+
+			/**********************************************************************************************************
+			 * Increments the iterator.
+			 *
+			 * @return A reference to the iterator.
+			 **********************************************************************************************************/
+			constexpr Iterator& operator++() noexcept;
+
+			/**********************************************************************************************************
+			 * Post-increments the iterator.
+			 *
+			 * @return An iterator with the prior state of the incremented iterator.
+			 **********************************************************************************************************/
+			constexpr Iterator operator++(int) noexcept;
+
+			/**********************************************************************************************************
+			 * Decrements the iterator.
+			 *
+			 * @return A reference to the iterator.
+			 **********************************************************************************************************/
+			constexpr Iterator& operator--() noexcept;
+
+			/**********************************************************************************************************
+			 * Post-decrements the iterator.
+			 *
+			 * @return An iterator with the prior state of the decremented iterator.
+			 **********************************************************************************************************/
+			constexpr Iterator operator--(int) noexcept;
+
+			/**********************************************************************************************************
+			 * Advances the iterator.
+			 *
+			 * @param[in] diff The number of rows to advance by.
+			 *
+			 * @return A reference to the iterator.
+			 **********************************************************************************************************/
+			constexpr Iterator& operator+=(difference_type diff) noexcept;
+
+			/**********************************************************************************************************
+			 * Moves the iterator back.
+			 *
+			 * @param[in] diff The number of rows to move back by.
+			 *
+			 * @return A reference to the iterator.
+			 **********************************************************************************************************/
+			constexpr Iterator& operator-=(difference_type diff) noexcept;
+
+			/**********************************************************************************************************
+			 * Adds to an iterator.
+			 **********************************************************************************************************/
+			friend constexpr Iterator operator+(const Iterator& it, difference_type diff) noexcept
+			{
+				Iterator copy{it};
+				return copy += diff;
+			}
+
+			/**********************************************************************************************************
+			 * Adds to an iterator.
+			 **********************************************************************************************************/
+			friend constexpr Iterator operator+(difference_type diff, const Iterator& it) noexcept
+			{
+				return it + diff;
+			}
+
+			/**********************************************************************************************************
+			 * Subtracts from an iterator.
+			 **********************************************************************************************************/
+			friend constexpr Iterator operator-(const Iterator& it, difference_type diff) noexcept
+			{
+				Iterator copy{it};
+				return copy -= diff;
+			}
+
+			/**********************************************************************************************************
+			 * Gets the distance between two iterators.
+			 **********************************************************************************************************/
+			friend constexpr difference_type operator-(const Iterator& l, const Iterator& r) noexcept
+			{
+				return static_cast<difference_type>((l._row - r._row) / l._pitch);
+			}
+
+		  private:
+			BytePtr _row{nullptr}; // A pointer to the first pixel of the row.
+			int     _pitch{1};     // The distance between rows in bytes.
+			int     _width{0};     // The number of pixels in a row.
+		};
+
+		/**************************************************************************************************************
+		 * Default-constructs an empty row view.
+		 **************************************************************************************************************/
+		constexpr BitmapRows() noexcept = default;
+
+		/**************************************************************************************************************
+		 * Constructs a row view.
+		 *
+		 * @param[in] data
+		 * @parblock
+		 * A pointer to the first pixel of the first row.
+		 *
+		 * @pre @em data must be suitably aligned for @em T.
+		 * @endparblock
+		 * @param[in] pitch The distance between rows in bytes.
+		 * @param[in] size The size of the region in pixels.
+		 **************************************************************************************************************/
+		constexpr BitmapRows(BytePtr data, int pitch, glm::ivec2 size) noexcept;
+
+		/**************************************************************************************************************
+		 * Gets an iterator to the first row.
+		 *
+		 * @return An iterator to the first row.
+		 **************************************************************************************************************/
+		constexpr Iterator begin() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets an iterator to one past the last row.
+		 *
+		 * @return An iterator to one past the last row.
+		 **************************************************************************************************************/
+		constexpr Iterator end() const noexcept;
+
+	  private:
+		BytePtr    _data{nullptr}; // A pointer to the first pixel of the first row.
+		int        _pitch{1};      // The distance between rows in bytes.
+		glm::ivec2 _size{};        // The size of the region in pixels.
+	};
+
 	/******************************************************************************************************************
 	 * View over a rectangular region of a bitmap.
 	 ******************************************************************************************************************/
@@ -154,6 +373,21 @@ namespace tr {
 		 **************************************************************************************************************/
 		Iterator cend() const noexcept;
 
+		/**************************************************************************************************************
+		 * Gets a typed view over the rows of the sub-bitmap.
+		 *
+		 * @tparam T
+		 * @parblock
+		 * The pixel type.
+		 *
+		 * @pre The size of @em T must match the pixel size of the bitmap format, and if @em T is tied to a format
+		 *      (see BITMAP_PIXEL_FORMAT), the bitmap must be of that format.
+		 * @endparblock
+		 *
+		 * @return A view over the rows of the sub-bitmap.
+		 **************************************************************************************************************/
+		template <BitmapPixel T> BitmapRows<const T> rows() const noexcept;
+
 		/**************************************************************************************************************
 		 * Gets the raw data of the sub-bitmap.
 		 *
@@ -318,6 +552,21 @@ namespace tr {
 		 **************************************************************************************************************/
 		Iterator cend() const noexcept;
 
+		/**************************************************************************************************************
+		 * Gets a typed view over the rows of the bitmap.
+		 *
+		 * @tparam T
+		 * @parblock
+		 * The pixel type.
+		 *
+		 * @pre The size of @em T must match the pixel size of the bitmap format, and if @em T is tied to a format
+		 *      (see BITMAP_PIXEL_FORMAT), the bitmap must be of that format.
+		 * @endparblock
+		 *
+		 * @return A view over the rows of the bitmap.
+		 **************************************************************************************************************/
+		template <BitmapPixel T> BitmapRows<const T> rows() const noexcept;
+
 		/**************************************************************************************************************
 		 * Creates a sub-bitmap spanning the entire bitmap view.
 		 **************************************************************************************************************/
@@ -391,6 +640,9 @@ namespace tr {
 
 	/******************************************************************************************************************
 	 * Class containing owned bitmap data.
+	 *
+	 * Conversions from 32-bit, 24-bit and 16-bit packed RGB(A) formats to 32-bit RGBA formats use vectorized kernels
+	 * (SSE2, with AVX2 selected at runtime when available); other conversions fall back to a generic path.
 	 ******************************************************************************************************************/
 	class Bitmap {
 	  public:
@@ -452,6 +704,9 @@ namespace tr {
 		/**************************************************************************************************************
 		 * Clones a sub-bitmap.
 		 *
+		 * The sub-bitmap is blitted onto a transparent bitmap exactly like blit() would, so the blend mode and color
+		 * modulation of the source are applied regardless of the format of the new bitmap.
+		 *
 		 * @par Exception Safety
 		 *
 		 * Strong exception guarantee.
@@ -544,6 +799,58 @@ namespace tr {
 		 **************************************************************************************************************/
 		ConstIt cend() const noexcept;
 
+		/**************************************************************************************************************
+		 * Gets a mutable typed view over the rows of the bitmap.
+		 *
+		 * @tparam T
+		 * @parblock
+		 * The pixel type.
+		 *
+		 * @pre The size of @em T must match the pixel size of the bitmap format, and if @em T is tied to a format
+		 *      (see BITMAP_PIXEL_FORMAT), the bitmap must be of that format.
+		 * @endparblock
+		 *
+		 * @return A view over the rows of the bitmap.
+		 **************************************************************************************************************/
+		template <BitmapPixel T> BitmapRows<T> rows() noexcept;
+
+		/**************************************************************************************************************
+		 * Gets an immutable typed view over the rows of the bitmap.
+		 *
+		 * @tparam T
+		 * @parblock
+		 * The pixel type.
+		 *
+		 * @pre The size of @em T must match the pixel size of the bitmap format, and if @em T is tied to a format
+		 *      (see BITMAP_PIXEL_FORMAT), the bitmap must be of that format.
+		 * @endparblock
+		 *
+		 * @return A view over the rows of the bitmap.
+		 **************************************************************************************************************/
+		template <BitmapPixel T> BitmapRows<const T> rows() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets a mutable typed view over the rows of a region of the bitmap.
+		 *
+		 * @tparam T
+		 * @parblock
+		 * The pixel type.
+		 *
+		 * @pre The size of @em T must match the pixel size of the bitmap format, and if @em T is tied to a format
+		 *      (see BITMAP_PIXEL_FORMAT), the bitmap must be of that format.
+		 * @endparblock
+		 *
+		 * @param[in] rect
+		 * @parblock
+		 * The region of the bitmap.
+		 *
+		 * @pre @em rect is not allowed to stretch outside the bitmap bounds.
+		 * @endparblock
+		 *
+		 * @return A view over the rows of the region.
+		 **************************************************************************************************************/
+		template <BitmapPixel T> BitmapRows<T> rows(const RectI2& rect) noexcept;
+
 		/**************************************************************************************************************
 		 * Blits a sub-bitmap to the bitmap.
 		 *
@@ -570,6 +877,21 @@ namespace tr {
 		 **************************************************************************************************************/
 		void fill(const RectI2& rect, RGBA8 color) noexcept;
 
+		/**************************************************************************************************************
+		 * Multiplies the color channels of every pixel by its alpha.
+		 *
+		 * Does nothing if the format of the bitmap has no alpha channel.
+		 **************************************************************************************************************/
+		void premultiplyAlpha() noexcept;
+
+		/**************************************************************************************************************
+		 * Divides the color channels of every pixel by its alpha, undoing premultiplyAlpha().
+		 *
+		 * Precision lost to premultiplication is not recovered. Fully transparent pixels become transparent black.
+		 * Does nothing if the format of the bitmap has no alpha channel.
+		 **************************************************************************************************************/
+		void unpremultiplyAlpha() noexcept;
+
 		/**************************************************************************************************************
 		 * Creates a sub-bitmap spanning the entire bitmap.
 		 **************************************************************************************************************/
@@ -734,4 +1056,118 @@ constexpr const char* tr::BitmapBadAlloc::what() const noexcept
 	return "failed bitmap allocation";
 }
 
+template <class T>
+constexpr tr::BitmapRows<T>::Iterator::Iterator(BytePtr row, int pitch, int width) noexcept
+	: _row{row}, _pitch{pitch}, _width{width}
+{
+}
+
+template <class T>
+constexpr std::strong_ordering tr::BitmapRows<T>::Iterator::operator<=>(const Iterator& r) const noexcept
+{
+	return std::compare_three_way{}(_row, r._row);
+}
+
+template <class T> constexpr bool tr::BitmapRows<T>::Iterator::operator==(const Iterator& r) const noexcept
+{
+	return _row == r._row;
+}
+
+template <class T> constexpr std::span<T> tr::BitmapRows<T>::Iterator::operator*() const noexcept
+{
+	return {reinterpret_cast<T*>(_row), static_cast<std::size_t>(_width)};
+}
+
+template <class T> constexpr std::span<T> tr::BitmapRows<T>::Iterator::operator[](difference_type diff) const noexcept
+{
+	return *(*this + diff);
+}
+
+template <class T> constexpr typename tr::BitmapRows<T>::Iterator& tr::BitmapRows<T>::Iterator::operator++() noexcept
+{
+	_row += _pitch;
+	return *this;
+}
+
+template <class T> constexpr typename tr::BitmapRows<T>::Iterator tr::BitmapRows<T>::Iterator::operator++(int) noexcept
+{
+	Iterator prev{*this};
+	++(*this);
+	return prev;
+}
+
+template <class T> constexpr typename tr::BitmapRows<T>::Iterator& tr::BitmapRows<T>::Iterator::operator--() noexcept
+{
+	_row -= _pitch;
+	return *this;
+}
+
+template <class T> constexpr typename tr::BitmapRows<T>::Iterator tr::BitmapRows<T>::Iterator::operator--(int) noexcept
+{
+	Iterator prev{*this};
+	--(*this);
+	return prev;
+}
+
+template <class T>
+constexpr typename tr::BitmapRows<T>::Iterator& tr::BitmapRows<T>::Iterator::operator+=(difference_type diff) noexcept
+{
+	_row += static_cast<std::ptrdiff_t>(diff) * _pitch;
+	return *this;
+}
+
+template <class T>
+constexpr typename tr::BitmapRows<T>::Iterator& tr::BitmapRows<T>::Iterator::operator-=(difference_type diff) noexcept
+{
+	_row -= static_cast<std::ptrdiff_t>(diff) * _pitch;
+	return *this;
+}
+
+template <class T>
+constexpr tr::BitmapRows<T>::BitmapRows(BytePtr data, int pitch, glm::ivec2 size) noexcept
+	: _data{data}, _pitch{pitch}, _size{size}
+{
+	assert(reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0);
+}
+
+template <class T> constexpr typename tr::BitmapRows<T>::Iterator tr::BitmapRows<T>::begin() const noexcept
+{
+	return {_data, _pitch, _size.x};
+}
+
+template <class T> constexpr typename tr::BitmapRows<T>::Iterator tr::BitmapRows<T>::end() const noexcept
+{
+	return {_data + static_cast<std::ptrdiff_t>(_size.y) * _pitch, _pitch, _size.x};
+}
+
+template <tr::BitmapPixel T> tr::BitmapRows<const T> tr::SubBitmap::rows() const noexcept
+{
+	assert(format().pixelBytes() == sizeof(T));
+	assert(BITMAP_PIXEL_FORMAT<T> == BitmapFormat::Type::UNKNOWN || format() == BITMAP_PIXEL_FORMAT<T>);
+	return {data(), pitch(), size()};
+}
+
+template <tr::BitmapPixel T> tr::BitmapRows<const T> tr::BitmapView::rows() const noexcept
+{
+	return SubBitmap{*this}.rows<T>();
+}
+
+template <tr::BitmapPixel T> tr::BitmapRows<T> tr::Bitmap::rows() noexcept
+{
+	return rows<T>({{}, size()});
+}
+
+template <tr::BitmapPixel T> tr::BitmapRows<const T> tr::Bitmap::rows() const noexcept
+{
+	return SubBitmap{*this}.rows<T>();
+}
+
+template <tr::BitmapPixel T> tr::BitmapRows<T> tr::Bitmap::rows(const RectI2& rect) noexcept
+{
+	assert(format().pixelBytes() == sizeof(T));
+	assert(BITMAP_PIXEL_FORMAT<T> == BitmapFormat::Type::UNKNOWN || format() == BITMAP_PIXEL_FORMAT<T>);
+	assert(RectI2{size()}.contains(rect.tl + rect.size));
+	return {data() + rect.tl.y * pitch() + rect.tl.x * static_cast<int>(sizeof(T)), pitch(), rect.size};
+}
+
 /// @endcond
@@ -0,0 +1,424 @@
+#pragma once
+#include "pipeline_state.hpp"
+#include <mutex>
+
+namespace tr {
+	class IndexBuffer;
+	class StreamingBuffer;
+	class TextureUnit;
+	class VertexBuffer;
+
+	/** @ingroup graphics
+	 *  @defgroup command_buffer Command Buffers
+	 *  Deferred recording of graphics commands.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * A list of graphics commands recorded for later execution.
+	 *
+	 * Recording doesn't touch the graphics context, so command buffers can be recorded on any thread (one thread per
+	 * buffer at a time) and then executed in order on the thread that owns the context. Commands are stored in a
+	 * compact linear byte stream; clearing a buffer keeps its storage, so a recycled buffer doesn't allocate once it's
+	 * warmed up.
+	 *
+	 * Commands refer to graphics objects by address, so all objects passed to a command must outlive the execution of
+	 * the buffer. Buffer uploads copy their data into the command stream when recorded.
+	 ******************************************************************************************************************/
+	class CommandBuffer {
+	  public:
+		/**************************************************************************************************************
+		 * Creates an empty command buffer.
+		 **************************************************************************************************************/
+		CommandBuffer() noexcept;
+
+		/**************************************************************************************************************
+		 * Gets whether the buffer has no commands.
+		 *
+		 * @return True if the buffer is empty, and false otherwise.
+		 **************************************************************************************************************/
+		bool empty() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of recorded commands.
+		 *
+		 * @return The number of commands in the buffer.
+		 **************************************************************************************************************/
+		std::size_t commands() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the size of the recorded command stream.
+		 *
+		 * @return The size of the command stream in bytes.
+		 **************************************************************************************************************/
+		std::size_t size() const noexcept;
+
+		/**************************************************************************************************************
+		 * Reserves storage for the command stream.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If allocating the storage fails.
+		 *
+		 * @param[in] bytes The minimum capacity of the command stream in bytes.
+		 **************************************************************************************************************/
+		void reserve(std::size_t bytes);
+
+		/**************************************************************************************************************
+		 * Removes all commands from the buffer, keeping its storage.
+		 **************************************************************************************************************/
+		void clear() noexcept;
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::setPipelineState().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] state The new pipeline state.
+		 **************************************************************************************************************/
+		void setPipelineState(const PipelineState& state);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::setShaderPipeline().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] pipeline The new active shader pipeline.
+		 **************************************************************************************************************/
+		void setShaderPipeline(const ShaderPipeline& pipeline);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::setVertexFormat().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] format The new active vertex format.
+		 **************************************************************************************************************/
+		void setVertexFormat(const VertexFormat& format);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::setVertexBuffer().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] buffer The new active vertex buffer.
+		 * @param[in] offset
+		 * @parblock
+		 * The starting offset within the buffer.
+		 *
+		 * @pre @em offset must be within the bounds of the buffer when the command is executed.
+		 * @endparblock
+		 * @param[in] vertexStride The distance between consecutive vertices.
+		 **************************************************************************************************************/
+		void setVertexBuffer(const VertexBuffer& buffer, std::size_t offset, std::size_t vertexStride);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::setVertexBuffer() with a streaming buffer.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] buffer The new active vertex buffer.
+		 * @param[in] offset
+		 * @parblock
+		 * The starting offset within the buffer.
+		 *
+		 * @pre @em offset must be within the bounds of the buffer.
+		 * @endparblock
+		 * @param[in] vertexStride The distance between consecutive vertices.
+		 **************************************************************************************************************/
+		void setVertexBuffer(const StreamingBuffer& buffer, std::size_t offset, std::size_t vertexStride);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::setIndexBuffer().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] buffer The new active index buffer.
+		 **************************************************************************************************************/
+		void setIndexBuffer(const IndexBuffer& buffer);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::setIndexBuffer() with a streaming buffer.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] buffer The new active index buffer.
+		 **************************************************************************************************************/
+		void setIndexBuffer(const StreamingBuffer& buffer);
+
+		/**************************************************************************************************************
+		 * Records a call to TextureUnit::setTexture().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] unit The texture unit to bind the texture to.
+		 * @param[in] texture Any type of texture object.
+		 **************************************************************************************************************/
+		void setTexture(TextureUnit& unit, const Texture& texture);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::setViewport().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] viewport The viewport rectangle.
+		 **************************************************************************************************************/
+		void setViewport(const RectI2& viewport);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::useScissorTest().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] use Whether the scissor test should be performed or not.
+		 **************************************************************************************************************/
+		void useScissorTest(bool use);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::setScissorBox().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] rect The rectangle outside which to discard fragments.
+		 **************************************************************************************************************/
+		void setScissorBox(const RectI2& rect);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::setClearColor().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] color The new clear color.
+		 **************************************************************************************************************/
+		void setClearColor(RGBAF color);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::clear().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] components The drawing components to clear (by default ALL).
+		 **************************************************************************************************************/
+		void clear(Clear components);
+
+		/**************************************************************************************************************
+		 * Records an upload to a region of a vertex buffer.
+		 *
+		 * The data is copied into the command buffer.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] buffer The buffer to upload to.
+		 * @param[in] offset The starting offset within the buffer in bytes.
+		 * @param[in] data
+		 * @parblock
+		 * The new data of the region.
+		 *
+		 * @pre `offset + data.size() <= buffer.capacity()` must hold true when the command is executed.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void setRegion(VertexBuffer& buffer, std::size_t offset, std::span<const std::byte> data);
+
+		/**************************************************************************************************************
+		 * Records an upload to a region of an index buffer.
+		 *
+		 * The data is copied into the command buffer.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] buffer The buffer to upload to.
+		 * @param[in] offset The starting offset within the buffer in indices.
+		 * @param[in] data
+		 * @parblock
+		 * The new indices of the region.
+		 *
+		 * @pre `offset + data.size() <= buffer.capacity()` must hold true when the command is executed.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void setRegion(IndexBuffer& buffer, std::size_t offset, std::span<const std::uint16_t> data);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::draw().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] type The type of primitive to draw.
+		 * @param[in] offset The offset within the vertex buffer.
+		 * @param[in] vertices The number of vertices to draw.
+		 **************************************************************************************************************/
+		void draw(Primitive type, std::size_t offset, std::size_t vertices);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::drawInstances().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] type The type of primitive to draw.
+		 * @param[in] offset The offset within the vertex buffer.
+		 * @param[in] vertices The number of vertices to draw.
+		 * @param[in] instances The number of instances to draw.
+		 **************************************************************************************************************/
+		void drawInstances(Primitive type, std::size_t offset, std::size_t vertices, int instances);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::drawIndexed().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] type The type of primitive to draw.
+		 * @param[in] offset The offset within the index buffer.
+		 * @param[in] indices The number of indices to draw.
+		 **************************************************************************************************************/
+		void drawIndexed(Primitive type, std::size_t offset, std::size_t indices);
+
+		/**************************************************************************************************************
+		 * Records a call to GraphicsContext::drawIndexedInstances().
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] type The type of primitive to draw.
+		 * @param[in] offset The offset within the index buffer.
+		 * @param[in] indices The number of indices to draw.
+		 * @param[in] instances The number of instances to draw.
+		 **************************************************************************************************************/
+		void drawIndexedInstances(Primitive type, std::size_t offset, std::size_t indices, int instances);
+
+		/**************************************************************************************************************
+		 * Executes the recorded commands in order.
+		 *
+		 * The commands are kept, so a buffer can be executed multiple times.
+		 *
+		 * @pre This function must be called on the thread that owns the graphics context.
+		 *
+		 * @param[in] context The graphics context to execute the commands on.
+		 **************************************************************************************************************/
+		void execute(GraphicsContext& context) const noexcept;
+
+	  private:
+		std::vector<std::byte> _stream;   // The encoded commands.
+		std::size_t            _commands; // The number of commands in the stream.
+
+		// Appends a command to the stream and returns a pointer to the storage of its payload.
+		std::byte* append(std::uint8_t type, std::size_t payloadSize);
+	};
+
+	/******************************************************************************************************************
+	 * Thread-safe pool of reusable command buffers.
+	 *
+	 * Each recording thread acquires its own buffer from the pool, and the buffers are released back after they're
+	 * executed so that their storage is reused by the next frame.
+	 *
+	 * CommandBufferPool is non-copyable and non-movable.
+	 ******************************************************************************************************************/
+	class CommandBufferPool {
+	  public:
+		/**************************************************************************************************************
+		 * Creates an empty pool.
+		 **************************************************************************************************************/
+		CommandBufferPool() noexcept = default;
+
+		/**************************************************************************************************************
+		 * Takes an empty command buffer from the pool, or creates one if the pool is empty.
+		 *
+		 * @return An empty command buffer.
+		 **************************************************************************************************************/
+		CommandBuffer acquire() noexcept;
+
+		/**************************************************************************************************************
+		 * Clears a command buffer and returns it to the pool.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] buffer The command buffer to return to the pool.
+		 **************************************************************************************************************/
+		void release(CommandBuffer&& buffer);
+
+	  private:
+		std::mutex                 _mutex;   // Protects the buffer list.
+		std::vector<CommandBuffer> _buffers; // The idle command buffers.
+	};
+
+	/// @}
+} // namespace tr
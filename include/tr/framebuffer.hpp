@@ -67,6 +67,7 @@ namespace tr {
 		void bindWrite() const noexcept;
 
 		friend class GraphicsContext;
+		friend class FramebufferReadback;
 	};
 
 	/******************************************************************************************************************
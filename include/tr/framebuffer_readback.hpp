@@ -0,0 +1,338 @@
+#pragma once
+#include "bitmap.hpp"
+#include "framebuffer.hpp"
+#include "graphics_buffer.hpp"
+#include <condition_variable>
+#include <deque>
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup framebuffer_readback Framebuffer Readback
+	 *  Asynchronous framebuffer readback through pixel pack buffers.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Asynchronous framebuffer reader.
+	 *
+	 * Unlike BasicFramebuffer::readRegion(), which waits for the GPU to finish rendering before copying the pixels,
+	 * read() only queues a copy into one of a ring of slots in a persistently mapped pixel pack buffer and places a
+	 * fence after it. The returned ID can then be polled with poll() a few frames later, once the GPU has passed the
+	 * fence, at which point the pixels are copied into a bitmap without any stall.
+	 *
+	 * FramebufferReadback is non-copyable and movable.
+	 ******************************************************************************************************************/
+	class FramebufferReadback {
+	  public:
+		/**************************************************************************************************************
+		 * The default number of readback slots.
+		 **************************************************************************************************************/
+		static constexpr std::size_t DEFAULT_SLOTS{3};
+
+		/**************************************************************************************************************
+		 * Allocates a framebuffer reader.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception GraphicsBufferBadAlloc If allocating the pixel pack buffer fails.
+		 * @exception GraphicsBufferMapBadAlloc If mapping the pixel pack buffer fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] maxSize
+		 * @parblock
+		 * The maximum size of a read region.
+		 *
+		 * @pre Both components of @em maxSize must be greater than 0.
+		 * @endparblock
+		 * @param[in] format The format of the read bitmaps.
+		 * @param[in] slots
+		 * @parblock
+		 * The maximum number of readbacks that can be in flight at once.
+		 *
+		 * @pre @em slots must be greater than 0.
+		 * @endparblock
+		 **************************************************************************************************************/
+		FramebufferReadback(glm::ivec2 maxSize, BitmapFormat format, std::size_t slots = DEFAULT_SLOTS);
+
+		/**************************************************************************************************************
+		 * Gets the maximum size of a read region.
+		 *
+		 * @return The maximum size of a read region in pixels.
+		 **************************************************************************************************************/
+		glm::ivec2 maxSize() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the format of the read bitmaps.
+		 *
+		 * @return The format of the read bitmaps.
+		 **************************************************************************************************************/
+		BitmapFormat format() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of readbacks in flight.
+		 *
+		 * @return The number of readbacks that were started but not yet collected or cancelled.
+		 **************************************************************************************************************/
+		std::size_t inFlight() const noexcept;
+
+		/**************************************************************************************************************
+		 * Starts reading a region of a framebuffer.
+		 *
+		 * The image is copied from the color attachments bound to the framebuffer.
+		 *
+		 * @param[in] framebuffer The framebuffer to read from.
+		 * @param[in] rect
+		 * @parblock
+		 * The rect of the framebuffer to copy.
+		 *
+		 * @pre The size of @em rect must not exceed maxSize().
+		 * @endparblock
+		 *
+		 * @return The ID of the readback, or std::nullopt if all slots are in flight.
+		 **************************************************************************************************************/
+		std::optional<std::uint64_t> read(const BasicFramebuffer& framebuffer, const RectI2& rect) noexcept;
+
+		/**************************************************************************************************************
+		 * Gets whether a readback has completed on the GPU.
+		 *
+		 * @param[in] id
+		 * @parblock
+		 * The ID of the readback.
+		 *
+		 * @pre @em id must be an ID of a readback in flight.
+		 * @endparblock
+		 *
+		 * @return True if the pixels can be collected without waiting.
+		 **************************************************************************************************************/
+		bool ready(std::uint64_t id) const noexcept;
+
+		/**************************************************************************************************************
+		 * Collects a readback if it has completed.
+		 *
+		 * If a bitmap is returned, the readback's slot is freed and the ID becomes invalid.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception BitmapBadAlloc If allocating the bitmap fails.
+		 *
+		 * @param[in] id
+		 * @parblock
+		 * The ID of the readback.
+		 *
+		 * @pre @em id must be an ID of a readback in flight.
+		 * @endparblock
+		 *
+		 * @return A bitmap containing the pixel data, or std::nullopt if the readback hasn't completed yet.
+		 **************************************************************************************************************/
+		std::optional<Bitmap> poll(std::uint64_t id);
+
+		/**************************************************************************************************************
+		 * Collects a readback, waiting for it to complete if needed.
+		 *
+		 * The readback's slot is freed and the ID becomes invalid.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception BitmapBadAlloc If allocating the bitmap fails.
+		 *
+		 * @param[in] id
+		 * @parblock
+		 * The ID of the readback.
+		 *
+		 * @pre @em id must be an ID of a readback in flight.
+		 * @endparblock
+		 *
+		 * @return A bitmap containing the pixel data.
+		 **************************************************************************************************************/
+		Bitmap wait(std::uint64_t id);
+
+		/**************************************************************************************************************
+		 * Cancels a readback, freeing its slot.
+		 *
+		 * @param[in] id
+		 * @parblock
+		 * The ID of the readback.
+		 *
+		 * @pre @em id must be an ID of a readback in flight.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void cancel(std::uint64_t id) noexcept;
+
+		/**************************************************************************************************************
+		 * Sets the debug label of the pixel pack buffer.
+		 *
+		 * @param[in] label The new label of the buffer.
+		 **************************************************************************************************************/
+		void setLabel(std::string_view label) noexcept;
+
+	  private:
+		struct FenceDeleter {
+			void operator()(void* sync) const noexcept;
+		};
+
+		// A readback slot.
+		struct Slot {
+			std::unique_ptr<void, FenceDeleter> fence; // The fence after the copy, or nullptr if the slot is free.
+			std::uint64_t                       id;    // The ID of the readback using the slot.
+			glm::ivec2                          size;  // The size of the read region.
+		};
+
+		GraphicsBuffer    _buffer;   // The pixel pack buffer.
+		GraphicsBufferMap _map;      // The persistent map of the entire buffer.
+		std::vector<Slot> _slots;    // The readback slots.
+		glm::ivec2        _maxSize;  // The maximum size of a read region.
+		BitmapFormat      _format;   // The format of the read bitmaps.
+		std::size_t       _slotSize; // The size of a slot in bytes.
+		std::uint64_t     _nextId;   // The ID of the next readback.
+
+		// Finds the slot of a readback in flight.
+		std::size_t findSlot(std::uint64_t id) const noexcept;
+		// Copies the pixels of a completed slot into a bitmap and frees the slot.
+		Bitmap collect(std::size_t slot);
+	};
+
+	/******************************************************************************************************************
+	 * Continuous framebuffer capture that hands frames to a background encoder thread.
+	 *
+	 * capture() starts an asynchronous readback every frame, and update() collects completed readbacks in capture
+	 * order and queues them for the encoder, which is called on a dedicated thread. If every readback slot is in
+	 * flight or the encoder falls too far behind, frames are dropped instead of stalling the render thread.
+	 *
+	 * @note capture() and update() must be called on the thread owning the graphics context.
+	 ******************************************************************************************************************/
+	class FramebufferStream {
+	  public:
+		/**************************************************************************************************************
+		 * Shorthand for the encoder function type.
+		 **************************************************************************************************************/
+		using Encoder = std::function<void(Bitmap)>;
+
+		/**************************************************************************************************************
+		 * The default maximum number of frames waiting for the encoder.
+		 **************************************************************************************************************/
+		static constexpr std::size_t DEFAULT_MAX_QUEUED{8};
+
+		/**************************************************************************************************************
+		 * Allocates a framebuffer stream and launches its encoder thread.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception GraphicsBufferBadAlloc If allocating the pixel pack buffer fails.
+		 * @exception GraphicsBufferMapBadAlloc If mapping the pixel pack buffer fails.
+		 * @exception std::system_error If launching the encoder thread fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] maxSize
+		 * @parblock
+		 * The maximum size of a captured region.
+		 *
+		 * @pre Both components of @em maxSize must be greater than 0.
+		 * @endparblock
+		 * @param[in] format The format of the captured bitmaps.
+		 * @param[in] encoder
+		 * @parblock
+		 * The function called on the encoder thread with every captured frame, in order.
+		 *
+		 * @pre @em encoder must not throw.
+		 * @endparblock
+		 * @param[in] slots
+		 * @parblock
+		 * The maximum number of readbacks that can be in flight at once.
+		 *
+		 * @pre @em slots must be greater than 0.
+		 * @endparblock
+		 * @param[in] maxQueued
+		 * @parblock
+		 * The maximum number of frames waiting for the encoder.
+		 *
+		 * @pre @em maxQueued must be greater than 0.
+		 * @endparblock
+		 **************************************************************************************************************/
+		FramebufferStream(glm::ivec2 maxSize, BitmapFormat format, Encoder encoder,
+						  std::size_t slots = FramebufferReadback::DEFAULT_SLOTS,
+						  std::size_t maxQueued = DEFAULT_MAX_QUEUED);
+
+		/**************************************************************************************************************
+		 * Encodes the frames waiting for the encoder, then stops the encoder thread.
+		 *
+		 * Readbacks still in flight are discarded.
+		 **************************************************************************************************************/
+		~FramebufferStream() noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of frames handed to the encoder.
+		 *
+		 * @return The number of frames handed to the encoder.
+		 **************************************************************************************************************/
+		std::size_t captured() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of dropped frames.
+		 *
+		 * @return The number of frames dropped because all slots were in flight or the encoder queue was full.
+		 **************************************************************************************************************/
+		std::size_t dropped() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of frames waiting for the encoder.
+		 *
+		 * @return The number of frames waiting for the encoder.
+		 **************************************************************************************************************/
+		std::size_t queued() const noexcept;
+
+		/**************************************************************************************************************
+		 * Starts capturing a region of a framebuffer.
+		 *
+		 * @param[in] framebuffer The framebuffer to capture.
+		 * @param[in] rect
+		 * @parblock
+		 * The rect of the framebuffer to capture.
+		 *
+		 * @pre The size of @em rect must not exceed the maximum size passed to the constructor.
+		 * @endparblock
+		 *
+		 * @return True if the capture was started, or false if the frame was dropped.
+		 **************************************************************************************************************/
+		bool capture(const BasicFramebuffer& framebuffer, const RectI2& rect) noexcept;
+
+		/**************************************************************************************************************
+		 * Hands completed captures to the encoder thread.
+		 *
+		 * This should be called once per frame.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Basic exception guarantee: frames collected before the exception are queued.
+		 *
+		 * @exception BitmapBadAlloc If allocating a bitmap fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 **************************************************************************************************************/
+		void update();
+
+	  private:
+		FramebufferReadback        _readback;  // The asynchronous reader.
+		std::vector<std::uint64_t> _inFlight;  // The IDs of the readbacks in flight, in capture order.
+		Encoder                    _encoder;   // The encoder function.
+		std::size_t                _maxQueued; // The maximum number of frames waiting for the encoder.
+		std::size_t                _captured;  // The number of frames handed to the encoder.
+		std::size_t                _dropped;   // The number of dropped frames.
+		mutable std::mutex         _mutex;     // Protects the queue and the stopping flag.
+		std::condition_variable    _condition; // Signals queued frames and shutdown to the encoder thread.
+		std::deque<Bitmap>         _queue;     // The frames waiting for the encoder.
+		bool                       _stopping;  // Whether the encoder thread should exit once the queue is empty.
+		std::thread                _thread;    // The encoder thread.
+
+		// Runs the encoder until the stream is stopped.
+		void work() noexcept;
+	};
+
+	/// @}
+} // namespace tr
@@ -0,0 +1,253 @@
+#pragma once
+#include "batch_renderer.hpp"
+#include "texture_atlas.hpp"
+#include "ttfont.hpp"
+#include "utf8.hpp"
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup glyph_cache Glyph Cache
+	 *  GPU glyph cache and text layout.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Error thrown when a glyph doesn't fit in the glyph cache even after evicting every glyph that can be evicted.
+	 ******************************************************************************************************************/
+	struct GlyphCacheOverflow : std::bad_alloc {
+		/**************************************************************************************************************
+		 * Gets an error message.
+		 *
+		 * @return An explanatory error message.
+		 **************************************************************************************************************/
+		constexpr const char* what() const noexcept override;
+	};
+
+	/******************************************************************************************************************
+	 * Textured quad of a single laid out glyph.
+	 ******************************************************************************************************************/
+	struct GlyphQuad {
+		/**************************************************************************************************************
+		 * The rectangle the glyph is drawn to.
+		 **************************************************************************************************************/
+		RectF2 rect;
+
+		/**************************************************************************************************************
+		 * The normalized texture rectangle of the glyph within the glyph cache atlas.
+		 **************************************************************************************************************/
+		RectF2 uv;
+	};
+
+	/******************************************************************************************************************
+	 * Cache of rasterized glyphs packed into a texture atlas.
+	 *
+	 * Each glyph is rasterized once per combination of font, codepoint, size, DPI, style, outline and hinting, in
+	 * white so that it can be tinted to any color when drawn. Laying out text afterwards only costs a cache lookup
+	 * per glyph, so dynamic text can be regenerated every frame at the cost of its vertices alone.
+	 *
+	 * When the atlas runs out of space, the least recently used glyphs that weren't used during the current frame
+	 * (see nextFrame()) are evicted.
+	 *
+	 * Glyphs are looked up by the address of their font, so glyphs of a font must be evicted with erase() before it
+	 * is destroyed if the cache outlives it.
+	 *
+	 * GlyphCache is non-copyable and movable.
+	 ******************************************************************************************************************/
+	class GlyphCache {
+	  public:
+		/**************************************************************************************************************
+		 * The default size of the glyph atlas.
+		 **************************************************************************************************************/
+		static constexpr glm::ivec2 DEFAULT_ATLAS_SIZE{1024, 1024};
+
+		/**************************************************************************************************************
+		 * Creates an empty glyph cache.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception TextureBadAlloc If allocating the atlas texture fails.
+		 * @exception BitmapBadAlloc If allocating the CPU-side copy of the atlas fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] atlasSize The size of the glyph atlas in texels.
+		 **************************************************************************************************************/
+		explicit GlyphCache(glm::ivec2 atlasSize = DEFAULT_ATLAS_SIZE);
+
+		/**************************************************************************************************************
+		 * Gets the glyph atlas.
+		 *
+		 * @return A reference to the glyph atlas.
+		 **************************************************************************************************************/
+		const TextureAtlas& atlas() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of cached glyphs.
+		 *
+		 * @return The number of cached glyphs.
+		 **************************************************************************************************************/
+		std::size_t size() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of glyphs rasterized since the cache was created.
+		 *
+		 * @return The number of cache misses.
+		 **************************************************************************************************************/
+		std::size_t misses() const noexcept;
+
+		/**************************************************************************************************************
+		 * Lays out a string of text, rasterizing any glyphs that aren't in the cache yet.
+		 *
+		 * Kerning is applied if it is enabled in the font. Codepoints not contained in the font are skipped.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Basic exception guarantee.
+		 *
+		 * @exception TTFontError If rasterizing a glyph fails.
+		 * @exception GlyphCacheOverflow If a glyph doesn't fit in the atlas.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] font The font to lay the text out with.
+		 * @param[in] text The UTF-8 text to lay out (\\n supported).
+		 * @param[in] tl The top-left corner of the first line of text.
+		 * @param[out] out An output iterator the quads of visible glyphs are written to.
+		 *
+		 * @return The output iterator past the last written quad.
+		 **************************************************************************************************************/
+		template <std::output_iterator<GlyphQuad> It>
+		It layout(const TTFont& font, std::string_view text, glm::vec2 tl, It out);
+
+		/**************************************************************************************************************
+		 * Lays out a string of text and adds its glyphs to a batch renderer as sprites.
+		 *
+		 * upload() must be called before the batch is drawn.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Basic exception guarantee.
+		 *
+		 * @exception TTFontError If rasterizing a glyph fails.
+		 * @exception GlyphCacheOverflow If a glyph doesn't fit in the atlas.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[out] renderer The renderer to add the glyphs to.
+		 * @param[in] state The render state of the text. Its texture is replaced with the atlas texture.
+		 * @param[in] font The font to lay the text out with.
+		 * @param[in] text The UTF-8 text to lay out (\\n supported).
+		 * @param[in] tl The top-left corner of the first line of text.
+		 * @param[in] color The color of the text.
+		 **************************************************************************************************************/
+		void addText(BatchRenderer& renderer, BatchState state, const TTFont& font, std::string_view text,
+					 glm::vec2 tl, RGBA8 color);
+
+		/**************************************************************************************************************
+		 * Uploads glyphs rasterized since the last upload to the atlas texture.
+		 **************************************************************************************************************/
+		void upload() noexcept;
+
+		/**************************************************************************************************************
+		 * Marks the start of a new frame.
+		 *
+		 * Glyphs used during the current frame are never evicted, as quads referencing them may not have been drawn
+		 * yet.
+		 **************************************************************************************************************/
+		void nextFrame() noexcept;
+
+		/**************************************************************************************************************
+		 * Evicts every glyph of a font.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Basic exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] font The font whose glyphs to evict.
+		 **************************************************************************************************************/
+		void erase(const TTFont& font);
+
+		/**************************************************************************************************************
+		 * Evicts every glyph.
+		 **************************************************************************************************************/
+		void clear() noexcept;
+
+	  private:
+		// The configuration a glyph was rasterized with.
+		struct Key {
+			const TTFont* font;    // The font of the glyph.
+			std::uint32_t cp;      // The codepoint of the glyph.
+			int           size;    // The point size of the font.
+			glm::uvec2    dpi;     // The DPI of the font.
+			TTFont::Style style;   // The style of the font.
+			int           outline; // The outline thickness of the font.
+			TTFont::Hint  hinting; // The hinting of the font.
+
+			friend bool operator==(const Key& l, const Key& r) noexcept = default;
+		};
+
+		struct KeyHash {
+			std::size_t operator()(const Key& key) const noexcept;
+		};
+
+		// A cached glyph.
+		struct Entry {
+			RectI2        rect;     // The region of the atlas holding the glyph, or an empty rect for blank glyphs.
+			glm::ivec2    offset;   // The offset of the glyph bitmap from the pen position at the top of the line.
+			int           advance;  // The advance of the glyph.
+			std::uint64_t lastUsed; // The frame the glyph was last used in.
+		};
+
+		TextureAtlas                            _atlas;  // The glyph atlas.
+		std::unordered_map<Key, Entry, KeyHash> _glyphs; // The cached glyphs.
+		std::vector<GlyphQuad>                  _quads;  // Scratch storage for laid out quads.
+		std::uint64_t                           _frame;  // The current frame.
+		std::size_t                             _misses; // The number of glyphs rasterized so far.
+
+		// Gets a glyph, rasterizing it if it isn't cached.
+		const Entry& glyph(const TTFont& font, std::uint32_t cp);
+		// Inserts a glyph bitmap into the atlas, evicting glyphs not used during the current frame if needed.
+		RectI2 insert(const SubBitmap& bitmap);
+	};
+
+	/// @}
+} // namespace tr
+
+/// @cond IMPLEMENTATION
+
+constexpr const char* tr::GlyphCacheOverflow::what() const noexcept
+{
+	return "glyph cache overflow";
+}
+
+template <std::output_iterator<tr::GlyphQuad> It>
+It tr::GlyphCache::layout(const TTFont& font, std::string_view text, glm::vec2 tl, It out)
+{
+	const bool    kerning{font.kerning()};
+	glm::vec2     pen{tl};
+	std::uint32_t prev{0};
+	for (std::uint32_t cp : utf8Range(text)) {
+		if (cp == '\n') {
+			pen  = {tl.x, pen.y + font.lineSkip()};
+			prev = 0;
+			continue;
+		}
+		else if (!font.contains(cp)) {
+			continue;
+		}
+
+		if (kerning && prev != 0) {
+			pen.x += font.kerning(prev, cp);
+		}
+		const Entry& glyph{this->glyph(font, cp)};
+		if (glyph.rect.size != glm::ivec2{0, 0}) {
+			*out++ = GlyphQuad{{pen + glm::vec2{glyph.offset}, glyph.rect.size}, _atlas.uv(glyph.rect)};
+		}
+		pen.x += glyph.advance;
+		prev = cp;
+	}
+	return out;
+}
+
+/// @endcond
@@ -0,0 +1,162 @@
+#pragma once
+#include "benchmark.hpp"
+#include "handle.hpp"
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup gpu_benchmark GPU Benchmark
+	 *  GPU timing class.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * GPU benchmarking class.
+	 *
+	 * Measures the GPU time taken by the commands issued between calls to start() and stop() using timestamp queries.
+	 * Queries are kept in a ring and their results are read back without blocking once the GPU has finished with
+	 * them (usually a few frames later), after which they're available through the same interface as Benchmark.
+	 *
+	 * If a measurement is started while all queries in the ring are still in flight, it is skipped and counted in
+	 * skipped().
+	 *
+	 * Unlike GL_TIME_ELAPSED queries, timestamp pairs may be nested, so several GPU benchmarks can be active at once.
+	 *
+	 * GPUBenchmark is non-copyable and movable.
+	 ******************************************************************************************************************/
+	class GPUBenchmark {
+	  public:
+		/**************************************************************************************************************
+		 * The default number of measurements that may be in flight at once.
+		 **************************************************************************************************************/
+		static constexpr std::size_t DEFAULT_IN_FLIGHT{4};
+
+		/**************************************************************************************************************
+		 * Constructs an empty GPU benchmark.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] inFlight
+		 * @parblock
+		 * The number of measurements that may be in flight at once.
+		 *
+		 * @pre @em inFlight must be greater than 0.
+		 * @endparblock
+		 * @param[in] window The length of time measurements are kept for.
+		 * @param[in] capacity The maximum number of measurements that can be kept at once.
+		 **************************************************************************************************************/
+		explicit GPUBenchmark(std::size_t inFlight = DEFAULT_IN_FLIGHT, Duration window = Benchmark::DEFAULT_WINDOW,
+							  std::size_t capacity = Benchmark::DEFAULT_CAPACITY);
+
+		/**************************************************************************************************************
+		 * Starts a new measurement.
+		 *
+		 * Finished measurements are polled before starting.
+		 *
+		 * @pre This function cannot be called if a previous measurement was started but not ended.
+		 **************************************************************************************************************/
+		void start() noexcept;
+
+		/**************************************************************************************************************
+		 * Stops a measurement.
+		 *
+		 * @pre This function cannot be called if a measurement was not started.
+		 **************************************************************************************************************/
+		void stop() noexcept;
+
+		/**************************************************************************************************************
+		 * Reads back the results of any finished measurements without blocking.
+		 *
+		 * This is done automatically by start(), but may be called manually to get results sooner.
+		 **************************************************************************************************************/
+		void poll() noexcept;
+
+		/**************************************************************************************************************
+		 * Clears all previous measurements.
+		 *
+		 * @remark Measurements that are in flight are discarded.
+		 **************************************************************************************************************/
+		void clear() noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of measurements skipped because all queries were in flight.
+		 *
+		 * @return The number of skipped measurements.
+		 **************************************************************************************************************/
+		std::size_t skipped() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the duration of the latest measurement.
+		 *
+		 * @return The duration of the latest measurement, or 0s if no measurements are available.
+		 **************************************************************************************************************/
+		Duration latest() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the duration of the shortest available measurement.
+		 *
+		 * @return The duration of the shortest available measurement, or 0s if no measurements are available.
+		 **************************************************************************************************************/
+		Duration min() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the duration of the longest available measurement.
+		 *
+		 * @return The duration of the longest available measurement, or 0s if no measurements are available.
+		 **************************************************************************************************************/
+		Duration max() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the average duration of the available measurements.
+		 *
+		 * @return The average duration of the available measurements, or 0s if no measurements are available.
+		 **************************************************************************************************************/
+		Duration average() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets an approximate percentile of the durations of the available measurements.
+		 *
+		 * @param[in] fraction
+		 * @parblock
+		 * The percentile as a fraction (0.5 for the median, 0.99 for p99, etc.).
+		 *
+		 * @pre @em fraction must be in the range [0, 1].
+		 * @endparblock
+		 *
+		 * @return The approximate percentile duration, or 0s if no measurements are available.
+		 **************************************************************************************************************/
+		Duration percentile(double fraction) const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the underlying CPU-side benchmark the results are stored in.
+		 *
+		 * @return A reference to the result benchmark.
+		 **************************************************************************************************************/
+		const Benchmark& results() const noexcept;
+
+	  private:
+		struct Deleter {
+			void operator()(unsigned int id) const noexcept;
+		};
+
+		// A pair of timestamp queries bracketing a measurement.
+		struct Slot {
+			Handle<unsigned int, 0, Deleter> start;   // The starting timestamp query.
+			Handle<unsigned int, 0, Deleter> end;     // The ending timestamp query.
+			bool                             pending; // Whether the queries are in flight.
+		};
+
+		std::vector<Slot> _slots;    // The query ring.
+		std::size_t       _oldest;   // The index of the oldest in-flight slot.
+		std::size_t       _next;     // The index of the next slot to use.
+		bool              _active;   // Whether a measurement was started (and not skipped).
+		bool              _skipping; // Whether the current measurement is being skipped.
+		std::size_t       _skipped;  // The number of skipped measurements.
+		Benchmark         _results;  // The finished measurements.
+	};
+
+	/// @}
+} // namespace tr
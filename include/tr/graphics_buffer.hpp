@@ -172,6 +172,11 @@ namespace tr {
 		friend class GraphicsContext;
 		friend class VertexBuffer;
 		friend class IndexBuffer;
+		friend class IndirectBuffer;
+		friend class StreamingBuffer;
+		friend class UniformBuffer;
+		friend class FramebufferReadback;
+		friend class TextureUploadQueue;
 	};
 
 	/******************************************************************************************************************
@@ -14,6 +14,9 @@ namespace tr {
 	class VertexFormat;
 	class VertexBuffer;
 	class IndexBuffer;
+	class IndirectBuffer;
+	class StreamingBuffer;
+	struct PipelineState;
 	enum class Compare;
 
 	/** @ingroup system
@@ -349,9 +352,29 @@ namespace tr {
 		TRI_FAN
 	};
 
+	/******************************************************************************************************************
+	 * Graphics state cache statistics.
+	 ******************************************************************************************************************/
+	struct StateCacheStats {
+		/**************************************************************************************************************
+		 * The number of state changes that were passed to the driver.
+		 **************************************************************************************************************/
+		std::uint64_t issued;
+
+		/**************************************************************************************************************
+		 * The number of state changes that were skipped because they wouldn't have changed anything.
+		 **************************************************************************************************************/
+		std::uint64_t elided;
+	};
+
 	/******************************************************************************************************************
 	 * Graphics context.
 	 *
+	 * The context keeps a shadow copy of the state set through libtr (bound framebuffers, shader pipeline, vertex
+	 * format, vertex and index buffers, textures bound to texture units, and the viewport, scissor, stencil, depth and
+	 * blending state) and skips state changes that wouldn't change anything. If the OpenGL state is changed directly,
+	 * invalidateStateCache() must be called afterwards.
+	 *
 	 * This class cannot be directly instantiated.
 	 ******************************************************************************************************************/
 	class GraphicsContext {
@@ -377,6 +400,34 @@ namespace tr {
 		 **************************************************************************************************************/
 		const char* versionInfo() const noexcept;
 
+		/**************************************************************************************************************
+		 * Sets whether redundant state changes are skipped.
+		 *
+		 * The state cache is used by default. The cached state is kept up to date even while it isn't used.
+		 *
+		 * @param[in] use Whether redundant state changes should be skipped or not.
+		 **************************************************************************************************************/
+		void useStateCache(bool use) noexcept;
+
+		/**************************************************************************************************************
+		 * Marks all cached state as unknown, so that the next change to any state is passed to the driver.
+		 *
+		 * This must be called after changing the OpenGL state without going through libtr.
+		 **************************************************************************************************************/
+		void invalidateStateCache() noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of issued and elided state changes since the context was created or the counters were reset.
+		 *
+		 * @return The state cache statistics.
+		 **************************************************************************************************************/
+		StateCacheStats stateCacheStats() const noexcept;
+
+		/**************************************************************************************************************
+		 * Resets the issued and elided state change counters.
+		 **************************************************************************************************************/
+		void resetStateCacheStats() noexcept;
+
 		/**************************************************************************************************************
 		 * Sets the active viewport.
 		 *
@@ -434,6 +485,46 @@ namespace tr {
 		 **************************************************************************************************************/
 		void setIndexBuffer(const IndexBuffer& buffer) noexcept;
 
+		/**************************************************************************************************************
+		 * Sets a streaming buffer as the active vertex buffer.
+		 *
+		 * @param[in] buffer The new active vertex buffer.
+		 * @param[in] offset
+		 * @parblock
+		 * The starting offset within the buffer, usually the offset of a range returned by StreamingBuffer::allocate().
+		 *
+		 * @pre @em offset must be within the bounds of the buffer.
+		 * @endparblock
+		 * @param[in] vertexStride The distance between consecutive vertices.
+		 **************************************************************************************************************/
+		void setVertexBuffer(const StreamingBuffer& buffer, std::size_t offset, std::size_t vertexStride) noexcept;
+
+		/**************************************************************************************************************
+		 * Sets a streaming buffer as the active index buffer.
+		 *
+		 * Index ranges allocated from the buffer can be drawn by passing StreamingBufferRange::elementOffset() as the
+		 * offset to drawIndexed().
+		 *
+		 * @param[in] buffer The new active index buffer.
+		 **************************************************************************************************************/
+		void setIndexBuffer(const StreamingBuffer& buffer) noexcept;
+
+		/**************************************************************************************************************
+		 * Sets the active indirect buffer used by drawIndirect() and drawIndexedIndirect().
+		 *
+		 * @param[in] buffer The new active indirect buffer.
+		 **************************************************************************************************************/
+		void setIndirectBuffer(const IndirectBuffer& buffer) noexcept;
+
+		/**************************************************************************************************************
+		 * Sets the shader pipeline, vertex format, and blending, depth, stencil, culling and color mask state at once.
+		 *
+		 * Only the state that differs from the current state is changed. The state of disabled tests is left as-is.
+		 *
+		 * @param[in] state The new pipeline state.
+		 **************************************************************************************************************/
+		void setPipelineState(const PipelineState& state) noexcept;
+
 		/**************************************************************************************************************
 		 * Sets whether face culling is performed.
 		 *
@@ -599,6 +690,34 @@ namespace tr {
 		 **************************************************************************************************************/
 		void drawIndexedInstances(Primitive type, std::size_t offset, std::size_t indices, int instances) noexcept;
 
+		/**************************************************************************************************************
+		 * Draws multiple meshes from a vertex buffer with one call, using commands from the active indirect buffer.
+		 *
+		 * @param[in] type The type of primitive to draw.
+		 * @param[in] offset The offset of the first command within the indirect buffer in commands.
+		 * @param[in] draws
+		 * @parblock
+		 * The number of commands to execute.
+		 *
+		 * @pre The active indirect buffer must contain DrawIndirectCommand commands in the range.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void drawIndirect(Primitive type, std::size_t offset, std::size_t draws) noexcept;
+
+		/**************************************************************************************************************
+		 * Draws multiple indexed meshes with one call, using commands from the active indirect buffer.
+		 *
+		 * @param[in] type The type of primitive to draw.
+		 * @param[in] offset The offset of the first command within the indirect buffer in commands.
+		 * @param[in] draws
+		 * @parblock
+		 * The number of commands to execute.
+		 *
+		 * @pre The active indirect buffer must contain DrawIndexedIndirectCommand commands in the range.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void drawIndexedIndirect(Primitive type, std::size_t offset, std::size_t draws) noexcept;
+
 		/**************************************************************************************************************
 		 * Swaps the display's front and back buffers.
 		 **************************************************************************************************************/
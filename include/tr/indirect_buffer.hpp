@@ -0,0 +1,278 @@
+#pragma once
+#include "graphics_buffer.hpp"
+
+namespace tr {
+	enum class Primitive;
+
+	/** @ingroup graphics
+	 *  @defgroup indirect_buffer Indirect Buffer
+	 *  Indirect draw command buffer and builder.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Indirect non-indexed draw command, laid out as expected by OpenGL.
+	 ******************************************************************************************************************/
+	struct DrawIndirectCommand {
+		/**************************************************************************************************************
+		 * The number of vertices to draw.
+		 **************************************************************************************************************/
+		std::uint32_t vertices;
+
+		/**************************************************************************************************************
+		 * The number of instances to draw.
+		 **************************************************************************************************************/
+		std::uint32_t instances;
+
+		/**************************************************************************************************************
+		 * The offset of the first vertex within the vertex buffer.
+		 **************************************************************************************************************/
+		std::uint32_t firstVertex;
+
+		/**************************************************************************************************************
+		 * The instance index of the first instance.
+		 **************************************************************************************************************/
+		std::uint32_t baseInstance;
+	};
+
+	/******************************************************************************************************************
+	 * Indirect indexed draw command, laid out as expected by OpenGL.
+	 ******************************************************************************************************************/
+	struct DrawIndexedIndirectCommand {
+		/**************************************************************************************************************
+		 * The number of indices to draw.
+		 **************************************************************************************************************/
+		std::uint32_t indices;
+
+		/**************************************************************************************************************
+		 * The number of instances to draw.
+		 **************************************************************************************************************/
+		std::uint32_t instances;
+
+		/**************************************************************************************************************
+		 * The offset of the first index within the index buffer.
+		 **************************************************************************************************************/
+		std::uint32_t firstIndex;
+
+		/**************************************************************************************************************
+		 * The value added to every index before fetching the vertex.
+		 **************************************************************************************************************/
+		std::int32_t baseVertex;
+
+		/**************************************************************************************************************
+		 * The instance index of the first instance.
+		 **************************************************************************************************************/
+		std::uint32_t baseInstance;
+	};
+
+	/******************************************************************************************************************
+	 * CPU-side builder of indirect draw command arrays.
+	 *
+	 * By default, every added draw becomes its own command. Merging can be enabled for lists of independent
+	 * primitives: draws added back-to-back that continue the previous draw's range with the same base vertex and
+	 * instancing parameters are then merged into a single command, as long as both consist of whole primitives.
+	 *
+	 * @note Merged draws share a single command and therefore a single gl_DrawID, so merging must not be enabled if
+	 *       shaders use gl_DrawID to index per-draw data.
+	 ******************************************************************************************************************/
+	class IndirectDrawBuilder {
+	  public:
+		/**************************************************************************************************************
+		 * Constructs an empty builder that doesn't merge draws.
+		 **************************************************************************************************************/
+		IndirectDrawBuilder() noexcept;
+
+		/**************************************************************************************************************
+		 * Constructs an empty builder that merges contiguous draws.
+		 *
+		 * @param[in] primitive
+		 * @parblock
+		 * The primitive the commands will be drawn with.
+		 *
+		 * @pre @em primitive must be Primitive::POINTS, Primitive::LINES or Primitive::TRIS, as strips, loops and fans
+		 *      change shape when merged.
+		 * @endparblock
+		 **************************************************************************************************************/
+		explicit IndirectDrawBuilder(Primitive primitive) noexcept;
+
+		/**************************************************************************************************************
+		 * Adds a non-indexed draw.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] offset The offset within the vertex buffer.
+		 * @param[in] vertices The number of vertices to draw.
+		 * @param[in] instances The number of instances to draw.
+		 * @param[in] baseInstance The instance index of the first instance.
+		 **************************************************************************************************************/
+		void addDraw(std::size_t offset, std::size_t vertices, int instances = 1, std::uint32_t baseInstance = 0);
+
+		/**************************************************************************************************************
+		 * Adds an indexed draw.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] offset The offset within the index buffer.
+		 * @param[in] indices The number of indices to draw.
+		 * @param[in] baseVertex The value added to every index before fetching the vertex.
+		 * @param[in] instances The number of instances to draw.
+		 * @param[in] baseInstance The instance index of the first instance.
+		 **************************************************************************************************************/
+		void addIndexedDraw(std::size_t offset, std::size_t indices, std::int32_t baseVertex = 0, int instances = 1,
+							std::uint32_t baseInstance = 0);
+
+		/**************************************************************************************************************
+		 * Gets the non-indexed draw commands.
+		 *
+		 * @return A span of draw commands.
+		 **************************************************************************************************************/
+		std::span<const DrawIndirectCommand> draws() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the indexed draw commands.
+		 *
+		 * @return A span of indexed draw commands.
+		 **************************************************************************************************************/
+		std::span<const DrawIndexedIndirectCommand> indexedDraws() const noexcept;
+
+		/**************************************************************************************************************
+		 * Removes all commands from the builder, keeping its storage.
+		 **************************************************************************************************************/
+		void clear() noexcept;
+
+	  private:
+		std::vector<DrawIndirectCommand>        _draws;         // The non-indexed draw commands.
+		std::vector<DrawIndexedIndirectCommand> _indexedDraws;  // The indexed draw commands.
+		std::uint32_t                           _primitiveSize; // The vertices per merged primitive, or 0 to not merge.
+	};
+
+	/******************************************************************************************************************
+	 * GPU buffer of indirect draw commands.
+	 ******************************************************************************************************************/
+	class IndirectBuffer {
+	  public:
+		/**************************************************************************************************************
+		 * Constructs an empty indirect buffer.
+		 **************************************************************************************************************/
+		IndirectBuffer() noexcept;
+
+		/**************************************************************************************************************
+		 * Allocates an indirect buffer.
+		 *
+		 * The buffer will be of size 0 and capacity @em capacity after construction.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception GraphicsBufferBadAlloc If allocating the buffer fails.
+		 *
+		 * @param[in] capacity
+		 * @parblock
+		 * The capacity of the buffer in bytes.
+		 *
+		 * @pre @em capacity must be greater than 0.
+		 * @endparblock
+		 **************************************************************************************************************/
+		IndirectBuffer(std::size_t capacity);
+
+		/**************************************************************************************************************
+		 * Gets whether the indirect buffer is empty.
+		 *
+		 * @return True if the buffer has size 0.
+		 **************************************************************************************************************/
+		bool empty() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the size of the indirect buffer contents.
+		 *
+		 * @return The size of the indirect buffer contents in bytes.
+		 **************************************************************************************************************/
+		std::size_t size() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the capacity of the indirect buffer.
+		 *
+		 * @note The buffer can be resized past this capacity, but it will trigger a reallocation.
+		 *
+		 * @return The capacity of the indirect buffer in bytes.
+		 **************************************************************************************************************/
+		std::size_t capacity() const noexcept;
+
+		/**************************************************************************************************************
+		 * Sets the size of the indirect buffer to 0.
+		 *
+		 * This does not affect the capacity of the buffer.
+		 **************************************************************************************************************/
+		void clear() noexcept;
+
+		/**************************************************************************************************************
+		 * Sets the contents of the buffer to non-indexed draw commands.
+		 *
+		 * @note If the commands don't fit in the capacity of the buffer, a reallocation will be done. This voids any
+		 * previous bindings of the buffer to the context, and so it must be rebound.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception GraphicsBufferBadAlloc If a reallocation is triggered and reallocating the buffer fails.
+		 *
+		 * @param[in] commands
+		 * @parblock
+		 * The new commands of the buffer.
+		 *
+		 * @pre @em commands cannot be empty.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void set(std::span<const DrawIndirectCommand> commands);
+
+		/**************************************************************************************************************
+		 * Sets the contents of the buffer to indexed draw commands.
+		 *
+		 * @note If the commands don't fit in the capacity of the buffer, a reallocation will be done. This voids any
+		 * previous bindings of the buffer to the context, and so it must be rebound.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception GraphicsBufferBadAlloc If a reallocation is triggered and reallocating the buffer fails.
+		 *
+		 * @param[in] commands
+		 * @parblock
+		 * The new commands of the buffer.
+		 *
+		 * @pre @em commands cannot be empty.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void set(std::span<const DrawIndexedIndirectCommand> commands);
+
+		/**************************************************************************************************************
+		 * Sets the debug label of the indirect buffer.
+		 *
+		 * @param[in] label The new label of the indirect buffer.
+		 **************************************************************************************************************/
+		void setLabel(std::string label) noexcept;
+
+	  private:
+		std::optional<GraphicsBuffer> _buffer;
+		std::size_t                   _size; // Size of the allocated portion of the buffer.
+		std::string                   _label;
+
+		// Resizes the buffer, reallocating if needed.
+		void resize(std::size_t newSize);
+
+		friend class GraphicsContext;
+	};
+
+	/// @}
+} // namespace tr
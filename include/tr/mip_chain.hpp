@@ -0,0 +1,73 @@
+#pragma once
+#include "bitmap.hpp"
+
+namespace tr {
+	/** @ingroup system
+	 *  @defgroup mip_chain Mip Chains
+	 *  CPU-side mipmap chain generation.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Downsampling filters used when building mip chains.
+	 ******************************************************************************************************************/
+	enum class MipFilter {
+		/**************************************************************************************************************
+		 * 2x2 box filter. Fast, but slightly blurry and prone to aliasing on high-frequency detail.
+		 **************************************************************************************************************/
+		BOX,
+
+		/**************************************************************************************************************
+		 * 6-tap Kaiser-windowed sinc filter. Keeps minified detail sharper at the cost of some ringing.
+		 **************************************************************************************************************/
+		KAISER
+	};
+
+	/******************************************************************************************************************
+	 * Gets the number of levels in a full mip chain.
+	 *
+	 * @param[in] size
+	 * @parblock
+	 * The size of the base level.
+	 *
+	 * @pre Both components of @em size must be greater than 0.
+	 * @endparblock
+	 *
+	 * @return The number of levels, including the base level.
+	 ******************************************************************************************************************/
+	int mipLevelCount(glm::ivec2 size) noexcept;
+
+	/******************************************************************************************************************
+	 * Builds the mip chain of a bitmap on the CPU.
+	 *
+	 * Every level is half the size of the previous one (rounded down, to a minimum of 1), down to a 1x1 level,
+	 * matching the levels allocated by a mipmapped ColorTexture2D. Filtering is done in floating point with
+	 * premultiplied alpha, so transparent texels don't bleed their color into their neighbours, and each level is
+	 * derived from the unquantized previous level. The inner loops are vectorized with SSE2 where available.
+	 *
+	 * This function doesn't touch any global state and can safely be called from worker threads.
+	 *
+	 * @par Exception Safety
+	 *
+	 * Strong exception guarantee.
+	 *
+	 * @exception BitmapBadAlloc If allocating a bitmap fails.
+	 * @exception std::bad_alloc If allocating the intermediate buffers fails.
+	 *
+	 * @param[in] bitmap The base level. Bitmaps of any format are accepted.
+	 * @param[in] filter The downsampling filter.
+	 * @param[in] srgb
+	 * @parblock
+	 * Whether the color channels are sRGB-encoded.
+	 *
+	 * If true, colors are converted to linear space before filtering and back afterwards, which avoids the darkening
+	 * of naive averaging. Alpha is always treated as linear.
+	 * @endparblock
+	 *
+	 * @return The levels below the base level (element @em i holds level @em i + 1), in the RGBA8 pixel format
+	 *         (see BITMAP_PIXEL_FORMAT).
+	 ******************************************************************************************************************/
+	std::vector<Bitmap> buildMipChain(const SubBitmap& bitmap, MipFilter filter = MipFilter::BOX, bool srgb = true);
+
+	/// @}
+} // namespace tr
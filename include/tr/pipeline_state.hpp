@@ -0,0 +1,134 @@
+#pragma once
+#include "graphics_context.hpp"
+#include "texture.hpp"
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup pipeline_state Pipeline State
+	 *  Bundled render state objects.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * The stencil state of one polygon face.
+	 ******************************************************************************************************************/
+	struct StencilState {
+		/**************************************************************************************************************
+		 * The function used for the stencil test.
+		 **************************************************************************************************************/
+		Compare func = Compare::ALWAYS;
+
+		/**************************************************************************************************************
+		 * The value that is compared against in the stencil test.
+		 **************************************************************************************************************/
+		int ref = 0;
+
+		/**************************************************************************************************************
+		 * The mask applied to the reference and stencil values before comparing them.
+		 **************************************************************************************************************/
+		std::uint32_t readMask = 0xFFFFFFFF;
+
+		/**************************************************************************************************************
+		 * The operation used in case of a stencil test fail.
+		 **************************************************************************************************************/
+		StencilOperation sfail = StencilOperation::KEEP;
+
+		/**************************************************************************************************************
+		 * The operation used in case of a depth test fail.
+		 **************************************************************************************************************/
+		StencilOperation dfail = StencilOperation::KEEP;
+
+		/**************************************************************************************************************
+		 * The operation used in case of a depth test success.
+		 **************************************************************************************************************/
+		StencilOperation dpass = StencilOperation::KEEP;
+
+		/**************************************************************************************************************
+		 * A bitmask where 0 means the bit cannot be written and 1 means it can be written.
+		 **************************************************************************************************************/
+		std::uint32_t writeMask = 0xFFFFFFFF;
+
+		friend bool operator==(const StencilState& l, const StencilState& r) noexcept = default;
+	};
+
+	/******************************************************************************************************************
+	 * A bundle of the render state used by a draw: shader pipeline, vertex format, and blending, depth, stencil,
+	 * culling and color mask state.
+	 *
+	 * Pipeline states are plain values applied all at once with GraphicsContext::setPipelineState(). State belonging
+	 * to a disabled test (for example the blending mode while blending is disabled) is ignored.
+	 ******************************************************************************************************************/
+	struct PipelineState {
+		/**************************************************************************************************************
+		 * The shader pipeline, or nullptr to leave the active pipeline as-is.
+		 **************************************************************************************************************/
+		const ShaderPipeline* pipeline = nullptr;
+
+		/**************************************************************************************************************
+		 * The vertex format, or nullptr to leave the active vertex format as-is.
+		 **************************************************************************************************************/
+		const VertexFormat* vertexFormat = nullptr;
+
+		/**************************************************************************************************************
+		 * Whether blending is performed.
+		 **************************************************************************************************************/
+		bool blending = false;
+
+		/**************************************************************************************************************
+		 * The blending mode used if blending is performed.
+		 **************************************************************************************************************/
+		BlendMode blendMode = ALPHA_BLENDING;
+
+		/**************************************************************************************************************
+		 * Whether the depth test is performed.
+		 **************************************************************************************************************/
+		bool depthTest = false;
+
+		/**************************************************************************************************************
+		 * The function used for the depth test if it is performed.
+		 **************************************************************************************************************/
+		Compare depthFunc = Compare::LESS;
+
+		/**************************************************************************************************************
+		 * Whether the stencil test is performed.
+		 **************************************************************************************************************/
+		bool stencilTest = false;
+
+		/**************************************************************************************************************
+		 * The stencil state of front faces if the stencil test is performed.
+		 **************************************************************************************************************/
+		StencilState stencilFront;
+
+		/**************************************************************************************************************
+		 * The stencil state of back faces if the stencil test is performed.
+		 **************************************************************************************************************/
+		StencilState stencilBack;
+
+		/**************************************************************************************************************
+		 * Whether face culling is performed.
+		 **************************************************************************************************************/
+		bool faceCulling = false;
+
+		/**************************************************************************************************************
+		 * Whether writing to the red, green, blue and alpha channels is enabled.
+		 **************************************************************************************************************/
+		std::array<bool, 4> colorMask{true, true, true, true};
+
+		/**************************************************************************************************************
+		 * Computes a compact key for sorting draws by state.
+		 *
+		 * The key is laid out so that sorting by it groups draws by the state that is most expensive to change first:
+		 * shader pipeline, then vertex format, blending, depth, stencil, culling and color mask state. Equal states
+		 * always have equal keys. Different states have different keys as long as fewer than 262144 shader pipelines
+		 * and 1024 vertex formats have been created, barring unlikely collisions of the hashed blending and stencil
+		 * state.
+		 *
+		 * @return A 64-bit sort key.
+		 **************************************************************************************************************/
+		std::uint64_t sortKey() const noexcept;
+
+		friend bool operator==(const PipelineState& l, const PipelineState& r) noexcept = default;
+	};
+
+	/// @}
+} // namespace tr
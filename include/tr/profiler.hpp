@@ -0,0 +1,167 @@
+#pragma once
+#include "chrono.hpp"
+
+namespace tr {
+	/** @ingroup misc
+	 *  @defgroup profiler Profiler
+	 *  Hierarchical scoped CPU profiler.
+	 *
+	 *  Zones are recorded with TR_PROFILE_SCOPE(), which compiles to nothing unless TR_ENABLE_PROFILER is defined
+	 *  (set through the CMake option of the same name).
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * RAII profiler zone.
+	 *
+	 * The zone starts when constructed and ends when destroyed. Completed zones are pushed into a lock-free
+	 * thread-local buffer that is drained by collectProfileFrame(). If the buffer of a thread fills up before being
+	 * drained, further zones are dropped and counted in ProfileFrame::droppedZones.
+	 *
+	 * Zones are usually created with TR_PROFILE_SCOPE() rather than directly.
+	 ******************************************************************************************************************/
+	class ProfileZone {
+	  public:
+		/**************************************************************************************************************
+		 * Starts a profiler zone.
+		 *
+		 * @param[in] name
+		 * @parblock
+		 * The name of the zone.
+		 *
+		 * @pre @em name must point to a string that outlives all collected frames containing the zone (usually a
+		 *      string literal).
+		 * @endparblock
+		 **************************************************************************************************************/
+		explicit ProfileZone(const char* name) noexcept;
+
+		/**************************************************************************************************************
+		 * Ends the profiler zone.
+		 **************************************************************************************************************/
+		~ProfileZone() noexcept;
+
+		ProfileZone(const ProfileZone&)            = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+
+	  private:
+		const char* _name;  // The name of the zone.
+		TimePoint   _start; // The start point of the zone.
+	};
+
+	/******************************************************************************************************************
+	 * Node in a profiler call tree.
+	 ******************************************************************************************************************/
+	struct ProfileNode {
+		/**************************************************************************************************************
+		 * The name of the zone.
+		 **************************************************************************************************************/
+		const char* name;
+
+		/**************************************************************************************************************
+		 * The start point of the zone.
+		 **************************************************************************************************************/
+		TimePoint start;
+
+		/**************************************************************************************************************
+		 * The duration of the zone.
+		 **************************************************************************************************************/
+		Duration duration;
+
+		/**************************************************************************************************************
+		 * The zones nested directly inside this zone, in chronological order.
+		 **************************************************************************************************************/
+		std::vector<ProfileNode> children;
+
+		/**************************************************************************************************************
+		 * Gets the time spent in the zone itself and not in any of its children.
+		 *
+		 * @return The self time of the zone.
+		 **************************************************************************************************************/
+		Duration selfDuration() const noexcept;
+	};
+
+	/******************************************************************************************************************
+	 * Call tree of the zones completed on a single thread.
+	 ******************************************************************************************************************/
+	struct ProfileThread {
+		/**************************************************************************************************************
+		 * The profiler-assigned index of the thread, in order of the first zone recorded on each thread.
+		 **************************************************************************************************************/
+		std::uint32_t index;
+
+		/**************************************************************************************************************
+		 * The top-level zones completed on the thread, in chronological order.
+		 **************************************************************************************************************/
+		std::vector<ProfileNode> roots;
+	};
+
+	/******************************************************************************************************************
+	 * Profiler data collected over a frame.
+	 ******************************************************************************************************************/
+	struct ProfileFrame {
+		/**************************************************************************************************************
+		 * The start point of the frame (the previous call to collectProfileFrame()).
+		 **************************************************************************************************************/
+		TimePoint start;
+
+		/**************************************************************************************************************
+		 * The end point of the frame.
+		 **************************************************************************************************************/
+		TimePoint end;
+
+		/**************************************************************************************************************
+		 * The call trees of all threads that completed zones during the frame.
+		 **************************************************************************************************************/
+		std::vector<ProfileThread> threads;
+
+		/**************************************************************************************************************
+		 * The number of zones dropped due to full thread buffers.
+		 **************************************************************************************************************/
+		std::size_t droppedZones;
+	};
+
+	/******************************************************************************************************************
+	 * Drains the zones completed since the last call on all threads and aggregates them into per-thread call trees.
+	 *
+	 * Zones that are still in progress when this function is called will be collected into the frame they finish in.
+	 *
+	 * @par Exception Safety
+	 *
+	 * Basic exception guarantee: zones drained before the exception was thrown are lost.
+	 *
+	 * @exception std::bad_alloc If an internal allocation fails.
+	 *
+	 * @return The collected frame.
+	 ******************************************************************************************************************/
+	ProfileFrame collectProfileFrame();
+
+	/******************************************************************************************************************
+	 * Writes profiler frames to a stream in the Chrome trace event JSON format.
+	 *
+	 * The output can be inspected using chrome://tracing, Perfetto, or any other compatible viewer.
+	 *
+	 * @param[out] os The output stream.
+	 * @param[in] frames The frames to write.
+	 ******************************************************************************************************************/
+	void writeChromeTrace(std::ostream& os, std::span<const ProfileFrame> frames);
+
+	/// @}
+} // namespace tr
+
+/// @cond IMPLEMENTATION
+#define TR_PROFILE_CONCAT_IMPL(a, b) a##b
+#define TR_PROFILE_CONCAT(a, b)      TR_PROFILE_CONCAT_IMPL(a, b)
+/// @endcond
+
+#ifdef TR_ENABLE_PROFILER
+/**********************************************************************************************************************
+ * Profiles the rest of the enclosing scope as a zone.
+ *
+ * Compiles to nothing if TR_ENABLE_PROFILER is not defined.
+ *
+ * @param[in] name The name of the zone, usually a string literal.
+ **********************************************************************************************************************/
+#define TR_PROFILE_SCOPE(name) const tr::ProfileZone TR_PROFILE_CONCAT(_trProfileZone, __LINE__){name}
+#else
+#define TR_PROFILE_SCOPE(name)
+#endif
@@ -0,0 +1,165 @@
+#pragma once
+#include "handle.hpp"
+#include "texture.hpp"
+
+namespace tr {
+	struct SamplerState;
+} // namespace tr
+
+/// @cond IMPLEMENTATION
+template <> struct std::hash<tr::SamplerState> {
+	std::size_t operator()(const tr::SamplerState& state) const noexcept;
+};
+/// @endcond
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup sampler Sampler
+	 *  Sampler objects and sampler cache.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Sampling state of a sampler.
+	 *
+	 * The defaults match the default sampling state of OpenGL textures.
+	 ******************************************************************************************************************/
+	struct SamplerState {
+		/**************************************************************************************************************
+		 * The minifying filter.
+		 **************************************************************************************************************/
+		MinFilter minFilter{MinFilter::NMIP_LINEAR};
+
+		/**************************************************************************************************************
+		 * The magnifying filter.
+		 **************************************************************************************************************/
+		MagFilter magFilter{MagFilter::LINEAR};
+
+		/**************************************************************************************************************
+		 * The wrapping used along every axis.
+		 **************************************************************************************************************/
+		Wrap wrap{Wrap::REPEAT};
+
+		/**************************************************************************************************************
+		 * The border color (used when Wrap::BORDER_CLAMP is in use).
+		 **************************************************************************************************************/
+		RGBAF borderColor{0, 0, 0, 0};
+
+		/**************************************************************************************************************
+		 * The maximum degree of anisotropic filtering, where 1 disables it.
+		 **************************************************************************************************************/
+		float maxAnisotropy{1};
+
+		constexpr friend bool operator==(const SamplerState&, const SamplerState&) noexcept = default;
+	};
+
+	/******************************************************************************************************************
+	 * GPU sampler object.
+	 *
+	 * A sampler bound to a texture unit overrides the sampling parameters of the texture bound to the same unit, which
+	 * allows one texture to be sampled in different ways without changing its parameters. Samplers are immutable;
+	 * to share samplers with the same state, use SamplerCache.
+	 *
+	 * Sampler is non-copyable and movable.
+	 ******************************************************************************************************************/
+	class Sampler {
+	  public:
+		/**************************************************************************************************************
+		 * Creates a sampler.
+		 *
+		 * @param[in] state
+		 * @parblock
+		 * The sampling state of the sampler.
+		 *
+		 * @pre @em state.maxAnisotropy must be at least 1.
+		 * @endparblock
+		 **************************************************************************************************************/
+		explicit Sampler(const SamplerState& state) noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the sampling state of the sampler.
+		 *
+		 * @return A reference to the sampling state.
+		 **************************************************************************************************************/
+		const SamplerState& state() const noexcept;
+
+		/**************************************************************************************************************
+		 * Sets the debug label of the sampler.
+		 *
+		 * @param[in] label The new label of the sampler.
+		 **************************************************************************************************************/
+		void setLabel(std::string_view label) noexcept;
+
+	  private:
+		struct Deleter {
+			void operator()(unsigned int id) const noexcept;
+		};
+
+		Handle<unsigned int, 0, Deleter> _id;    // The OpenGL ID of the sampler.
+		SamplerState                     _state; // The sampling state of the sampler.
+
+		friend class TextureUnit;
+	};
+
+	/******************************************************************************************************************
+	 * Deduplicating cache of samplers, keyed by sampling state.
+	 *
+	 * Requesting the same state twice returns the same sampler, so materials that sample in the same way share one
+	 * sampler object, and switching between them doesn't rebind the sampler.
+	 ******************************************************************************************************************/
+	class SamplerCache {
+	  public:
+		/**************************************************************************************************************
+		 * Gets a sampler with a given state, creating it if it isn't in the cache yet.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] state
+		 * @parblock
+		 * The sampling state.
+		 *
+		 * @pre @em state.maxAnisotropy must be at least 1.
+		 * @endparblock
+		 *
+		 * @return A reference to the sampler, valid until the cache is cleared or destroyed.
+		 **************************************************************************************************************/
+		const Sampler& get(const SamplerState& state);
+
+		/**************************************************************************************************************
+		 * Gets the number of samplers in the cache.
+		 *
+		 * @return The number of samplers in the cache.
+		 **************************************************************************************************************/
+		std::size_t size() const noexcept;
+
+		/**************************************************************************************************************
+		 * Destroys all samplers in the cache.
+		 **************************************************************************************************************/
+		void clear() noexcept;
+
+	  private:
+		std::unordered_map<SamplerState, Sampler> _samplers; // The cached samplers.
+	};
+
+	/// @}
+} // namespace tr
+
+/// @cond IMPLEMENTATION
+
+inline std::size_t std::hash<tr::SamplerState>::operator()(const tr::SamplerState& state) const noexcept
+{
+	std::size_t hash{std::hash<float>{}(state.maxAnisotropy)};
+	for (std::size_t value : {static_cast<std::size_t>(state.minFilter), static_cast<std::size_t>(state.magFilter),
+							  static_cast<std::size_t>(state.wrap), std::hash<float>{}(state.borderColor.r),
+							  std::hash<float>{}(state.borderColor.g), std::hash<float>{}(state.borderColor.b),
+							  std::hash<float>{}(state.borderColor.a)}) {
+		hash = hash * 31 + value;
+	}
+	return hash;
+}
+
+/// @endcond
@@ -1,9 +1,12 @@
 #pragma once
 #include "handle.hpp"
 #include "iostream.hpp"
+#include "ranges.hpp"
 
 namespace tr {
 	class ShaderBuffer;
+	class UniformBuffer;
+	struct UniformBufferBlock;
 	class TextureUnit;
 
 	/** @ingroup graphics
@@ -34,6 +37,23 @@ namespace tr {
 		// COMPUTE = 0x91B9
 	};
 
+	/******************************************************************************************************************
+	 * SPIR-V specialization constant value.
+	 ******************************************************************************************************************/
+	struct SpecializationConstant {
+		/**************************************************************************************************************
+		 * The constant ID of the specialization constant (layout(constant_id = ...) in GLSL).
+		 **************************************************************************************************************/
+		std::uint32_t id;
+
+		/**************************************************************************************************************
+		 * The value of the constant, as its bit pattern (use std::bit_cast for float constants).
+		 **************************************************************************************************************/
+		std::uint32_t value;
+
+		friend bool operator==(const SpecializationConstant&, const SpecializationConstant&) = default;
+	};
+
 	/******************************************************************************************************************
 	 * GPU shader program.
 	 *
@@ -777,6 +797,26 @@ namespace tr {
 		 **************************************************************************************************************/
 		void setStorageBuffer(unsigned int index, ShaderBuffer& buffer) noexcept;
 
+		/**************************************************************************************************************
+		 * Binds a uniform block of a uniform buffer.
+		 *
+		 * @param[in] index
+		 * @parblock
+		 * The uniform block binding to bind to.
+		 *
+		 * @pre The binding must be valid.
+		 * @endparblock
+		 * @param[in] buffer The uniform buffer containing the block.
+		 * @param[in] block
+		 * @parblock
+		 * The block to bind.
+		 *
+		 * @pre @em block must have been pushed into @em buffer during the current frame, and the buffer must have been
+		 *      uploaded since.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void setUniformBlock(unsigned int index, const UniformBuffer& buffer, UniformBufferBlock block) noexcept;
+
 		/**************************************************************************************************************
 		 * Sets the debug label of the shader.
 		 *
@@ -795,8 +835,11 @@ namespace tr {
 		Shader(unsigned int id, ShaderType type) noexcept;
 
 		friend class ShaderPipeline;
-		friend Shader loadEmbeddedShader(std::span<const std::byte> embeddedFile, ShaderType type) noexcept;
-		friend Shader loadShaderFile(const std::filesystem::path& path, ShaderType type);
+		friend class ShaderVariantCache;
+		friend Shader loadEmbeddedShader(std::span<const std::byte> embeddedFile, ShaderType type,
+										 std::span<const SpecializationConstant> constants) noexcept;
+		friend Shader loadShaderFile(const std::filesystem::path& path, ShaderType type,
+									 std::span<const SpecializationConstant> constants);
 	};
 
 	/**************************************************************************************************************
@@ -808,10 +851,12 @@ namespace tr {
 	 *
 	 * @param data An embedded SPIR-V shader file.
 	 * @param type The shader type.
+	 * @param constants The values of the specialization constants to specialize the shader with.
 	 *
 	 * @return The loaded shader.
 	 **************************************************************************************************************/
-	Shader loadEmbeddedShader(std::span<const std::byte> data, ShaderType type) noexcept;
+	Shader loadEmbeddedShader(std::span<const std::byte> data, ShaderType type,
+							  std::span<const SpecializationConstant> constants = {}) noexcept;
 
 	/**************************************************************************************************************
 	 * Loads a shader from an embedded file.
@@ -822,12 +867,15 @@ namespace tr {
 	 *
 	 * @param range An embedded SPIR-V shader file.
 	 * @param type The shader type.
+	 * @param constants The values of the specialization constants to specialize the shader with.
 	 *
 	 * @return The loaded shader.
 	 **************************************************************************************************************/
-	template <std::ranges::contiguous_range Range> Shader loadEmbeddedShader(Range&& range, ShaderType type) noexcept
+	template <std::ranges::contiguous_range Range>
+	Shader loadEmbeddedShader(Range&& range, ShaderType type,
+							  std::span<const SpecializationConstant> constants = {}) noexcept
 	{
-		return loadEmbeddedShader(std::span<const std::byte>(rangeBytes(range)), type);
+		return loadEmbeddedShader(std::span<const std::byte>(rangeBytes(range)), type, constants);
 	}
 
 	/**************************************************************************************************************
@@ -844,10 +892,71 @@ namespace tr {
 	 *
 	 * @param path The path to the shader file.
 	 * @param type The shader type.
+	 * @param constants The values of the specialization constants to specialize the shader with.
 	 *
 	 * @return The loaded shader.
 	 **************************************************************************************************************/
-	Shader loadShaderFile(const std::filesystem::path& path, ShaderType type);
+	Shader loadShaderFile(const std::filesystem::path& path, ShaderType type,
+						  std::span<const SpecializationConstant> constants = {});
+
+	/******************************************************************************************************************
+	 * Shader program binary cache statistics.
+	 ******************************************************************************************************************/
+	struct ShaderCacheStats {
+		/**************************************************************************************************************
+		 * The number of shaders loaded from a cached program binary.
+		 **************************************************************************************************************/
+		std::size_t hits;
+
+		/**************************************************************************************************************
+		 * The number of shaders that had no cached program binary and were compiled from SPIR-V.
+		 **************************************************************************************************************/
+		std::size_t misses;
+
+		/**************************************************************************************************************
+		 * The number of cached program binaries that were rejected by the driver or were corrupt.
+		 **************************************************************************************************************/
+		std::size_t rejected;
+	};
+
+	/******************************************************************************************************************
+	 * Enables the on-disk shader program binary cache.
+	 *
+	 * While the cache is enabled, linked shader programs are saved to the cache directory with glGetProgramBinary, and
+	 * later loads of the same shader skip SPIR-V specialization and linking by loading the saved binary instead.
+	 * Cached binaries are keyed by a hash of the SPIR-V data, shader type, specialization constants and the driver
+	 * vendor, renderer and version strings, so driver updates invalidate the cache automatically. If the driver
+	 * rejects a cached binary, the shader is transparently compiled from SPIR-V and the cached binary is replaced.
+	 *
+	 * A good location for the cache is a subdirectory of the user directory (see getUserDir()).
+	 *
+	 * @note This function must be called after the graphics context is created. If the driver supports no program
+	 * binary formats, the cache stays disabled.
+	 *
+	 * @par Exception Safety
+	 *
+	 * Strong exception guarantee.
+	 *
+	 * @exception std::filesystem::filesystem_error If creating the cache directory fails.
+	 * @exception std::bad_alloc If an internal allocation fails.
+	 *
+	 * @param[in] dir The directory to store cached program binaries in. It will be created if it doesn't exist.
+	 ******************************************************************************************************************/
+	void enableShaderCache(const std::filesystem::path& dir);
+
+	/******************************************************************************************************************
+	 * Disables the on-disk shader program binary cache.
+	 *
+	 * Files already in the cache directory are left untouched.
+	 ******************************************************************************************************************/
+	void disableShaderCache() noexcept;
+
+	/******************************************************************************************************************
+	 * Gets the statistics of the shader program binary cache since it was enabled.
+	 *
+	 * @return The cache statistics, or all zeros if the cache is disabled.
+	 ******************************************************************************************************************/
+	ShaderCacheStats shaderCacheStats() noexcept;
 
 	/// @}
 } // namespace tr
@@ -42,6 +42,7 @@ namespace tr {
 		void bind() const noexcept;
 
 		friend class GraphicsContext;
+		friend struct PipelineState;
 	};
 
 	/******************************************************************************************************************
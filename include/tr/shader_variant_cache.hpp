@@ -0,0 +1,205 @@
+#pragma once
+#include "benchmark.hpp"
+#include "hashmap.hpp"
+#include "shader.hpp"
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup shader_variant_cache Shader Variant Cache
+	 *  Lazily compiled cache of specialized shader variants.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Cache of shader variants, keyed by SPIR-V module and specialization constants.
+	 *
+	 * Modules are registered with the cache once, after which variants are compiled the first time they are
+	 * requested through get(). To avoid compiling variants in the middle of a frame, variants that are known to be
+	 * needed soon can be queued with prefetch() and compiled a few at a time between frames with compilePending(),
+	 * which stops once a time budget is spent. Combined with the program binary cache (see enableShaderCache()), this
+	 * makes repeated variant creation a cheap binary load.
+	 *
+	 * The order of specialization constants in a request doesn't matter; they are sorted by ID when forming the key.
+	 *
+	 * @note All functions must be called on the thread owning the graphics context.
+	 ******************************************************************************************************************/
+	class ShaderVariantCache {
+	  public:
+		/**************************************************************************************************************
+		 * Constructs an empty variant cache.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If allocating the timing measurement storage fails.
+		 **************************************************************************************************************/
+		ShaderVariantCache();
+
+		/**************************************************************************************************************
+		 * Registers a SPIR-V module with the cache.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] data
+		 * @parblock
+		 * The SPIR-V module data.
+		 *
+		 * @pre @em data must be a valid SPIR-V module.
+		 * @endparblock
+		 * @param[in] type The shader type of the module.
+		 *
+		 * @return The ID of the module within the cache.
+		 **************************************************************************************************************/
+		std::size_t addModule(std::vector<std::byte> data, ShaderType type);
+
+		/**************************************************************************************************************
+		 * Registers a SPIR-V module file with the cache.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception FileNotFound If the file is not found.
+		 * @exception FileOpenError If opening the file fails.
+		 * @exception std::bad_alloc If copying the contents of the file to a buffer fails.
+		 *
+		 * @param[in] path The path to the SPIR-V module file.
+		 * @param[in] type The shader type of the module.
+		 *
+		 * @return The ID of the module within the cache.
+		 **************************************************************************************************************/
+		std::size_t addModuleFile(const std::filesystem::path& path, ShaderType type);
+
+		/**************************************************************************************************************
+		 * Gets the number of registered modules.
+		 *
+		 * @return The number of registered modules.
+		 **************************************************************************************************************/
+		std::size_t modules() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of compiled variants.
+		 *
+		 * @return The number of compiled variants across all modules.
+		 **************************************************************************************************************/
+		std::size_t variants() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of variants queued by prefetch() and not yet compiled.
+		 *
+		 * @return The number of pending variants.
+		 **************************************************************************************************************/
+		std::size_t pending() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets a variant, compiling it if it isn't in the cache yet.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 * @exception ShaderLoadError If specializing or linking the variant fails. The path of the error is that of the
+		 *                            module file, or empty if the module was added from memory.
+		 *
+		 * @param[in] module
+		 * @parblock
+		 * The ID of the module.
+		 *
+		 * @pre @em module must be an ID returned by addModule() or addModuleFile().
+		 * @endparblock
+		 * @param[in] constants The values of the specialization constants of the variant.
+		 *
+		 * @return A reference to the variant, valid until the cache is cleared or destroyed.
+		 **************************************************************************************************************/
+		Shader& get(std::size_t module, std::span<const SpecializationConstant> constants = {});
+
+		/**************************************************************************************************************
+		 * Queues a variant to be compiled by compilePending(), unless it is already compiled.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] module
+		 * @parblock
+		 * The ID of the module.
+		 *
+		 * @pre @em module must be an ID returned by addModule() or addModuleFile().
+		 * @endparblock
+		 * @param[in] constants The values of the specialization constants of the variant.
+		 **************************************************************************************************************/
+		void prefetch(std::size_t module, std::span<const SpecializationConstant> constants = {});
+
+		/**************************************************************************************************************
+		 * Compiles queued variants until the queue is empty or the time budget is spent.
+		 *
+		 * At least one variant is compiled if any are pending, so progress is made even with a budget of 0.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Basic exception guarantee: variants compiled before the exception remain in the cache, and the variant that
+		 * failed is removed from the queue.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 * @exception ShaderLoadError If specializing or linking a variant fails. The path of the error is that of the
+		 *                            module file, or empty if the module was added from memory.
+		 *
+		 * @param[in] budget The amount of time that may be spent compiling.
+		 *
+		 * @return The number of variants compiled.
+		 **************************************************************************************************************/
+		std::size_t compilePending(Duration budget);
+
+		/**************************************************************************************************************
+		 * Gets the benchmark of variant creation times.
+		 *
+		 * Every variant compiled by get() or compilePending() adds a measurement.
+		 *
+		 * @return A reference to the benchmark.
+		 **************************************************************************************************************/
+		const Benchmark& creationTimes() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the total time spent creating variants since the cache was constructed.
+		 *
+		 * @return The total variant creation time.
+		 **************************************************************************************************************/
+		Duration totalCreationTime() const noexcept;
+
+		/**************************************************************************************************************
+		 * Destroys all compiled variants and empties the queue, keeping the registered modules.
+		 **************************************************************************************************************/
+		void clear() noexcept;
+
+	  private:
+		// A registered SPIR-V module.
+		struct Module {
+			std::vector<std::byte> data; // The SPIR-V data.
+			ShaderType             type; // The shader type.
+			std::filesystem::path  path; // The path to the module file, or an empty path if added from memory.
+		};
+
+		std::vector<Module>                 _modules;        // The registered modules.
+		StringHashMap<Shader>               _variants;       // The compiled variants, keyed by module and constants.
+		std::vector<std::string>            _pending;        // Keys of variants queued for compilation.
+		std::string                         _keyBuffer;      // Scratch buffer for building lookup keys.
+		std::vector<SpecializationConstant> _constantBuffer; // Scratch buffer for sorting constants.
+		Benchmark                           _benchmark;      // Variant creation times.
+		Duration                            _totalTime;      // Total variant creation time.
+
+		// Builds the key of a variant into the scratch buffer.
+		std::string_view buildKey(std::size_t module, std::span<const SpecializationConstant> constants);
+		// Compiles a variant from its key and adds it to the cache, throwing ShaderLoadError if compilation fails.
+		Shader& compile(std::string key);
+	};
+
+	/// @}
+} // namespace tr
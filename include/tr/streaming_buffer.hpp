@@ -0,0 +1,223 @@
+#pragma once
+#include "graphics_buffer.hpp"
+#include "ranges.hpp"
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup streaming_buffer Streaming Buffer
+	 *  Persistently mapped streaming buffer for dynamic geometry.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Sub-range of a streaming buffer handed out for writing.
+	 *
+	 * @tparam T The type of the objects in the range.
+	 ******************************************************************************************************************/
+	template <StandardLayout T> struct StreamingBufferRange {
+		/**************************************************************************************************************
+		 * The mapped memory of the range, which can be written to directly.
+		 **************************************************************************************************************/
+		std::span<T> data;
+
+		/**************************************************************************************************************
+		 * The offset of the range within the buffer in bytes.
+		 **************************************************************************************************************/
+		std::size_t offset;
+
+		/**************************************************************************************************************
+		 * Gets the offset of the range within the buffer in units of T.
+		 *
+		 * This can be passed directly to the draw functions of GraphicsContext.
+		 *
+		 * @pre The range must have been allocated with an alignment that is a multiple of sizeof(T) (the default).
+		 *
+		 * @return The offset of the range in elements.
+		 **************************************************************************************************************/
+		constexpr std::size_t elementOffset() const noexcept;
+	};
+
+	/******************************************************************************************************************
+	 * Persistently mapped ring buffer for streaming dynamic vertex and index data.
+	 *
+	 * The whole buffer is mapped once, coherently, for its entire lifetime, and sub-ranges are handed out by
+	 * allocate(). When a frame's draws have been submitted, endFrame() places a fence guarding the memory used during
+	 * the frame; that memory is only handed out again once the GPU has passed the fence. As long as the buffer is
+	 * large enough to hold the data of all frames in flight, allocating never blocks.
+	 *
+	 * The buffer can be bound as both a vertex and an index buffer (see GraphicsContext::setVertexBuffer() and
+	 * GraphicsContext::setIndexBuffer()).
+	 *
+	 * StreamingBuffer is non-copyable and movable.
+	 ******************************************************************************************************************/
+	class StreamingBuffer {
+	  public:
+		/**************************************************************************************************************
+		 * The default maximum number of frames in flight.
+		 **************************************************************************************************************/
+		static constexpr std::size_t DEFAULT_FRAMES_IN_FLIGHT{3};
+
+		/**************************************************************************************************************
+		 * Allocates and maps a streaming buffer.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception GraphicsBufferBadAlloc If allocating the buffer fails.
+		 * @exception GraphicsBufferMapBadAlloc If mapping the buffer fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] capacity
+		 * @parblock
+		 * The capacity of the buffer in bytes.
+		 *
+		 * @pre @em capacity must be greater than 0.
+		 * @endparblock
+		 * @param[in] framesInFlight
+		 * @parblock
+		 * The maximum number of frames that may be in flight at once. If this many frames are in flight when ending
+		 * a frame, the oldest one is waited on.
+		 *
+		 * @pre @em framesInFlight must be greater than 0.
+		 * @endparblock
+		 **************************************************************************************************************/
+		explicit StreamingBuffer(std::size_t capacity, std::size_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT);
+
+		/**************************************************************************************************************
+		 * Gets the capacity of the buffer.
+		 *
+		 * @return The capacity of the buffer in bytes.
+		 **************************************************************************************************************/
+		std::size_t capacity() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of bytes allocated since the last call to endFrame().
+		 *
+		 * @return The number of bytes allocated during the current frame, including alignment padding.
+		 **************************************************************************************************************/
+		std::size_t frameSize() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of times allocation had to wait for the GPU.
+		 *
+		 * A non-zero value means the buffer is too small for the amount of data streamed per frame.
+		 *
+		 * @return The number of stalls.
+		 **************************************************************************************************************/
+		std::size_t stalls() const noexcept;
+
+		/**************************************************************************************************************
+		 * Allocates a sub-range of the buffer for writing.
+		 *
+		 * The returned memory stays valid until the end of the frame after which the GPU has consumed it.
+		 *
+		 * @tparam T The type of the objects in the range.
+		 *
+		 * @param[in] count
+		 * @parblock
+		 * The number of objects to allocate.
+		 *
+		 * @pre @em count must be greater than 0, and the total size allocated during a single frame may not exceed
+		 *      the capacity of the buffer.
+		 * @endparblock
+		 * @param[in] alignment
+		 * @parblock
+		 * The alignment of the range within the buffer in bytes.
+		 *
+		 * @pre @em alignment must be greater than 0.
+		 * @endparblock
+		 *
+		 * @return The allocated range.
+		 **************************************************************************************************************/
+		template <StandardLayout T>
+		StreamingBufferRange<T> allocate(std::size_t count, std::size_t alignment = sizeof(T)) noexcept;
+
+		/**************************************************************************************************************
+		 * Allocates a sub-range of the buffer and copies data into it.
+		 *
+		 * @param[in] range
+		 * @parblock
+		 * The data to copy.
+		 *
+		 * @pre @em range may not be empty, and the total size allocated during a single frame may not exceed the
+		 *      capacity of the buffer.
+		 * @endparblock
+		 *
+		 * @return The allocated range.
+		 **************************************************************************************************************/
+		template <StandardLayoutRange R>
+		StreamingBufferRange<std::ranges::range_value_t<R>> push(const R& range) noexcept;
+
+		/**************************************************************************************************************
+		 * Ends the current frame, placing a fence after the commands that use its data.
+		 *
+		 * This should be called after all draws using data allocated during the frame have been issued.
+		 **************************************************************************************************************/
+		void endFrame() noexcept;
+
+		/**************************************************************************************************************
+		 * Sets the debug label of the buffer.
+		 *
+		 * @param[in] label The new label of the buffer.
+		 **************************************************************************************************************/
+		void setLabel(std::string_view label) noexcept;
+
+	  private:
+		struct FenceDeleter {
+			void operator()(void* sync) const noexcept;
+		};
+
+		// The fence and size of a frame in flight.
+		struct Frame {
+			std::unique_ptr<void, FenceDeleter> fence; // The fence placed at the end of the frame.
+			std::size_t                         size;  // The number of bytes allocated during the frame.
+		};
+
+		GraphicsBuffer     _buffer;      // The underlying buffer.
+		GraphicsBufferMap  _map;         // The persistent map of the entire buffer.
+		std::vector<Frame> _frames;      // Ring of frames in flight.
+		std::size_t        _firstFrame;  // The index of the oldest frame in flight.
+		std::size_t        _frameCount;  // The number of frames in flight.
+		std::size_t        _head;        // The offset where the next allocation starts.
+		std::size_t        _used;        // The number of bytes used by the frames in flight and the current frame.
+		std::size_t        _frameSize;   // The number of bytes allocated during the current frame.
+		std::size_t        _stalls;      // The number of times allocation had to wait.
+
+		// Allocates a range of bytes.
+		std::size_t allocateBytes(std::size_t size, std::size_t alignment) noexcept;
+		// Releases frames the GPU is done with, waiting for the oldest one if requested.
+		void retireFrames(bool wait) noexcept;
+
+		friend class GraphicsContext;
+		friend class UniformBuffer;
+		friend class TextureUploadQueue;
+	};
+
+	/// @}
+} // namespace tr
+
+/// @cond IMPLEMENTATION
+
+template <tr::StandardLayout T> constexpr std::size_t tr::StreamingBufferRange<T>::elementOffset() const noexcept
+{
+	return offset / sizeof(T);
+}
+
+template <tr::StandardLayout T>
+tr::StreamingBufferRange<T> tr::StreamingBuffer::allocate(std::size_t count, std::size_t alignment) noexcept
+{
+	const std::size_t offset{allocateBytes(count * sizeof(T), alignment)};
+	return {asMutObjects<T>(_map.span().subspan(offset, count * sizeof(T))), offset};
+}
+
+template <tr::StandardLayoutRange R>
+tr::StreamingBufferRange<std::ranges::range_value_t<R>> tr::StreamingBuffer::push(const R& range) noexcept
+{
+	StreamingBufferRange<std::ranges::range_value_t<R>> allocation{
+		allocate<std::ranges::range_value_t<R>>(std::ranges::size(range))};
+	std::ranges::copy(range, allocation.data.begin());
+	return allocation;
+}
+
+/// @endcond
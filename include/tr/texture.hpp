@@ -20,6 +20,11 @@ namespace tr {
 
 	/******************************************************************************************************************
 	 * Color texture format types.
+	 *
+	 * The BC and ETC2 formats are block-compressed and can only be filled with compressed data (see
+	 * ColorTexture2D::setCompressedRegion() and compressBitmap()). BC1 and BC3 require
+	 * EXT_texture_compression_s3tc, which is available on all desktop drivers. ETC2 is core, but desktop drivers
+	 * commonly decompress it on upload, so it only saves disk space there.
 	 ******************************************************************************************************************/
 	enum class ColorTextureFormat {
 		R8          = 0x8229,
@@ -78,6 +83,24 @@ namespace tr {
 		RGBA_UI16   = 0x8D76,
 		RGBA_SI32   = 0x8D82,
 		RGBA_UI32   = 0x8D70,
+
+		BC1_RGB      = 0x83F0,
+		BC1_RGBA     = 0x83F1,
+		BC1_SRGB     = 0x8C4C,
+		BC1_SRGBA    = 0x8C4D,
+		BC3_RGBA     = 0x83F3,
+		BC3_SRGBA    = 0x8C4F,
+		BC4_R        = 0x8DBB,
+		BC4_R_SNORM  = 0x8DBC,
+		BC5_RG       = 0x8DBD,
+		BC5_RG_SNORM = 0x8DBE,
+		BC7_RGBA     = 0x8E8C,
+		BC7_SRGBA    = 0x8E8D,
+		ETC2_RGB8    = 0x9274,
+		ETC2_SRGB8   = 0x9275,
+		ETC2_RGB8A1  = 0x9276,
+		ETC2_RGBA8   = 0x9278,
+		ETC2_SRGBA8  = 0x9279,
 	};
 
 	/******************************************************************************************************************
@@ -311,7 +334,10 @@ namespace tr {
 
 		friend class BasicFramebuffer;
 		friend class Framebuffer;
+		friend class TextureBinder;
 		friend class TextureUnit;
+		friend class TextureTable;
+		friend class TextureUploadQueue;
 		friend class std::hash<Texture>;
 		friend std::uint64_t ImGui::getTextureID(const Texture& texture) noexcept;
 	};
@@ -344,6 +370,21 @@ namespace tr {
 		 **************************************************************************************************************/
 		void clear(const RGBAF& color) noexcept;
 
+		/**************************************************************************************************************
+		 * Gets the number of mipmap levels allocated for the texture.
+		 *
+		 * @return The number of levels, including the base level (1 if the texture isn't mipmapped).
+		 **************************************************************************************************************/
+		int levels() const noexcept;
+
+		/**************************************************************************************************************
+		 * Regenerates every mipmap level of the texture from the base level on the GPU.
+		 *
+		 * The GPU downsamples with a driver-defined filter. For pre-filtered levels, build a chain with
+		 * buildMipChain() and upload the levels individually instead.
+		 **************************************************************************************************************/
+		void generateMipmaps() noexcept;
+
 	  protected:
 		/// @cond IMPLEMENTATION
 		using Texture::Texture;
@@ -610,12 +651,80 @@ namespace tr {
 		/**************************************************************************************************************
 		 * Sets a region of the texture.
 		 *
+		 * The mipmap levels of the texture are regenerated from the base level afterwards.
+		 *
 		 * @pre The region must fully be inside the bounds of the texture.
 		 *
 		 * @param[in] tl The top-left corner of the region within the texture.
 		 * @param[in] bitmap The bitmap data to set the region to.
 		 **************************************************************************************************************/
 		void setRegion(glm::ivec2 tl, SubBitmap bitmap) noexcept;
+
+		/**************************************************************************************************************
+		 * Sets a region of a mipmap level of the texture.
+		 *
+		 * Unlike setRegion(), this doesn't regenerate any other levels, which allows uploading a pre-filtered mip
+		 * chain:
+		 *
+		 * @code
+		 * tr::ColorTexture2D texture{bitmap.size(), true};
+		 * texture.setLevelRegion(0, {0, 0}, bitmap);
+		 * std::vector<tr::Bitmap> chain{tr::buildMipChain(bitmap, tr::MipFilter::KAISER)};
+		 * for (std::size_t i = 0; i < chain.size(); ++i) {
+		 *     texture.setLevelRegion(int(i + 1), {0, 0}, chain[i]);
+		 * }
+		 * @endcode
+		 *
+		 * @param[in] level
+		 * @parblock
+		 * The mipmap level to set.
+		 *
+		 * @pre @em level must be less than levels().
+		 * @endparblock
+		 * @param[in] tl The top-left corner of the region within the level.
+		 * @param[in] bitmap
+		 * @parblock
+		 * The bitmap data to set the region to.
+		 *
+		 * @pre The region must fully be inside the bounds of the level.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void setLevelRegion(int level, glm::ivec2 tl, SubBitmap bitmap) noexcept;
+
+		/**************************************************************************************************************
+		 * Sets a region of a mipmap level of a block-compressed texture.
+		 *
+		 * The data is copied as is, so it must already be encoded in the internal format of the texture (see
+		 * compressBitmap()). Compressed levels can't be generated by the GPU, so every level must be set explicitly.
+		 *
+		 * @param[in] level
+		 * @parblock
+		 * The mipmap level to set.
+		 *
+		 * @pre @em level must be less than levels().
+		 * @endparblock
+		 * @param[in] tl
+		 * @parblock
+		 * The top-left corner of the region within the level.
+		 *
+		 * @pre Both components of @em tl must be multiples of 4.
+		 * @endparblock
+		 * @param[in] size
+		 * @parblock
+		 * The size of the region in texels.
+		 *
+		 * @pre The region must fully be inside the bounds of the level.
+		 * @pre Both components of @em size must be multiples of 4, unless the region extends to the edge of the level.
+		 * @endparblock
+		 * @param[in] blocks
+		 * @parblock
+		 * The compressed blocks, in row-major order.
+		 *
+		 * @pre The internal format of the texture must be a compressed format.
+		 * @pre @em blocks must hold exactly the blocks covering the region.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void setCompressedRegion(int level, glm::ivec2 tl, glm::ivec2 size, std::span<const std::byte> blocks) noexcept;
 	};
 
 	/******************************************************************************************************************
@@ -0,0 +1,157 @@
+#pragma once
+#include "bitmap.hpp"
+#include "texture.hpp"
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup texture_atlas Texture Atlas
+	 *  Dynamically packed texture atlas.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Texture that many small bitmaps are packed into.
+	 *
+	 * Bitmaps are packed using the MaxRects algorithm (best short side fit) and can be inserted and evicted
+	 * incrementally without repacking the rest of the atlas. Inserted bitmaps are first written to a CPU-side copy
+	 * of the atlas, and only the region touched since the last upload is sent to the GPU by upload().
+	 *
+	 * Evicting a bitmap makes its space fully reusable, but bitmaps are never moved, so a long sequence of
+	 * insertions and evictions can still leave the free space scattered; clearing the atlas and reinserting
+	 * everything repacks it from scratch.
+	 *
+	 * TextureAtlas is non-copyable and movable.
+	 ******************************************************************************************************************/
+	class TextureAtlas {
+	  public:
+		/**************************************************************************************************************
+		 * Allocates an empty texture atlas.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception TextureBadAlloc If allocating the texture fails.
+		 * @exception BitmapBadAlloc If allocating the CPU-side copy of the atlas fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] size
+		 * @parblock
+		 * The size of the atlas in texels.
+		 *
+		 * @pre Both components of @em size must be greater than @em padding.
+		 * @endparblock
+		 * @param[in] padding
+		 * @parblock
+		 * The number of transparent texels left between packed bitmaps and around the edges of the atlas, used to
+		 * prevent neighbouring bitmaps from bleeding into each other when sampled with linear filtering.
+		 *
+		 * @pre @em padding must be non-negative.
+		 * @endparblock
+		 * @param[in] format The internal format of the atlas texture.
+		 **************************************************************************************************************/
+		explicit TextureAtlas(glm::ivec2 size, int padding = 1, ColorTextureFormat format = ColorTextureFormat::RGBA8);
+
+		/**************************************************************************************************************
+		 * Gets the size of the atlas.
+		 *
+		 * @return The size of the atlas in texels.
+		 **************************************************************************************************************/
+		glm::ivec2 size() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the atlas texture.
+		 *
+		 * Regions inserted since the last call to upload() are not yet present in the texture.
+		 *
+		 * @return A reference to the atlas texture.
+		 **************************************************************************************************************/
+		const ColorTexture2D& texture() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the fraction of the atlas currently occupied by bitmaps and their padding.
+		 *
+		 * @return The occupancy of the atlas in the range [0, 1].
+		 **************************************************************************************************************/
+		double occupancy() const noexcept;
+
+		/**************************************************************************************************************
+		 * Inserts a bitmap into the atlas.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] bitmap
+		 * @parblock
+		 * The bitmap to insert.
+		 *
+		 * @pre Both components of the size of @em bitmap must be greater than 0.
+		 * @endparblock
+		 *
+		 * @return The region of the atlas the bitmap was placed in, or std::nullopt if there was no room for it.
+		 **************************************************************************************************************/
+		std::optional<RectI2> insert(const SubBitmap& bitmap);
+
+		/**************************************************************************************************************
+		 * Evicts a bitmap from the atlas, freeing its region for future insertions.
+		 *
+		 * The contents of the texture are left as-is.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] rect
+		 * @parblock
+		 * The region of the bitmap.
+		 *
+		 * @pre @em rect must have been returned by insert() and not yet been evicted.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void erase(const RectI2& rect);
+
+		/**************************************************************************************************************
+		 * Evicts every bitmap from the atlas.
+		 **************************************************************************************************************/
+		void clear() noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the normalized texture coordinates of a region of the atlas.
+		 *
+		 * @param[in] rect The region of the atlas in texels.
+		 *
+		 * @return The texture coordinates of the region.
+		 **************************************************************************************************************/
+		RectF2 uv(const RectI2& rect) const noexcept;
+
+		/**************************************************************************************************************
+		 * Uploads the regions inserted since the last upload to the atlas texture.
+		 *
+		 * The bounding box of all of the inserted regions is uploaded in a single transfer.
+		 **************************************************************************************************************/
+		void upload() noexcept;
+
+		/**************************************************************************************************************
+		 * Sets the debug label of the atlas texture.
+		 *
+		 * @param[in] label The new label of the texture.
+		 **************************************************************************************************************/
+		void setLabel(std::string_view label) noexcept;
+
+	  private:
+		ColorTexture2D      _texture;  // The atlas texture.
+		Bitmap              _bitmap;   // CPU-side copy of the atlas.
+		int                 _padding;  // The padding between packed bitmaps.
+		std::vector<RectI2> _free;     // The maximal free rects, including padding (they may overlap).
+		std::vector<RectI2> _used;     // The occupied rects, including padding.
+		std::int64_t        _usedArea; // The area occupied by bitmaps and their padding.
+		RectI2              _dirty;    // Bounding box of the regions inserted since the last upload.
+	};
+
+	/// @}
+} // namespace tr
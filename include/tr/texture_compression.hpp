@@ -0,0 +1,112 @@
+#pragma once
+#include "bitmap.hpp"
+#include "texture.hpp"
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup texture_compression Texture Compression
+	 *  Block-compressed texture formats and CPU encoding.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Image encoded in a block-compressed texture format.
+	 ******************************************************************************************************************/
+	struct CompressedImage {
+		/**************************************************************************************************************
+		 * The size of the image in texels.
+		 **************************************************************************************************************/
+		glm::ivec2 size;
+
+		/**************************************************************************************************************
+		 * The compressed format of the image.
+		 **************************************************************************************************************/
+		ColorTextureFormat format;
+
+		/**************************************************************************************************************
+		 * The 4x4 texel blocks of the image, in row-major order.
+		 **************************************************************************************************************/
+		std::vector<std::byte> blocks;
+	};
+
+	/******************************************************************************************************************
+	 * Gets whether a texture format is block-compressed.
+	 *
+	 * @param[in] format The format to check.
+	 *
+	 * @return True if @em format is one of the BC or ETC2 formats, false otherwise.
+	 ******************************************************************************************************************/
+	bool compressedFormat(ColorTextureFormat format) noexcept;
+
+	/******************************************************************************************************************
+	 * Gets the size of a compressed image in bytes.
+	 *
+	 * @param[in] size
+	 * @parblock
+	 * The size of the image in texels.
+	 *
+	 * @pre Both components of @em size must be greater than 0.
+	 * @endparblock
+	 * @param[in] format
+	 * @parblock
+	 * The format of the image.
+	 *
+	 * @pre @em format must be a compressed format.
+	 * @endparblock
+	 *
+	 * @return The number of bytes taken by the blocks covering the image.
+	 ******************************************************************************************************************/
+	std::size_t compressedImageBytes(glm::ivec2 size, ColorTextureFormat format) noexcept;
+
+	/******************************************************************************************************************
+	 * Encodes a bitmap in a block-compressed format on the CPU.
+	 *
+	 * The supported formats and the channels they keep are:
+	 * - BC1: RGB, with the RGBA variants storing texels with an alpha below 128 as fully transparent.
+	 * - BC3: RGBA.
+	 * - BC4: R.
+	 * - BC5: RG.
+	 * - BC7: RGBA, encoded in mode 6 only.
+	 *
+	 * The sRGB variants store the same data as their linear counterparts. The endpoints of every block are fitted
+	 * along the principal axis of its texels and refined by least squares, and texel indices are searched with SSE2
+	 * where available. Rows of blocks are split evenly between worker threads.
+	 *
+	 * The result can be uploaded with ColorTexture2D::setCompressedRegion():
+	 *
+	 * @code
+	 * tr::CompressedImage image{tr::compressBitmap(bitmap, tr::ColorTextureFormat::BC7_SRGBA)};
+	 * tr::ColorTexture2D  texture{image.size, false, image.format};
+	 * texture.setCompressedRegion(0, {0, 0}, image.size, image.blocks);
+	 * @endcode
+	 *
+	 * This function doesn't touch any global state and can safely be called from worker threads.
+	 *
+	 * @par Exception Safety
+	 *
+	 * Strong exception guarantee.
+	 *
+	 * @exception BitmapBadAlloc If converting the bitmap fails.
+	 * @exception std::bad_alloc If allocating the image fails.
+	 * @exception std::system_error If starting a worker thread fails.
+	 *
+	 * @param[in] bitmap The bitmap to encode. Bitmaps of any format are accepted.
+	 * @param[in] format
+	 * @parblock
+	 * The compressed format.
+	 *
+	 * @pre @em format must be a BC1, BC3, BC7 or unsigned BC4 or BC5 format.
+	 * @endparblock
+	 * @param[in] threads
+	 * @parblock
+	 * The number of threads to encode with, including the calling thread, or 0 to use one per hardware thread.
+	 *
+	 * @pre @em threads must not be negative.
+	 * @endparblock
+	 *
+	 * @return The compressed image.
+	 ******************************************************************************************************************/
+	CompressedImage compressBitmap(const SubBitmap& bitmap, ColorTextureFormat format, int threads = 0);
+
+	/// @}
+} // namespace tr
@@ -0,0 +1,229 @@
+#pragma once
+#include "shader_buffer.hpp"
+#include "texture.hpp"
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup texture_table Texture Table
+	 *  GPU-resident table of textures indexable from shaders.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Gets whether bindless textures are supported by the graphics context.
+	 *
+	 * @return True if GL_ARB_bindless_texture is available, false otherwise.
+	 ******************************************************************************************************************/
+	bool bindlessTexturesSupported() noexcept;
+
+	/******************************************************************************************************************
+	 * Entry of a texture table, as stored in its shader buffer.
+	 *
+	 * The entry matches the std430 layout of the following GLSL structure:
+	 *
+	 * @code
+	 * struct TextureTableEntry {
+	 *     uvec2 handle;
+	 *     vec2  uvScale;
+	 * };
+	 * @endcode
+	 ******************************************************************************************************************/
+	struct TextureTableEntry {
+		/**************************************************************************************************************
+		 * The bindless handle of the texture, split into its low and high halves.
+		 *
+		 * In fallback mode, the first component holds the layer of the fallback texture instead.
+		 **************************************************************************************************************/
+		glm::uvec2 handle;
+
+		/**************************************************************************************************************
+		 * The factor texture coordinates must be multiplied by before sampling.
+		 *
+		 * This is always (1, 1) with bindless textures. In fallback mode, it is the ratio between the size of the
+		 * texture and the size of a fallback layer.
+		 **************************************************************************************************************/
+		glm::vec2 uvScale;
+	};
+
+	/******************************************************************************************************************
+	 * Table of textures that shaders can sample by index, allowing a single draw to use thousands of textures.
+	 *
+	 * When bindless textures are supported, every texture added to the table is referenced through a resident 64-bit
+	 * handle stored in the table's shader buffer, so instances only need to carry their index into the table:
+	 *
+	 * @code
+	 * #extension GL_ARB_bindless_texture : require
+	 * layout(std430, binding = 0) readonly buffer Textures { TextureTableEntry textures[]; };
+	 * ...
+	 * TextureTableEntry entry = textures[instanceTexture];
+	 * color = texture(sampler2D(entry.handle), uv * entry.uvScale);
+	 * @endcode
+	 *
+	 * Otherwise, the table falls back to copying the textures into the layers of an ArrayColorTexture2D, which
+	 * must then be bound to a texture unit, and the first component of the handle holds the layer instead:
+	 *
+	 * @code
+	 * color = texture(fallbackTextures, vec3(uv * entry.uvScale, entry.handle.x));
+	 * @endcode
+	 *
+	 * Residency is managed by the table: handles are made resident when a texture is added and made non-resident
+	 * when it is removed or the table is destroyed. Since residency is global to a handle, a texture may be in several
+	 * tables at once, and it only stops being resident once no table holds it anymore.
+	 *
+	 * @note Once a texture is added to a table with bindless textures, its sampler parameters (filters, wrapping,
+	 *       etc.) can no longer be changed, so they should be set beforehand.
+	 *
+	 * TextureTable is non-copyable and movable.
+	 ******************************************************************************************************************/
+	class TextureTable {
+	  public:
+		/**************************************************************************************************************
+		 * Allocates a texture table.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception GraphicsBufferBadAlloc If allocating the shader buffer fails.
+		 * @exception TextureBadAlloc If allocating the fallback texture fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] capacity
+		 * @parblock
+		 * The maximum number of textures in the table.
+		 *
+		 * @pre @em capacity must be greater than 0.
+		 * @pre If bindless textures aren't supported, @em capacity must not exceed the maximum number of array
+		 *      texture layers of the context (at least 2048).
+		 * @endparblock
+		 * @param[in] fallbackLayerSize
+		 * @parblock
+		 * The size of a fallback layer, used if bindless textures aren't supported.
+		 *
+		 * @pre Both components of @em fallbackLayerSize must be greater than 0.
+		 * @endparblock
+		 * @param[in] fallbackFormat The internal format of the fallback texture.
+		 **************************************************************************************************************/
+		TextureTable(std::size_t capacity, glm::ivec2 fallbackLayerSize,
+					 ColorTextureFormat fallbackFormat = ColorTextureFormat::RGBA8);
+
+		TextureTable(TextureTable&&) noexcept = default;
+
+		/**************************************************************************************************************
+		 * Releases the residency of the handles of the table.
+		 **************************************************************************************************************/
+		~TextureTable() noexcept;
+
+		/**************************************************************************************************************
+		 * Releases the residency of the handles of the table, then moves another table into it.
+		 *
+		 * @param[in] r The table to move from.
+		 *
+		 * @return A reference to the table.
+		 **************************************************************************************************************/
+		TextureTable& operator=(TextureTable&& r) noexcept;
+
+		/**************************************************************************************************************
+		 * Gets whether the table uses bindless textures.
+		 *
+		 * @return True if the table uses bindless handles, false if it uses the fallback texture.
+		 **************************************************************************************************************/
+		bool bindless() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of textures in the table.
+		 *
+		 * @return The number of textures in the table.
+		 **************************************************************************************************************/
+		std::size_t size() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the maximum number of textures in the table.
+		 *
+		 * @return The capacity of the table.
+		 **************************************************************************************************************/
+		std::size_t capacity() const noexcept;
+
+		/**************************************************************************************************************
+		 * Adds a texture to the table.
+		 *
+		 * Adding a texture that is already in the table returns its existing index. In fallback mode, the base level
+		 * of the texture is copied into a layer of the fallback texture, so later changes to the texture are not
+		 * reflected in the table.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] texture
+		 * @parblock
+		 * The texture to add.
+		 *
+		 * @pre The table must not be full.
+		 * @pre The texture must outlive its entry in the table.
+		 * @pre In fallback mode, the texture must fit in a fallback layer and its format must be compatible with the
+		 *      fallback format.
+		 * @endparblock
+		 *
+		 * @return The index of the texture within the table.
+		 **************************************************************************************************************/
+		std::uint32_t add(const ColorTexture2D& texture);
+
+		/**************************************************************************************************************
+		 * Removes a texture from the table, making its handle non-resident unless another table still holds it.
+		 *
+		 * The index may be reused by later additions.
+		 *
+		 * @param[in] index
+		 * @parblock
+		 * The index of the texture.
+		 *
+		 * @pre @em index must be the index of a texture in the table.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void remove(std::uint32_t index) noexcept;
+
+		/**************************************************************************************************************
+		 * Uploads changes to the table to the GPU.
+		 *
+		 * This should be called after adding or removing textures and before drawing with the table.
+		 **************************************************************************************************************/
+		void update() noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the shader buffer containing the table entries.
+		 *
+		 * @return A reference to the shader buffer, which can be bound with Shader::setStorageBuffer().
+		 **************************************************************************************************************/
+		ShaderBuffer& buffer() noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the fallback texture.
+		 *
+		 * @pre The table must not be using bindless textures.
+		 *
+		 * @return A reference to the array texture holding the fallback layers.
+		 **************************************************************************************************************/
+		const ArrayColorTexture2D& fallbackTexture() const noexcept;
+
+	  private:
+		// Bookkeeping of a table index.
+		struct Slot {
+			unsigned int  texture; // The ID of the texture, or 0 if the slot is free.
+			std::uint64_t handle;  // The resident handle of the texture (bindless mode only).
+		};
+
+		ShaderBuffer                                    _buffer;    // The buffer holding the table entries.
+		std::optional<ArrayColorTexture2D>              _fallback;  // The fallback texture (fallback mode only).
+		std::vector<TextureTableEntry>                  _entries;   // CPU copy of the table entries.
+		std::vector<Slot>                               _slots;     // The textures occupying each index.
+		std::vector<std::uint32_t>                      _free;      // Freed indices available for reuse.
+		std::unordered_map<unsigned int, std::uint32_t> _indices;   // The indices of textures by ID.
+		bool                                            _dirty;     // Whether the entries need uploading.
+		bool                                            _mipsDirty; // Whether the fallback mipmaps are out of date.
+	};
+
+	/// @}
+} // namespace tr
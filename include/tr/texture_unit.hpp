@@ -2,6 +2,7 @@
 #include "handle.hpp"
 
 namespace tr {
+	class Sampler;
 	class Texture;
 
 	/** @ingroup graphics
@@ -21,7 +22,8 @@ namespace tr {
 		/**************************************************************************************************************
 		 * Constructs a new texture unit.
 		 *
-		 * No more than 80 texture units can exist simultaneously.
+		 * No more than 80 texture units can exist simultaneously. Units are taken from a free list in constant time,
+		 * starting with the lowest ones.
 		 **************************************************************************************************************/
 		TextureUnit() noexcept;
 
@@ -34,6 +36,20 @@ namespace tr {
 		 **************************************************************************************************************/
 		void setTexture(const Texture& texture) noexcept;
 
+		/**************************************************************************************************************
+		 * Binds a sampler to the texture unit.
+		 *
+		 * While a sampler is bound, its state is used instead of the sampling parameters of the bound texture.
+		 *
+		 * @param[in] sampler The sampler to bind.
+		 **************************************************************************************************************/
+		void setSampler(const Sampler& sampler) noexcept;
+
+		/**************************************************************************************************************
+		 * Unbinds the sampler of the texture unit, reverting to the sampling parameters of the bound texture.
+		 **************************************************************************************************************/
+		void clearSampler() noexcept;
+
 	  private:
 		struct Deleter {
 			void operator()(unsigned int id) noexcept;
@@ -42,6 +58,59 @@ namespace tr {
 		Handle<unsigned int, -1U, Deleter> _id;
 
 		friend class Shader;
+		friend class TextureBinder;
+	};
+
+	/******************************************************************************************************************
+	 * Batches texture bindings so that they can be issued together before a draw.
+	 *
+	 * Bindings set through the binder are only recorded until flush() is called, at which point units that already
+	 * hold the right texture are skipped and the remaining ones are bound with a single glBindTextures call per
+	 * contiguous range of units. Units in the middle of a range whose texture doesn't change are rebound to the same
+	 * texture, which is cheaper than splitting the call.
+	 *
+	 * @code
+	 * binder.set(albedoUnit, material.albedo);
+	 * binder.set(normalUnit, material.normal);
+	 * binder.set(roughnessUnit, material.roughness);
+	 * binder.flush(); // One call at most, as units are allocated contiguously.
+	 * context.drawIndexed(...);
+	 * @endcode
+	 ******************************************************************************************************************/
+	class TextureBinder {
+	  public:
+		/**************************************************************************************************************
+		 * Constructs a binder with no pending bindings.
+		 **************************************************************************************************************/
+		TextureBinder() noexcept;
+
+		/**************************************************************************************************************
+		 * Records a texture binding.
+		 *
+		 * Setting the same unit again before flushing overrides the previous binding.
+		 *
+		 * @param[in] unit The texture unit to bind to.
+		 * @param[in] texture Any type of texture object.
+		 **************************************************************************************************************/
+		void set(const TextureUnit& unit, const Texture& texture) noexcept;
+
+		/**************************************************************************************************************
+		 * Issues the pending bindings and clears them.
+		 **************************************************************************************************************/
+		void flush() noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of glBindTextures calls issued by the binder.
+		 *
+		 * @return The number of calls issued since the binder was constructed.
+		 **************************************************************************************************************/
+		std::size_t calls() const noexcept;
+
+	  private:
+		std::array<unsigned int, 80> _pending; // The pending texture of each unit, or 0 if there is none.
+		int                          _first;   // The first unit with a pending binding.
+		int                          _last;    // The last unit with a pending binding.
+		std::size_t                  _calls;   // The number of glBindTextures calls issued.
 	};
 
 	/// @}
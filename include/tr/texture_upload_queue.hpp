@@ -0,0 +1,185 @@
+#pragma once
+#include "bitmap.hpp"
+#include "streaming_buffer.hpp"
+
+namespace tr {
+	class ColorTexture2D;
+
+	/** @ingroup graphics
+	 *  @defgroup texture_upload_queue Texture Upload Queue
+	 *  Staged texture uploads through pixel unpack buffers.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Staging memory for an image handed out by a texture upload queue.
+	 ******************************************************************************************************************/
+	struct TextureStagingRegion {
+		/**************************************************************************************************************
+		 * The mapped staging memory, which can be written to directly from any thread.
+		 **************************************************************************************************************/
+		std::span<std::byte> data;
+
+		/**************************************************************************************************************
+		 * The distance between rows of pixels in bytes.
+		 *
+		 * Rows are packed with an alignment of 4 bytes.
+		 **************************************************************************************************************/
+		int pitch;
+
+		/**************************************************************************************************************
+		 * The size of the image in pixels.
+		 **************************************************************************************************************/
+		glm::ivec2 size;
+
+		/**************************************************************************************************************
+		 * The format of the image pixels.
+		 **************************************************************************************************************/
+		BitmapFormat format;
+
+		/**************************************************************************************************************
+		 * The offset of the region within the staging buffer in bytes.
+		 **************************************************************************************************************/
+		std::size_t offset;
+	};
+
+	/******************************************************************************************************************
+	 * Queue of texture uploads staged through a persistently mapped pixel unpack buffer.
+	 *
+	 * ColorTexture2D::setRegion() uploads from client memory, which makes the driver either copy the image before
+	 * returning or stall until the transfer completes. Uploads through the queue are instead written into a
+	 * persistently mapped staging ring first, and the texture copy is sourced from the ring, letting the GPU perform
+	 * it asynchronously. As with StreamingBuffer, the staging memory of a frame is only reused once the GPU has passed
+	 * the fence placed by endFrame().
+	 *
+	 * Large images can be filled directly on worker threads to avoid an extra copy:
+	 *
+	 * @code
+	 * TextureStagingRegion region{queue.stage(frameSize, BitmapFormat::RGBA_8888)}; // On the GL thread.
+	 * decoder.decodeInto(region.data, region.pitch);                               // On any thread.
+	 * queue.submit(texture, {0, 0}, region);                                        // On the GL thread, once filled.
+	 * queue.endFrame();
+	 * @endcode
+	 *
+	 * TextureUploadQueue is non-copyable and movable.
+	 ******************************************************************************************************************/
+	class TextureUploadQueue {
+	  public:
+		/**************************************************************************************************************
+		 * Allocates and maps a texture upload queue.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception GraphicsBufferBadAlloc If allocating the staging buffer fails.
+		 * @exception GraphicsBufferMapBadAlloc If mapping the staging buffer fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] capacity
+		 * @parblock
+		 * The capacity of the staging ring in bytes.
+		 *
+		 * @pre @em capacity must be greater than 0.
+		 * @endparblock
+		 * @param[in] framesInFlight
+		 * @parblock
+		 * The maximum number of frames that may be in flight at once.
+		 *
+		 * @pre @em framesInFlight must be greater than 0.
+		 * @endparblock
+		 **************************************************************************************************************/
+		explicit TextureUploadQueue(std::size_t capacity,
+									std::size_t framesInFlight = StreamingBuffer::DEFAULT_FRAMES_IN_FLIGHT);
+
+		/**************************************************************************************************************
+		 * Gets the capacity of the staging ring.
+		 *
+		 * @return The capacity of the staging ring in bytes.
+		 **************************************************************************************************************/
+		std::size_t capacity() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of bytes staged since the last call to endFrame().
+		 *
+		 * @return The number of bytes staged during the current frame, including alignment padding.
+		 **************************************************************************************************************/
+		std::size_t frameSize() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of times staging had to wait for the GPU to release memory.
+		 *
+		 * @return The number of stalls since the queue was created.
+		 **************************************************************************************************************/
+		std::size_t stalls() const noexcept;
+
+		/**************************************************************************************************************
+		 * Allocates staging memory for an image.
+		 *
+		 * The returned memory may be filled from any thread, but the region must be submitted in the same frame.
+		 *
+		 * @param[in] size
+		 * @parblock
+		 * The size of the image in pixels.
+		 *
+		 * @pre Both components of @em size must be greater than 0.
+		 * @pre The image must fit in the staging ring alongside the other frames in flight.
+		 * @endparblock
+		 * @param[in] format The format of the image pixels.
+		 *
+		 * @return The staging region.
+		 **************************************************************************************************************/
+		TextureStagingRegion stage(glm::ivec2 size, BitmapFormat format) noexcept;
+
+		/**************************************************************************************************************
+		 * Copies a filled staging region into a texture.
+		 *
+		 * @param[out] texture The texture to copy the image into.
+		 * @param[in] tl The top-left corner of the destination region within the texture.
+		 * @param[in] region
+		 * @parblock
+		 * The staging region to copy from.
+		 *
+		 * @pre @em region must have been staged by this queue during the current frame, and all writes to it must
+		 *      have finished.
+		 * @pre The image must fit within the texture at @em tl.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void submit(ColorTexture2D& texture, glm::ivec2 tl, const TextureStagingRegion& region) noexcept;
+
+		/**************************************************************************************************************
+		 * Uploads a bitmap into a texture through the staging ring.
+		 *
+		 * This is equivalent to staging the bitmap, copying it into the staging memory and submitting it.
+		 *
+		 * @param[out] texture The texture to copy the image into.
+		 * @param[in] tl The top-left corner of the destination region within the texture.
+		 * @param[in] bitmap
+		 * @parblock
+		 * The bitmap to upload.
+		 *
+		 * @pre The bitmap must fit within the texture at @em tl.
+		 * @endparblock
+		 **************************************************************************************************************/
+		void upload(ColorTexture2D& texture, glm::ivec2 tl, SubBitmap bitmap) noexcept;
+
+		/**************************************************************************************************************
+		 * Ends the current frame, placing a fence after the copies that use its staging memory.
+		 *
+		 * This should be called after all regions staged during the frame have been submitted.
+		 **************************************************************************************************************/
+		void endFrame() noexcept;
+
+		/**************************************************************************************************************
+		 * Sets the debug label of the staging buffer.
+		 *
+		 * @param[in] label The new label of the buffer.
+		 **************************************************************************************************************/
+		void setLabel(std::string_view label) noexcept;
+
+	  private:
+		StreamingBuffer _ring; // The staging ring.
+	};
+
+	/// @}
+} // namespace tr
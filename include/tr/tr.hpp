@@ -1,8 +1,11 @@
 #pragma once
 #include "angle.hpp"             // IWYU pragma: export
+#include "asset_archive.hpp"     // IWYU pragma: export
+#include "asset_loader.hpp"      // IWYU pragma: export
 #include "audio_buffer.hpp"      // IWYU pragma: export
 #include "audio_source.hpp"      // IWYU pragma: export
 #include "audio_system.hpp"      // IWYU pragma: export
+#include "batch_renderer.hpp"    // IWYU pragma: export
 #include "benchmark.hpp"         // IWYU pragma: export
 #include "bitmap.hpp"            // IWYU pragma: export
 #include "bitmap_format.hpp"     // IWYU pragma: export
@@ -10,34 +13,51 @@
 #include "chrono.hpp"            // IWYU pragma: export
 #include "color.hpp"             // IWYU pragma: export
 #include "color_cast.hpp"        // IWYU pragma: export
+#include "command_buffer.hpp"    // IWYU pragma: export
 #include "concepts.hpp"          // IWYU pragma: export
 #include "display.hpp"           // IWYU pragma: export
 #include "draw_geometry.hpp"     // IWYU pragma: export
 #include "event.hpp"             // IWYU pragma: export
 #include "framebuffer.hpp"       // IWYU pragma: export
+#include "framebuffer_readback.hpp" // IWYU pragma: export
 #include "geometry.hpp"          // IWYU pragma: export
+#include "glyph_cache.hpp"       // IWYU pragma: export
+#include "gpu_benchmark.hpp"     // IWYU pragma: export
 #include "graphics_context.hpp"  // IWYU pragma: export
 #include "handle.hpp"            // IWYU pragma: export
 #include "hashmap.hpp"           // IWYU pragma: export
 #include "index_buffer.hpp"      // IWYU pragma: export
+#include "indirect_buffer.hpp"   // IWYU pragma: export
 #include "iostream.hpp"          // IWYU pragma: export
 #include "keyboard.hpp"          // IWYU pragma: export
 #include "listener.hpp"          // IWYU pragma: export
+#include "mip_chain.hpp"         // IWYU pragma: export
 #include "mouse.hpp"             // IWYU pragma: export
 #include "norm_cast.hpp"         // IWYU pragma: export
 #include "overloaded_lambda.hpp" // IWYU pragma: export
 #include "path.hpp"              // IWYU pragma: export
+#include "pipeline_state.hpp"    // IWYU pragma: export
+#include "profiler.hpp"          // IWYU pragma: export
 #include "ranges.hpp"            // IWYU pragma: export
 #include "rng.hpp"               // IWYU pragma: export
+#include "sampler.hpp"           // IWYU pragma: export
 #include "sdl.hpp"               // IWYU pragma: export
 #include "shader.hpp"            // IWYU pragma: export
 #include "shader_buffer.hpp"     // IWYU pragma: export
 #include "shader_pipeline.hpp"   // IWYU pragma: export
+#include "shader_variant_cache.hpp" // IWYU pragma: export
 #include "stopwatch.hpp"         // IWYU pragma: export
+#include "streaming_buffer.hpp"  // IWYU pragma: export
 #include "texture.hpp"           // IWYU pragma: export
+#include "texture_atlas.hpp"     // IWYU pragma: export
+#include "texture_compression.hpp" // IWYU pragma: export
+#include "texture_table.hpp"     // IWYU pragma: export
 #include "texture_unit.hpp"      // IWYU pragma: export
+#include "texture_upload_queue.hpp" // IWYU pragma: export
 #include "timer.hpp"             // IWYU pragma: export
 #include "ttfont.hpp"            // IWYU pragma: export
+#include "uniform_block.hpp"     // IWYU pragma: export
+#include "uniform_buffer.hpp"    // IWYU pragma: export
 #include "utf8.hpp"              // IWYU pragma: export
 #include "vertex.hpp"            // IWYU pragma: export
 #include "vertex_buffer.hpp"     // IWYU pragma: export
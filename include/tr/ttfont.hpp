@@ -308,6 +308,32 @@ namespace tr {
 		 **************************************************************************************************************/
 		Glyph glyph(std::uint32_t glyph) const noexcept;
 
+		/**************************************************************************************************************
+		 * Gets the kerning offset between two glyphs.
+		 *
+		 * The offset is returned regardless of whether kerning is enabled.
+		 *
+		 * @param[in] left The glyph on the left. The glyph must be contained in the font.
+		 * @param[in] right The glyph on the right. The glyph must be contained in the font.
+		 *
+		 * @return The horizontal offset to apply to @em right in pixels.
+		 **************************************************************************************************************/
+		int kerning(std::uint32_t left, std::uint32_t right) const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the point size of the font.
+		 *
+		 * @return The point size of the font.
+		 **************************************************************************************************************/
+		int size() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the DPI of the font.
+		 *
+		 * @return The DPI of the font.
+		 **************************************************************************************************************/
+		glm::uvec2 dpi() const noexcept;
+
 		/**************************************************************************************************************
 		 * Resizes the font.
 		 *
@@ -0,0 +1,206 @@
+#pragma once
+#include "concepts.hpp"
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup uniform_block Uniform Block Layout
+	 *  Compile-time std140/std430 layout computation and validation.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * GLSL interface block memory layouts.
+	 ******************************************************************************************************************/
+	enum class BlockLayout {
+		/**************************************************************************************************************
+		 * The std140 layout, used by uniform blocks. Arrays and structures are aligned to 16 bytes.
+		 **************************************************************************************************************/
+		STD140,
+
+		/**************************************************************************************************************
+		 * The std430 layout, usable by shader storage blocks. Arrays and structures use their natural alignment.
+		 **************************************************************************************************************/
+		STD430
+	};
+
+	/******************************************************************************************************************
+	 * Tag type describing a nested structure member of a block.
+	 *
+	 * The structure is laid out with the rules of the enclosing block.
+	 *
+	 * @tparam Members The types of the members of the structure, in declaration order.
+	 ******************************************************************************************************************/
+	template <class... Members> struct BlockStruct {};
+
+	/******************************************************************************************************************
+	 * Layout traits of a block member type.
+	 *
+	 * Specializations provide the alignment and size of the member in the given layout through the static members
+	 * ALIGNMENT and SIZE. Specializations are provided for float, std::int32_t, std::uint32_t, double, glm vectors
+	 * and matrices of those types, std::array of supported types and BlockStruct.
+	 *
+	 * @note bool is not supported, as its size in C++ doesn't match the 4 bytes of a GLSL bool; use std::uint32_t.
+	 *
+	 * @tparam T The member type.
+	 * @tparam Layout The block layout.
+	 ******************************************************************************************************************/
+	template <class T, BlockLayout Layout> struct BlockMemberTraits {};
+
+	/******************************************************************************************************************
+	 * Concept denoting a type that can be a member of a block with the given layout.
+	 ******************************************************************************************************************/
+	template <class T, BlockLayout Layout>
+	concept BlockMember = requires {
+		{ BlockMemberTraits<T, Layout>::ALIGNMENT } -> std::convertible_to<std::size_t>;
+		{ BlockMemberTraits<T, Layout>::SIZE } -> std::convertible_to<std::size_t>;
+	};
+
+	/// @cond IMPLEMENTATION
+	// Rounds a value up to a multiple of an alignment.
+	consteval std::size_t blockAlignUp(std::size_t value, std::size_t alignment) noexcept
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// Alignment of arrays and structures: std140 rounds it up to the alignment of a vec4.
+	template <BlockLayout Layout> consteval std::size_t blockAggregateAlignment(std::size_t alignment) noexcept
+	{
+		return Layout == BlockLayout::STD140 ? blockAlignUp(alignment, 16) : alignment;
+	}
+
+	// Computes the offsets of a sequence of members.
+	template <BlockLayout Layout, class... Members>
+	consteval std::array<std::size_t, sizeof...(Members)> blockMemberOffsets() noexcept
+	{
+		const std::array<std::size_t, sizeof...(Members)> alignments{BlockMemberTraits<Members, Layout>::ALIGNMENT...};
+		const std::array<std::size_t, sizeof...(Members)> sizes{BlockMemberTraits<Members, Layout>::SIZE...};
+		std::array<std::size_t, sizeof...(Members)>       offsets{};
+		std::size_t                                       offset{0};
+		for (std::size_t i = 0; i < sizeof...(Members); ++i) {
+			offsets[i] = blockAlignUp(offset, alignments[i]);
+			offset = offsets[i] + sizes[i];
+		}
+		return offsets;
+	}
+	/// @endcond
+
+	/******************************************************************************************************************
+	 * Compile-time layout of a GLSL interface block.
+	 *
+	 * Since C++ cannot reflect over the members of a structure, the member types are listed explicitly, in
+	 * declaration order. The computed offsets can then be checked against the C++ structure mirroring the block with
+	 * matches(), which catches missing or misplaced padding at compile time:
+	 *
+	 * @code
+	 * struct ObjectUniforms {
+	 *     glm::mat4  transform;
+	 *     glm::vec3  tint;
+	 *     float      alpha;
+	 *     glm::vec2  uvOffset;
+	 *     glm::vec2  padding;
+	 * };
+	 * static_assert(tr::UniformBlockLayout<tr::BlockLayout::STD140, glm::mat4, glm::vec3, float, glm::vec2>::matches<
+	 *     ObjectUniforms>({offsetof(ObjectUniforms, transform), offsetof(ObjectUniforms, tint),
+	 *                      offsetof(ObjectUniforms, alpha), offsetof(ObjectUniforms, uvOffset)}));
+	 * @endcode
+	 *
+	 * @note glm::mat3 and glm::mat2 are tightly packed and thus never match the std140 layout (or, for mat3, the
+	 * std430 layout) of their GLSL counterparts; use glm::mat3x4 or glm::mat2x4 in the C++ structure and list those
+	 * here.
+	 *
+	 * @tparam Layout The layout of the block.
+	 * @tparam Members The types of the members of the block, in declaration order.
+	 ******************************************************************************************************************/
+	template <BlockLayout Layout, BlockMember<Layout>... Members> struct UniformBlockLayout {
+		/**************************************************************************************************************
+		 * The byte offsets of the members within the block.
+		 **************************************************************************************************************/
+		static constexpr std::array<std::size_t, sizeof...(Members)> OFFSETS{
+			blockMemberOffsets<Layout, Members...>()};
+
+		/**************************************************************************************************************
+		 * The base alignment of the block, as used when it is nested through BlockStruct.
+		 **************************************************************************************************************/
+		static constexpr std::size_t ALIGNMENT{BlockMemberTraits<BlockStruct<Members...>, Layout>::ALIGNMENT};
+
+		/**************************************************************************************************************
+		 * The size of the block in bytes, including trailing padding.
+		 **************************************************************************************************************/
+		static constexpr std::size_t SIZE{BlockMemberTraits<BlockStruct<Members...>, Layout>::SIZE};
+
+		/**************************************************************************************************************
+		 * Checks whether a C++ structure matches the layout of the block.
+		 *
+		 * The structure must be standard layout and trivially copyable, have members at the offsets of the block and
+		 * have the same size as the block (add explicit trailing padding if needed).
+		 *
+		 * @tparam Struct The C++ structure.
+		 *
+		 * @param[in] offsets The offsets of the members of the structure, as obtained by offsetof.
+		 *
+		 * @return True if the structure can be copied into the block directly.
+		 **************************************************************************************************************/
+		template <class Struct>
+		static consteval bool matches(const std::array<std::size_t, sizeof...(Members)>& offsets) noexcept;
+	};
+
+	/// @}
+} // namespace tr
+
+/// @cond IMPLEMENTATION
+
+namespace tr {
+	template <class T, BlockLayout Layout>
+		requires(std::same_as<T, float> || std::same_as<T, std::int32_t> || std::same_as<T, std::uint32_t> ||
+				 std::same_as<T, double>)
+	struct BlockMemberTraits<T, Layout> {
+		static constexpr std::size_t ALIGNMENT{sizeof(T)};
+		static constexpr std::size_t SIZE{sizeof(T)};
+	};
+
+	template <glm::length_t L, class T, glm::qualifier Q, BlockLayout Layout>
+		requires(BlockMember<T, Layout> && L >= 2 && L <= 4)
+	struct BlockMemberTraits<glm::vec<L, T, Q>, Layout> {
+		// vec3 is aligned like a vec4.
+		static constexpr std::size_t ALIGNMENT{(L == 2 ? 2 : 4) * sizeof(T)};
+		static constexpr std::size_t SIZE{L * sizeof(T)};
+	};
+
+	template <class T, std::size_t S, BlockLayout Layout>
+		requires(BlockMember<T, Layout> && S > 0)
+	struct BlockMemberTraits<std::array<T, S>, Layout> {
+		static constexpr std::size_t ALIGNMENT{
+			blockAggregateAlignment<Layout>(BlockMemberTraits<T, Layout>::ALIGNMENT)};
+		// The stride of the array.
+		static constexpr std::size_t STRIDE{blockAlignUp(BlockMemberTraits<T, Layout>::SIZE, ALIGNMENT)};
+		static constexpr std::size_t SIZE{STRIDE * S};
+	};
+
+	// Matrices are laid out as arrays of column vectors.
+	template <glm::length_t C, glm::length_t R, class T, glm::qualifier Q, BlockLayout Layout>
+		requires(std::same_as<T, float> || std::same_as<T, double>)
+	struct BlockMemberTraits<glm::mat<C, R, T, Q>, Layout>
+		: BlockMemberTraits<std::array<glm::vec<R, T, Q>, C>, Layout> {};
+
+	template <class... Members, BlockLayout Layout>
+		requires(sizeof...(Members) > 0 && (BlockMember<Members, Layout> && ...))
+	struct BlockMemberTraits<BlockStruct<Members...>, Layout> {
+		static constexpr std::size_t ALIGNMENT{
+			blockAggregateAlignment<Layout>(std::max({BlockMemberTraits<Members, Layout>::ALIGNMENT...}))};
+		static constexpr std::size_t SIZE{blockAlignUp(
+			blockMemberOffsets<Layout, Members...>().back() +
+				std::get<sizeof...(Members) - 1>(std::array{BlockMemberTraits<Members, Layout>::SIZE...}),
+			ALIGNMENT)};
+	};
+} // namespace tr
+
+template <tr::BlockLayout Layout, tr::BlockMember<Layout>... Members>
+template <class Struct>
+consteval bool tr::UniformBlockLayout<Layout, Members...>::matches(
+	const std::array<std::size_t, sizeof...(Members)>& offsets) noexcept
+{
+	return std::is_standard_layout_v<Struct> && std::is_trivially_copyable_v<Struct> && sizeof(Struct) == SIZE &&
+		   offsets == OFFSETS;
+}
+
+/// @endcond
@@ -0,0 +1,196 @@
+#pragma once
+#include "streaming_buffer.hpp"
+#include "uniform_block.hpp"
+
+namespace tr {
+	/** @ingroup graphics
+	 *  @defgroup uniform_buffer Uniform Buffer
+	 *  Frame-batched ring uniform buffer.
+	 *  @{
+	 */
+
+	/******************************************************************************************************************
+	 * Handle to a uniform block pushed into a uniform buffer.
+	 ******************************************************************************************************************/
+	struct UniformBufferBlock {
+		/**************************************************************************************************************
+		 * The offset of the block within the frame's staged data in bytes.
+		 **************************************************************************************************************/
+		std::size_t offset;
+
+		/**************************************************************************************************************
+		 * The size of the block in bytes.
+		 **************************************************************************************************************/
+		std::size_t size;
+	};
+
+	/******************************************************************************************************************
+	 * Ring-allocated uniform buffer that batches the uniform blocks of a frame into a single upload.
+	 *
+	 * Blocks pushed during a frame are staged in CPU memory at the uniform buffer offset alignment of the context.
+	 * upload() then copies all of them into a persistently mapped streaming ring in one allocation, after which each
+	 * block can be bound to a uniform block binding with Shader::setUniformBlock() before the draw using it. This
+	 * replaces per-value glProgramUniform* calls with one memcpy per frame and one ranged bind per draw.
+	 *
+	 * A typical frame looks as follows:
+	 *
+	 * @code
+	 * for (Object& object : objects) {
+	 *     object.uniforms = uniformBuffer.push(object.uniformData());
+	 * }
+	 * uniformBuffer.upload();
+	 * for (Object& object : objects) {
+	 *     shader.setUniformBlock(0, uniformBuffer, object.uniforms);
+	 *     context.drawIndexed(...);
+	 * }
+	 * uniformBuffer.endFrame();
+	 * @endcode
+	 *
+	 * UniformBuffer is non-copyable and movable.
+	 ******************************************************************************************************************/
+	class UniformBuffer {
+	  public:
+		/**************************************************************************************************************
+		 * Allocates and maps a uniform buffer.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception GraphicsBufferBadAlloc If allocating the buffer fails.
+		 * @exception GraphicsBufferMapBadAlloc If mapping the buffer fails.
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] capacity
+		 * @parblock
+		 * The capacity of the ring in bytes.
+		 *
+		 * @pre @em capacity must be greater than 0.
+		 * @endparblock
+		 * @param[in] framesInFlight
+		 * @parblock
+		 * The maximum number of frames that may be in flight at once.
+		 *
+		 * @pre @em framesInFlight must be greater than 0.
+		 * @endparblock
+		 **************************************************************************************************************/
+		explicit UniformBuffer(std::size_t capacity,
+							   std::size_t framesInFlight = StreamingBuffer::DEFAULT_FRAMES_IN_FLIGHT);
+
+		/**************************************************************************************************************
+		 * Gets the capacity of the ring.
+		 *
+		 * @return The capacity of the ring in bytes.
+		 **************************************************************************************************************/
+		std::size_t capacity() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the alignment blocks are staged at.
+		 *
+		 * @return The uniform buffer offset alignment of the context in bytes.
+		 **************************************************************************************************************/
+		std::size_t alignment() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of bytes staged during the current frame.
+		 *
+		 * @return The number of staged bytes, including alignment padding.
+		 **************************************************************************************************************/
+		std::size_t stagedSize() const noexcept;
+
+		/**************************************************************************************************************
+		 * Gets the number of times uploading had to wait for the GPU to release memory.
+		 *
+		 * @return The number of stalls since the buffer was created.
+		 **************************************************************************************************************/
+		std::size_t stalls() const noexcept;
+
+		/**************************************************************************************************************
+		 * Stages a uniform block.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @param[in] data
+		 * @parblock
+		 * The contents of the block.
+		 *
+		 * @pre @em data cannot be empty.
+		 * @pre upload() must not have been called since the last call to endFrame().
+		 * @endparblock
+		 *
+		 * @return A handle to the block, which can be bound once upload() has been called.
+		 **************************************************************************************************************/
+		UniformBufferBlock push(std::span<const std::byte> data);
+
+		/**************************************************************************************************************
+		 * Stages a uniform block.
+		 *
+		 * @par Exception Safety
+		 *
+		 * Strong exception guarantee.
+		 *
+		 * @exception std::bad_alloc If an internal allocation fails.
+		 *
+		 * @tparam T A standard layout type matching the layout of the block (see UniformBlockLayout).
+		 *
+		 * @param[in] block
+		 * @parblock
+		 * The contents of the block.
+		 *
+		 * @pre upload() must not have been called since the last call to endFrame().
+		 * @endparblock
+		 *
+		 * @return A handle to the block, which can be bound once upload() has been called.
+		 **************************************************************************************************************/
+		template <StandardLayout T> UniformBufferBlock push(const T& block);
+
+		/**************************************************************************************************************
+		 * Copies all blocks staged during the current frame into the ring.
+		 *
+		 * @pre The staged data must fit in the ring alongside the other frames in flight.
+		 **************************************************************************************************************/
+		void upload() noexcept;
+
+		/**************************************************************************************************************
+		 * Ends the current frame, placing a fence after the commands that use its blocks and clearing the staged
+		 * data.
+		 *
+		 * This should be called after all draws using blocks of the frame have been issued.
+		 **************************************************************************************************************/
+		void endFrame() noexcept;
+
+		/**************************************************************************************************************
+		 * Sets the debug label of the buffer.
+		 *
+		 * @param[in] label The new label of the buffer.
+		 **************************************************************************************************************/
+		void setLabel(std::string_view label) noexcept;
+
+	  private:
+		StreamingBuffer        _ring;      // The ring the blocks are uploaded into.
+		std::vector<std::byte> _staging;   // The blocks staged during the current frame.
+		std::size_t            _alignment; // The uniform buffer offset alignment.
+		std::size_t            _base;      // The offset of the frame's upload within the ring.
+		bool                   _uploaded;  // Whether the current frame's blocks have been uploaded.
+
+		// Binds a block to a uniform block binding.
+		void bind(std::uint32_t index, UniformBufferBlock block) const noexcept;
+
+		friend class Shader;
+	};
+
+	/// @}
+} // namespace tr
+
+/// @cond IMPLEMENTATION
+
+template <tr::StandardLayout T> tr::UniformBufferBlock tr::UniformBuffer::push(const T& block)
+{
+	return push(asBytes(block));
+}
+
+/// @endcond
@@ -218,6 +218,7 @@ namespace tr {
 		void bind() const noexcept;
 
 		friend class GraphicsContext;
+		friend struct PipelineState;
 	};
 
 	/// @}
@@ -0,0 +1,260 @@
+#include "../include/tr/asset_archive.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tr {
+	// Header of an asset archive, as stored at its start.
+	struct AssetArchiveHeader {
+		std::array<char, 4> magic;   // The magic number identifying asset archives.
+		std::uint32_t       version; // The version of the archive format.
+		std::uint64_t       entries; // The number of index entries following the header.
+	};
+
+	// The magic number of asset archives.
+	inline constexpr std::array<char, 4> ASSET_ARCHIVE_MAGIC{'T', 'R', 'A', 'A'};
+	// The current version of the asset archive format.
+	inline constexpr std::uint32_t ASSET_ARCHIVE_VERSION{1};
+
+	// Maps a file into memory, returning its address and size.
+	std::pair<const std::byte*, std::size_t> mapFile(const std::filesystem::path& path);
+} // namespace tr
+
+std::pair<const std::byte*, std::size_t> tr::mapFile(const std::filesystem::path& path)
+{
+	if (!is_regular_file(path)) {
+		throw FileNotFound{path};
+	}
+
+#ifdef _WIN32
+	const HANDLE file{CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+								  FILE_ATTRIBUTE_NORMAL, nullptr)};
+	if (file == INVALID_HANDLE_VALUE) {
+		throw FileOpenError{path};
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		throw FileOpenError{path};
+	}
+	if (std::size_t(size.QuadPart) < sizeof(AssetArchiveHeader)) {
+		CloseHandle(file);
+		throw AssetArchiveError{path};
+	}
+	// The view keeps the mapping and the file alive on its own.
+	const HANDLE mapping{CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+	CloseHandle(file);
+	if (mapping == nullptr) {
+		throw FileOpenError{path};
+	}
+	const void* data{MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+	CloseHandle(mapping);
+	if (data == nullptr) {
+		throw FileOpenError{path};
+	}
+	return {static_cast<const std::byte*>(data), std::size_t(size.QuadPart)};
+#else
+	const int file{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+	if (file == -1) {
+		throw FileOpenError{path};
+	}
+	struct stat info;
+	if (fstat(file, &info) == -1) {
+		close(file);
+		throw FileOpenError{path};
+	}
+	if (std::size_t(info.st_size) < sizeof(AssetArchiveHeader)) {
+		close(file);
+		throw AssetArchiveError{path};
+	}
+	// The mapping stays valid after the file descriptor is closed.
+	void* data{mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_PRIVATE, file, 0)};
+	close(file);
+	if (data == MAP_FAILED) {
+		throw FileOpenError{path};
+	}
+	return {static_cast<const std::byte*>(data), std::size_t(info.st_size)};
+#endif
+}
+
+const char* tr::AssetArchiveError::what() const noexcept
+{
+	static std::string str;
+	str.clear();
+	format_to(back_inserter(str), "Invalid asset archive: {}", path());
+	return str.c_str();
+}
+
+void tr::AssetArchive::Unmapper::operator()(const std::byte* data) const noexcept
+{
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+#else
+	munmap(const_cast<std::byte*>(data), size);
+#endif
+}
+
+tr::AssetArchive::AssetArchive(const std::filesystem::path& path)
+{
+	const auto [data, size]{mapFile(path)};
+	_mapping = Handle<const std::byte*, nullptr, Unmapper>{data, Unmapper{size}};
+
+	AssetArchiveHeader header;
+	std::memcpy(&header, data, sizeof(header));
+	if (header.magic != ASSET_ARCHIVE_MAGIC || header.version != ASSET_ARCHIVE_VERSION ||
+		header.entries > (size - sizeof(AssetArchiveHeader)) / sizeof(Entry)) {
+		throw AssetArchiveError{path};
+	}
+	_index = {reinterpret_cast<const Entry*>(data + sizeof(AssetArchiveHeader)), std::size_t(header.entries)};
+
+	// Everything is validated up front so that lookups can't read outside of the mapping.
+	for (const Entry& entry : _index) {
+		if (entry.flags != 0 || entry.nameOffset > size || entry.nameLength > size - entry.nameOffset ||
+			entry.dataOffset > size || entry.dataSize > size - entry.dataOffset ||
+			entry.dataOffset % ASSET_ARCHIVE_ALIGNMENT != 0) {
+			throw AssetArchiveError{path};
+		}
+	}
+	const auto unordered{[this](const Entry& l, const Entry& r) { return entryName(l) >= entryName(r); }};
+	if (std::ranges::adjacent_find(_index, unordered) != _index.end()) {
+		throw AssetArchiveError{path};
+	}
+}
+
+std::size_t tr::AssetArchive::size() const noexcept
+{
+	return _index.size();
+}
+
+std::string_view tr::AssetArchive::name(std::size_t index) const noexcept
+{
+	assert(index < size());
+
+	return entryName(_index[index]);
+}
+
+std::span<const std::byte> tr::AssetArchive::data(std::size_t index) const noexcept
+{
+	assert(index < size());
+
+	return {_mapping.get() + _index[index].dataOffset, std::size_t(_index[index].dataSize)};
+}
+
+bool tr::AssetArchive::contains(std::string_view name) const noexcept
+{
+	return find(name) != _index.end();
+}
+
+std::span<const std::byte> tr::AssetArchive::operator[](std::string_view name) const noexcept
+{
+	const std::span<const Entry>::iterator it{find(name)};
+	assert(it != _index.end());
+
+	return data(std::size_t(it - _index.begin()));
+}
+
+std::string_view tr::AssetArchive::entryName(const Entry& entry) const noexcept
+{
+	return {reinterpret_cast<const char*>(_mapping.get() + entry.nameOffset), entry.nameLength};
+}
+
+std::span<const tr::AssetArchive::Entry>::iterator tr::AssetArchive::find(std::string_view name) const noexcept
+{
+	const auto projection{[this](const Entry& entry) { return entryName(entry); }};
+	const std::span<const Entry>::iterator it{std::ranges::lower_bound(_index, name, std::less{}, projection)};
+	return it != _index.end() && entryName(*it) == name ? it : _index.end();
+}
+
+std::size_t tr::AssetArchiveWriter::size() const noexcept
+{
+	return _sources.size();
+}
+
+void tr::AssetArchiveWriter::add(std::string name, std::span<const std::byte> data)
+{
+	assert(!_sources.contains(name));
+
+	_sources.emplace(std::move(name), Source{{data.begin(), data.end()}, {}, data.size()});
+}
+
+void tr::AssetArchiveWriter::addFile(std::string name, const std::filesystem::path& path)
+{
+	assert(!_sources.contains(name));
+
+	if (!is_regular_file(path)) {
+		throw FileNotFound{path};
+	}
+	_sources.emplace(std::move(name), Source{{}, path, file_size(path)});
+}
+
+void tr::AssetArchiveWriter::addDirectory(const std::filesystem::path& directory, std::string_view prefix)
+{
+	if (!is_directory(directory)) {
+		throw FileNotFound{directory};
+	}
+
+	for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator{directory}) {
+		if (entry.is_regular_file()) {
+			std::string name{prefix};
+			name += entry.path().lexically_relative(directory).generic_string();
+			addFile(std::move(name), entry.path());
+		}
+	}
+}
+
+void tr::AssetArchiveWriter::write(const std::filesystem::path& path) const
+{
+	// The archive is laid out as the header, the index, the names and finally the aligned asset data.
+	std::vector<AssetArchive::Entry> index;
+	index.reserve(_sources.size());
+	std::uint64_t offset{sizeof(AssetArchiveHeader) + _sources.size() * sizeof(AssetArchive::Entry)};
+	for (const auto& [name, source] : _sources) {
+		index.push_back({offset, static_cast<std::uint32_t>(name.size()), 0, 0, source.size});
+		offset += name.size();
+	}
+	for (AssetArchive::Entry& entry : index) {
+		offset = (offset + ASSET_ARCHIVE_ALIGNMENT - 1) / ASSET_ARCHIVE_ALIGNMENT * ASSET_ARCHIVE_ALIGNMENT;
+		entry.dataOffset = offset;
+		offset += entry.dataSize;
+	}
+
+	std::ofstream file{openFileW(path, std::ios::binary)};
+	writeBinary(file, AssetArchiveHeader{ASSET_ARCHIVE_MAGIC, ASSET_ARCHIVE_VERSION, index.size()});
+	if (!index.empty()) {
+		writeBinaryRange(file, index);
+	}
+	std::uint64_t position{sizeof(AssetArchiveHeader) + index.size() * sizeof(AssetArchive::Entry)};
+	for (const std::string& name : _sources | std::views::keys) {
+		file.write(name.data(), std::streamsize(name.size()));
+		position += name.size();
+	}
+
+	constexpr std::array<char, ASSET_ARCHIVE_ALIGNMENT> PADDING{};
+	std::size_t                                         i{0};
+	for (const Source& source : _sources | std::views::values) {
+		const AssetArchive::Entry& entry{index[i++]};
+		file.write(PADDING.data(), std::streamsize(entry.dataOffset - position));
+		// Inserting an empty stream buffer sets the failbit, so empty files are skipped.
+		if (!source.path.empty() && source.size != 0) {
+			std::ifstream        asset{openFileR(source.path, std::ios::binary)};
+			const std::streampos start{file.tellp()};
+			file << asset.rdbuf();
+			// A file that changed size since it was added would shift every following asset away from its index entry.
+			if (std::uint64_t(file.tellp() - start) != source.size) {
+				throw AssetArchiveError{path};
+			}
+		}
+		else {
+			file.write(reinterpret_cast<const char*>(source.data.data()), std::streamsize(source.data.size()));
+		}
+		position = entry.dataOffset + entry.dataSize;
+	}
+	// Closing flushes the buffered data, which throws if it can't be written (for example if the disk is full).
+	file.close();
+}
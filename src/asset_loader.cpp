@@ -0,0 +1,129 @@
+#include "../include/tr/asset_loader.hpp"
+#include <SDL2/SDL_image.h>
+
+tr::AssetLoader::AssetLoader(unsigned int threads)
+	: _running{0}, _stopping{false}
+{
+	// Initializing SDL_image isn't thread-safe, so it's done here instead of lazily by the workers.
+	IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+
+	if (threads == 0) {
+		threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+	_workers.reserve(threads);
+	try {
+		for (unsigned int i = 0; i < threads; ++i) {
+			_workers.emplace_back(&AssetLoader::work, this);
+		}
+	}
+	catch (...) {
+		stop();
+		throw;
+	}
+}
+
+tr::AssetLoader::~AssetLoader() noexcept
+{
+	stop();
+}
+
+unsigned int tr::AssetLoader::threads() const noexcept
+{
+	return static_cast<unsigned int>(_workers.size());
+}
+
+std::size_t tr::AssetLoader::pending() const noexcept
+{
+	std::lock_guard lock{_mutex};
+	return _tasks.size() + _running + _finalizers.size();
+}
+
+std::future<tr::Bitmap> tr::AssetLoader::loadBitmap(std::filesystem::path path)
+{
+	return submit([path = std::move(path)] { return loadBitmapFile(path); });
+}
+
+std::future<tr::ColorTexture2D> tr::AssetLoader::loadTexture(std::filesystem::path path, bool mipmapped,
+															 ColorTextureFormat format)
+{
+	return submit([path = std::move(path)] { return loadBitmapFile(path); },
+				  [=](Bitmap&& bitmap) { return ColorTexture2D{bitmap, mipmapped, format}; });
+}
+
+std::future<tr::AudioData> tr::AssetLoader::loadAudio(std::filesystem::path path)
+{
+	return submit([path = std::move(path)] { return decodeAudioFile(path); });
+}
+
+std::future<tr::AudioBuffer> tr::AssetLoader::loadAudioBuffer(std::filesystem::path path)
+{
+	return submit([path = std::move(path)] { return decodeAudioFile(path); },
+				  [](AudioData&& audio) { return AudioBuffer{audio.samples, audio.format, audio.frequency}; });
+}
+
+std::size_t tr::AssetLoader::finalize(Duration budget) noexcept
+{
+	const TimePoint start{Clock::now()};
+	std::size_t     finalized{0};
+	do {
+		Task task;
+		{
+			std::lock_guard lock{_mutex};
+			if (_finalizers.empty()) {
+				break;
+			}
+			task = std::move(_finalizers.front());
+			_finalizers.pop_front();
+		}
+		task();
+		++finalized;
+	} while (Clock::now() - start < budget);
+	return finalized;
+}
+
+void tr::AssetLoader::enqueue(Task task)
+{
+	{
+		std::lock_guard lock{_mutex};
+		_tasks.push_back(std::move(task));
+	}
+	_condition.notify_one();
+}
+
+void tr::AssetLoader::enqueueFinalizer(Task task)
+{
+	std::lock_guard lock{_mutex};
+	_finalizers.push_back(std::move(task));
+}
+
+void tr::AssetLoader::stop() noexcept
+{
+	{
+		std::lock_guard lock{_mutex};
+		_stopping = true;
+	}
+	_condition.notify_all();
+	for (std::thread& worker : _workers) {
+		worker.join();
+	}
+	_workers.clear();
+}
+
+void tr::AssetLoader::work() noexcept
+{
+	std::unique_lock lock{_mutex};
+	while (true) {
+		_condition.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+		if (_stopping) {
+			return;
+		}
+
+		Task task{std::move(_tasks.front())};
+		_tasks.pop_front();
+		++_running;
+		lock.unlock();
+		task();
+		lock.lock();
+		--_running;
+	}
+}
@@ -16,7 +16,7 @@ namespace tr {
 	sf_count_t embeddedAudioRead(void* ptr, sf_count_t count, void* user_data) noexcept;
 	sf_count_t embeddedAudioTell(void* user_data) noexcept;
 
-	AudioBuffer loadAudio(SNDFILE* file, const SF_INFO& info);
+	AudioData decodeAudio(SNDFILE* file, const SF_INFO& info);
 } // namespace tr
 
 sf_count_t tr::embeddedAudioSize(void* user_data) noexcept
@@ -58,9 +58,8 @@ sf_count_t tr::embeddedAudioTell(void* user_data) noexcept
 	return std::distance(file.file.begin(), file.pos);
 }
 
-tr::AudioBuffer tr::loadAudio(SNDFILE* file, const SF_INFO& info)
+tr::AudioData tr::decodeAudio(SNDFILE* file, const SF_INFO& info)
 {
-	AudioBuffer               buffer;
 	std::vector<std::int16_t> data(info.frames * info.channels);
 
 	if (info.format & (SF_FORMAT_OGG | SF_FORMAT_VORBIS | SF_FORMAT_FLOAT | SF_FORMAT_DOUBLE)) {
@@ -68,7 +67,7 @@ tr::AudioBuffer tr::loadAudio(SNDFILE* file, const SF_INFO& info)
 	}
 	sf_readf_short(file, data.data(), info.frames);
 
-	return AudioBuffer{data, info.channels == 2 ? AudioFormat::STEREO16 : AudioFormat::MONO16, info.samplerate};
+	return {std::move(data), info.channels == 2 ? AudioFormat::STEREO16 : AudioFormat::MONO16, info.samplerate};
 }
 
 tr::AudioBufferView::AudioBufferView(ALuint id) noexcept
@@ -141,7 +140,7 @@ void tr::AudioBuffer::set(std::span<const std::int16_t> data, AudioFormat format
 	AudioBufferView(*this).set(data, format, frequency);
 }
 
-tr::AudioBuffer tr::loadEmbeddedAudio(std::span<const std::byte> data)
+tr::AudioData tr::decodeEmbeddedAudio(std::span<const std::byte> data)
 {
 	EmbeddedAudioFile fp{data, data.begin()};
 	SF_VIRTUAL_IO     io{embeddedAudioSize, embeddedAudioSeek, embeddedAudioRead, nullptr, embeddedAudioTell};
@@ -150,10 +149,10 @@ tr::AudioBuffer tr::loadEmbeddedAudio(std::span<const std::byte> data)
 	std::unique_ptr<SNDFILE, decltype(&sf_close)> file{sf_open_virtual(&io, SFM_READ, &info, &fp), sf_close};
 	assert(file != nullptr);
 
-	return loadAudio(file.get(), info);
+	return decodeAudio(file.get(), info);
 }
 
-tr::AudioBuffer tr::loadAudioFile(const std::filesystem::path& path)
+tr::AudioData tr::decodeAudioFile(const std::filesystem::path& path)
 {
 	if (!is_regular_file(path)) {
 		throw FileNotFound{path};
@@ -173,5 +172,17 @@ tr::AudioBuffer tr::loadAudioFile(const std::filesystem::path& path)
 		throw UnsupportedAudioFile{path};
 	}
 
-	return loadAudio(file.get(), info);
-}
\ No newline at end of file
+	return decodeAudio(file.get(), info);
+}
+
+tr::AudioBuffer tr::loadEmbeddedAudio(std::span<const std::byte> data)
+{
+	const AudioData audio{decodeEmbeddedAudio(data)};
+	return AudioBuffer{audio.samples, audio.format, audio.frequency};
+}
+
+tr::AudioBuffer tr::loadAudioFile(const std::filesystem::path& path)
+{
+	const AudioData audio{decodeAudioFile(path)};
+	return AudioBuffer{audio.samples, audio.format, audio.frequency};
+}
@@ -0,0 +1,219 @@
+#include "../include/tr/batch_renderer.hpp"
+
+namespace tr {
+	// The maximum number of vertices addressable by a 16-bit index.
+	inline constexpr std::size_t MAX_BATCH_VERTICES{65536};
+
+	// Orders batch states by layer first, then by the state that is most expensive to change.
+	bool batchStateLess(const BatchState& l, const BatchState& r) noexcept;
+	// Gets whether two batch states can share a draw call, which ignores their layers.
+	bool batchStateCompatible(const BatchState& l, const BatchState& r) noexcept;
+} // namespace tr
+
+bool tr::batchStateLess(const BatchState& l, const BatchState& r) noexcept
+{
+	if (l.layer != r.layer) {
+		return l.layer < r.layer;
+	}
+	else if (l.pipeline != r.pipeline) {
+		return std::less<const void*>{}(l.pipeline, r.pipeline);
+	}
+	else if (l.texture != r.texture) {
+		return std::less<const void*>{}(l.texture, r.texture);
+	}
+	else {
+		const BlendMode& lb{l.blendMode};
+		const BlendMode& rb{r.blendMode};
+		return std::tie(lb.rgbSrc, lb.rgbFn, lb.rgbDst, lb.alphaSrc, lb.alphaFn, lb.alphaDst) <
+			   std::tie(rb.rgbSrc, rb.rgbFn, rb.rgbDst, rb.alphaSrc, rb.alphaFn, rb.alphaDst);
+	}
+}
+
+bool tr::batchStateCompatible(const BatchState& l, const BatchState& r) noexcept
+{
+	return l.pipeline == r.pipeline && l.texture == r.texture && l.blendMode == r.blendMode;
+}
+
+tr::BatchRenderer::BatchRenderer(std::size_t capacity)
+	: _buffer{capacity}, _drawCalls{0}, _stateChanges{0}
+{
+#ifndef NDEBUG
+	_buffer.setLabel("(tr) Batch Renderer Buffer");
+#endif
+}
+
+const tr::TextureUnit& tr::BatchRenderer::textureUnit() const noexcept
+{
+	return _textureUnit;
+}
+
+tr::BatchMesh tr::BatchRenderer::addMesh(const BatchState& state, std::size_t vertices, std::size_t indices)
+{
+	assert(vertices > 0 && vertices <= MAX_BATCH_VERTICES);
+	assert(indices % 3 == 0);
+
+	const std::size_t firstVertex{_vertices.size()};
+	const std::size_t firstIndex{_indices.size()};
+	_vertices.resize(firstVertex + vertices);
+	try {
+		_indices.resize(firstIndex + indices);
+		_meshes.push_back({state, static_cast<std::uint32_t>(firstVertex), static_cast<std::uint32_t>(vertices),
+						   static_cast<std::uint32_t>(firstIndex), static_cast<std::uint32_t>(indices)});
+	}
+	catch (...) {
+		_vertices.resize(firstVertex);
+		_indices.resize(firstIndex);
+		throw;
+	}
+	return {std::span{_vertices}.subspan(firstVertex), std::span{_indices}.subspan(firstIndex)};
+}
+
+void tr::BatchRenderer::addRect(const BatchState& state, const RectF2& rect, RGBA8 color)
+{
+	const BatchMesh mesh{addMesh(state, 4, 6)};
+	_positions.clear();
+	fillRectVertices(back_inserter(_positions), rect.tl, rect.size);
+	for (std::size_t i = 0; i < 4; ++i) {
+		mesh.vertices[i] = {_positions[i], {}, color};
+	}
+	fillPolygonIndices(mesh.indices.begin(), 4, 0);
+}
+
+void tr::BatchRenderer::addRectOutline(const BatchState& state, const RectF2& rect, float thickness, RGBA8 color)
+{
+	const BatchMesh mesh{addMesh(state, 8, 24)};
+	_positions.clear();
+	fillRectOutlineVertices(back_inserter(_positions), rect.tl, rect.size, thickness);
+	for (std::size_t i = 0; i < 8; ++i) {
+		mesh.vertices[i] = {_positions[i], {}, color};
+	}
+	fillPolygonOutlineIndices(mesh.indices.begin(), 4, 0);
+}
+
+void tr::BatchRenderer::addSprite(const BatchState& state, const RectF2& rect, const RectF2& uv, RGBA8 tint)
+{
+	const BatchMesh mesh{addMesh(state, 4, 6)};
+	_positions.clear();
+	fillRectVertices(back_inserter(_positions), rect.tl, rect.size);
+	fillRectVertices(back_inserter(_positions), uv.tl, uv.size);
+	for (std::size_t i = 0; i < 4; ++i) {
+		mesh.vertices[i] = {_positions[i], _positions[i + 4], tint};
+	}
+	fillPolygonIndices(mesh.indices.begin(), 4, 0);
+}
+
+void tr::BatchRenderer::addPolygon(const BatchState& state, std::size_t vertices, CircleF circle, AngleF rotation,
+								   RGBA8 color)
+{
+	assert(vertices >= 3 && vertices < MAX_BATCH_VERTICES);
+
+	const BatchMesh mesh{addMesh(state, vertices, (vertices - 2) * 3)};
+	_positions.clear();
+	fillPolygonVertices(back_inserter(_positions), vertices, circle, rotation);
+	for (std::size_t i = 0; i < vertices; ++i) {
+		mesh.vertices[i] = {_positions[i], {}, color};
+	}
+	fillPolygonIndices(mesh.indices.begin(), static_cast<std::uint16_t>(vertices), 0);
+}
+
+void tr::BatchRenderer::addPolygonOutline(const BatchState& state, std::size_t vertices, CircleF circle,
+										  AngleF rotation, float thickness, RGBA8 color)
+{
+	assert(vertices >= 3 && vertices <= MAX_BATCH_VERTICES / 2);
+
+	const BatchMesh mesh{addMesh(state, vertices * 2, vertices * 6)};
+	_positions.clear();
+	fillPolygonOutlineVertices(back_inserter(_positions), vertices, circle, rotation, thickness);
+	for (std::size_t i = 0; i < vertices * 2; ++i) {
+		mesh.vertices[i] = {_positions[i], {}, color};
+	}
+	fillPolygonOutlineIndices(mesh.indices.begin(), static_cast<std::uint16_t>(vertices), 0);
+}
+
+void tr::BatchRenderer::draw(GraphicsContext& context) noexcept
+{
+	_drawCalls    = 0;
+	_stateChanges = 0;
+	if (_meshes.empty()) {
+		return;
+	}
+
+	// Stable so that meshes with identical state keep their submission order.
+	std::ranges::stable_sort(_meshes, batchStateLess, &Mesh::state);
+
+	context.setVertexFormat(TintVtx2::vertexFormat());
+	context.setIndexBuffer(_buffer);
+	context.useBlending(true);
+
+	const BatchState* current{nullptr};
+	for (auto begin = _meshes.begin(); begin != _meshes.end();) {
+		std::size_t vertices{0};
+		std::size_t indices{0};
+		auto        end{begin};
+		// Layer order is already established by the sort, so runs may span layers.
+		for (; end != _meshes.end() && batchStateCompatible(end->state, begin->state) &&
+			   vertices + end->vertexCount <= MAX_BATCH_VERTICES;
+			 ++end) {
+			vertices += end->vertexCount;
+			indices += end->indexCount;
+		}
+
+		const StreamingBufferRange<TintVtx2>      vertexRange{_buffer.allocate<TintVtx2>(vertices)};
+		const StreamingBufferRange<std::uint16_t> indexRange{
+			indices != 0 ? _buffer.allocate<std::uint16_t>(indices) : StreamingBufferRange<std::uint16_t>{}};
+		auto vertexIt{vertexRange.data.begin()};
+		auto indexIt{indexRange.data.begin()};
+		for (auto it = begin; it != end; ++it) {
+			const std::uint16_t base{static_cast<std::uint16_t>(vertexIt - vertexRange.data.begin())};
+			vertexIt = std::ranges::copy_n(_vertices.begin() + it->firstVertex, it->vertexCount, vertexIt).out;
+			indexIt  = std::ranges::transform(_indices.begin() + it->firstIndex,
+											  _indices.begin() + it->firstIndex + it->indexCount, indexIt,
+											  [=](std::uint16_t index) -> std::uint16_t { return base + index; })
+						  .out;
+		}
+
+		const BatchState& state{begin->state};
+		if (current == nullptr || state.pipeline != current->pipeline) {
+			if (state.pipeline != nullptr) {
+				context.setShaderPipeline(*state.pipeline);
+			}
+			++_stateChanges;
+		}
+		if (state.texture != nullptr && (current == nullptr || state.texture != current->texture)) {
+			_textureUnit.setTexture(*state.texture);
+			++_stateChanges;
+		}
+		if (current == nullptr || state.blendMode != current->blendMode) {
+			context.setBlendingMode(state.blendMode);
+			++_stateChanges;
+		}
+		current = &state;
+
+		if (indices != 0) {
+			context.setVertexBuffer(_buffer, vertexRange.offset, sizeof(TintVtx2));
+			context.drawIndexed(Primitive::TRIS, indexRange.elementOffset(), indices);
+			++_drawCalls;
+		}
+		begin = end;
+	}
+	_buffer.endFrame();
+
+	clear();
+}
+
+void tr::BatchRenderer::clear() noexcept
+{
+	_meshes.clear();
+	_vertices.clear();
+	_indices.clear();
+}
+
+std::size_t tr::BatchRenderer::drawCalls() const noexcept
+{
+	return _drawCalls;
+}
+
+std::size_t tr::BatchRenderer::stateChanges() const noexcept
+{
+	return _stateChanges;
+}
@@ -1,6 +1,121 @@
 #include "../include/tr/benchmark.hpp"
+#include <atomic>
+#include <bit>
 
-using namespace std::chrono_literals;
+tr::Benchmark::Benchmark(Duration window, std::size_t capacity)
+	: _measurements(capacity)
+	, _first{0}
+	, _size{0}
+	, _dropped{0}
+	, _window{window}
+	, _sum{0}
+	, _minQueue{std::vector<std::uint32_t>(capacity), 0, 0}
+	, _maxQueue{std::vector<std::uint32_t>(capacity), 0, 0}
+	, _histogram{}
+{
+	assert(window > Duration{0});
+	assert(capacity > 0 && capacity <= std::numeric_limits<std::uint32_t>::max());
+}
+
+std::uint32_t tr::Benchmark::SlotQueue::front() const noexcept
+{
+	assert(size != 0);
+	return slots[first];
+}
+
+std::uint32_t tr::Benchmark::SlotQueue::back() const noexcept
+{
+	assert(size != 0);
+	return slots[(first + size - 1) % slots.size()];
+}
+
+void tr::Benchmark::SlotQueue::pushBack(std::uint32_t slot) noexcept
+{
+	assert(size < slots.size());
+	slots[(first + size++) % slots.size()] = slot;
+}
+
+void tr::Benchmark::SlotQueue::popFront() noexcept
+{
+	assert(size != 0);
+	first = (first + 1) % slots.size();
+	--size;
+}
+
+void tr::Benchmark::SlotQueue::popBack() noexcept
+{
+	assert(size != 0);
+	--size;
+}
+
+std::size_t tr::Benchmark::histogramBucket(Duration duration) noexcept
+{
+	const std::uint64_t ns{static_cast<std::uint64_t>(std::max(NanosecondsI{duration}.count(), std::int64_t{0}))};
+	if (ns < HISTOGRAM_SUB_BUCKETS) {
+		return ns;
+	}
+	// Buckets are linear within each power of two: [2^e, 2^(e+1)) is split into HISTOGRAM_SUB_BUCKETS parts.
+	const std::size_t   exponent{static_cast<std::size_t>(std::bit_width(ns) - 1)};
+	const std::uint64_t mantissa{(ns >> (exponent - 4)) & (HISTOGRAM_SUB_BUCKETS - 1)};
+	return std::min((exponent - 3) * HISTOGRAM_SUB_BUCKETS + mantissa, HISTOGRAM_BUCKETS - 1);
+}
+
+tr::Duration tr::Benchmark::histogramValue(std::size_t bucket) noexcept
+{
+	if (bucket < HISTOGRAM_SUB_BUCKETS) {
+		return std::chrono::duration_cast<Duration>(NanosecondsI(bucket));
+	}
+	const std::size_t   exponent{bucket / HISTOGRAM_SUB_BUCKETS + 3};
+	const std::uint64_t width{std::uint64_t{1} << (exponent - 4)};
+	const std::uint64_t low{(HISTOGRAM_SUB_BUCKETS + bucket % HISTOGRAM_SUB_BUCKETS) * width};
+	return std::chrono::duration_cast<Duration>(NanosecondsI(low + width / 2));
+}
+
+void tr::Benchmark::push(const Measurement& measurement) noexcept
+{
+	if (_size == _measurements.size()) {
+		++_dropped;
+		pop();
+	}
+
+	const std::uint32_t slot{static_cast<std::uint32_t>((_first + _size++) % _measurements.size())};
+	_measurements[slot] = measurement;
+	_sum += measurement.second;
+	++_histogram[histogramBucket(measurement.second)];
+
+	while (_minQueue.size != 0 && _measurements[_minQueue.back()].second > measurement.second) {
+		_minQueue.popBack();
+	}
+	_minQueue.pushBack(slot);
+	while (_maxQueue.size != 0 && _measurements[_maxQueue.back()].second < measurement.second) {
+		_maxQueue.popBack();
+	}
+	_maxQueue.pushBack(slot);
+}
+
+void tr::Benchmark::evictOutdated(TimePoint now) noexcept
+{
+	while (_size != 0 && _measurements[_first].first < now - _window) {
+		pop();
+	}
+}
+
+void tr::Benchmark::pop() noexcept
+{
+	assert(_size != 0);
+
+	const Measurement& oldest{_measurements[_first]};
+	_sum -= oldest.second;
+	--_histogram[histogramBucket(oldest.second)];
+	if (_minQueue.front() == _first) {
+		_minQueue.popFront();
+	}
+	if (_maxQueue.front() == _first) {
+		_maxQueue.popFront();
+	}
+	_first = (_first + 1) % _measurements.size();
+	--_size;
+}
 
 void tr::Benchmark::start() noexcept
 {
@@ -10,59 +125,118 @@ void tr::Benchmark::start() noexcept
 	atomic_thread_fence(std::memory_order::relaxed);
 }
 
-void tr::Benchmark::stop()
+void tr::Benchmark::stop() noexcept
 {
 	assert(_startPoint != TimePoint{});
 
 	atomic_thread_fence(std::memory_order::relaxed);
 	const TimePoint now{Clock::now()};
-	_durations.emplace_back(_startPoint, now - _startPoint);
-	const auto it{std::ranges::upper_bound(_durations, now - 2.5s, std::less{}, &Deque::value_type::first)};
-	if (it != _durations.end()) {
-		_durations.erase(_durations.begin(), it);
-	}
+	// Outdated measurements are evicted first so that push() only has to drop measurements still in the window.
+	evictOutdated(now);
+	push({_startPoint, now - _startPoint});
 	_startPoint = TimePoint{};
 	atomic_thread_fence(std::memory_order::relaxed);
 }
 
+void tr::Benchmark::add(Duration duration) noexcept
+{
+	const TimePoint now{Clock::now()};
+	evictOutdated(now);
+	push({now - duration, duration});
+}
+
 void tr::Benchmark::clear() noexcept
 {
-	_startPoint = TimePoint{};
-	_durations.clear();
+	_startPoint     = TimePoint{};
+	_first          = 0;
+	_size           = 0;
+	_dropped        = 0;
+	_sum            = Duration{0};
+	_minQueue.first = 0;
+	_minQueue.size  = 0;
+	_maxQueue.first = 0;
+	_maxQueue.size  = 0;
+	_histogram.fill(0);
+}
+
+tr::Duration tr::Benchmark::window() const noexcept
+{
+	return _window;
+}
+
+std::size_t tr::Benchmark::capacity() const noexcept
+{
+	return _measurements.size();
+}
+
+std::size_t tr::Benchmark::size() const noexcept
+{
+	return _size;
+}
+
+std::size_t tr::Benchmark::dropped() const noexcept
+{
+	return _dropped;
 }
 
 tr::Duration tr::Benchmark::latest() const noexcept
 {
-	return !_durations.empty() ? _durations.back().second : Duration{0};
+	return _size != 0 ? _measurements[(_first + _size - 1) % _measurements.size()].second : Duration{0};
 }
 
 tr::Duration tr::Benchmark::min() const noexcept
 {
-	return !_durations.empty() ? *std::ranges::min_element(std::views::values(_durations)) : Duration{0};
+	return _size != 0 ? _measurements[_minQueue.front()].second : Duration{0};
 }
 
 tr::Duration tr::Benchmark::max() const noexcept
 {
-	return !_durations.empty() ? *std::ranges::max_element(std::views::values(_durations)) : Duration{0};
+	return _size != 0 ? _measurements[_maxQueue.front()].second : Duration{0};
 }
 
 tr::Duration tr::Benchmark::average() const noexcept
 {
-	if (_durations.empty()) {
+	return _size != 0 ? _sum / static_cast<Duration::rep>(_size) : Duration{0};
+}
+
+tr::Duration tr::Benchmark::percentile(double fraction) const noexcept
+{
+	assert(fraction >= 0 && fraction <= 1);
+
+	if (_size == 0) {
 		return Duration{0};
 	}
-	else {
-		const auto durations{std::views::values(_durations)};
-		return std::accumulate(durations.begin(), durations.end(), Duration{0}) / _durations.size();
+
+	const std::size_t rank{std::clamp<std::size_t>(static_cast<std::size_t>(std::ceil(fraction * _size)), 1, _size)};
+	std::size_t       count{0};
+	for (std::size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+		count += _histogram[bucket];
+		if (count >= rank) {
+			// Clamping to the exact extremes keeps p0/p100 (and small samples) accurate.
+			return std::clamp(histogramValue(bucket), min(), max());
+		}
 	}
+	return max();
 }
 
 double tr::Benchmark::fps() const noexcept
 {
-	return !_durations.empty() ? _durations.size() / 2.5 : 0;
+	if (_size != _measurements.size() || _size < 2) {
+		return _size / SecondsD{_window}.count();
+	}
+
+	// A full buffer may span less than the window, and dividing by it would then cap the rate at capacity / window.
+	const Measurement& newest{_measurements[(_first + _size - 1) % _measurements.size()]};
+	const Duration     span{newest.first + newest.second - _measurements[_first].first};
+	return span > Duration{0} ? _size / SecondsD{std::min(span, _window)}.count() : _size / SecondsD{_window}.count();
 }
 
-const tr::Benchmark::Deque& tr::Benchmark::measurements() const noexcept
+std::vector<tr::Benchmark::Measurement> tr::Benchmark::measurements() const
 {
-	return _durations;
+	std::vector<Measurement> measurements;
+	measurements.reserve(_size);
+	for (std::size_t i = 0; i < _size; ++i) {
+		measurements.push_back(_measurements[(_first + i) % _measurements.size()]);
+	}
+	return measurements;
 }
@@ -0,0 +1,24 @@
+#pragma once
+#include "../include/tr/common.hpp"
+#include "gl_call.hpp"
+
+namespace tr {
+	// GL_ARB_bindless_texture entry points, which aren't part of the generated loader.
+	struct BindlessTextureFunctions {
+		GLuint64(APIENTRYP getTextureHandle)(GLuint texture);
+		void(APIENTRYP makeTextureHandleResident)(GLuint64 handle);
+		void(APIENTRYP makeTextureHandleNonResident)(GLuint64 handle);
+		// Residency is global to a handle, so it is reference counted across every user of the handle.
+		std::unordered_map<GLuint64, std::size_t> residentHandles;
+	};
+
+	// The bindless texture entry points of the current context, or std::nullopt if the extension isn't supported.
+	inline std::optional<BindlessTextureFunctions> _bindlessTexture;
+
+	// Loads the bindless texture entry points of the current context, if supported.
+	void loadBindlessTextureFunctions() noexcept;
+	// Adds a reference to the residency of a handle, making it resident if it wasn't already.
+	void acquireTextureHandle(GLuint64 handle);
+	// Removes a reference to the residency of a handle, making it non-resident if it was the last one.
+	void releaseTextureHandle(GLuint64 handle) noexcept;
+} // namespace tr
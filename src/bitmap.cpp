@@ -1,5 +1,6 @@
 #include "../include/tr/bitmap.hpp"
 #include "../include/tr/bitmap_iterators.hpp"
+#include "bitmap_conversion.hpp"
 #include "SDL2/SDL_image.h"
 #include <SDL2/SDL.h>
 
@@ -10,6 +11,17 @@
 namespace tr {
 	template <class T> T checkNotNull(T ptr);
 	void                 saveBitmap(SDL_Surface* bitmap, const std::filesystem::path& path);
+	// Converts a region of a surface using a specialized conversion kernel, copying the pixels without blending or
+	// modulation like SDL_ConvertSurface. Returns nullptr if there is no kernel for the conversion.
+	SDL_Surface* convertSurfaceRegion(SDL_Surface* surface, const RectI2& rect, BitmapFormat format);
+	// Converts a surface to another format.
+	SDL_Surface* convertSurface(SDL_Surface* surface, BitmapFormat format);
+	// Gets whether blitting from a surface is a plain copy (no blending, modulation, color keying or palette).
+	bool isCopyBlitSource(SDL_Surface* surface) noexcept;
+	// Copies rows of pixels of the same format.
+	template <class T> void copyRows(BitmapRows<const T> source, BitmapRows<T> destination) noexcept;
+	// Fills rows of pixels with a value.
+	template <class T> void fillRows(BitmapRows<T> rows, T value) noexcept;
 } // namespace tr
 
 template <class T> T tr::checkNotNull(T ptr)
@@ -33,6 +45,64 @@ void tr::saveBitmap(SDL_Surface* bitmap, const std::filesystem::path& path)
 	}
 }
 
+SDL_Surface* tr::convertSurfaceRegion(SDL_Surface* surface, const RectI2& rect, BitmapFormat format)
+{
+	assert(surface != nullptr);
+
+	const BitmapFormat sourceFormat{static_cast<BitmapFormat::Type>(surface->format->format)};
+	// Color keys and RLE acceleration need SDL's blitter to be handled correctly.
+	if (SDL_HasColorKey(surface) || SDL_MUSTLOCK(surface) || !hasConversionKernel(sourceFormat, format)) {
+		return nullptr;
+	}
+
+	const SDL_PixelFormatEnum sdlFormat{static_cast<SDL_PixelFormatEnum>(static_cast<BitmapFormat::Type>(format))};
+	SDL_Surface*              converted{
+		checkNotNull(SDL_CreateRGBSurfaceWithFormat(0, rect.size.x, rect.size.y, format.pixelBits(), sdlFormat))};
+	const std::byte*          source{static_cast<const std::byte*>(surface->pixels) + rect.tl.y * surface->pitch +
+							 rect.tl.x * sourceFormat.pixelBytes()};
+	convertPixels(source, surface->pitch, sourceFormat, static_cast<std::byte*>(converted->pixels), converted->pitch,
+				  format, rect.size);
+	return converted;
+}
+
+SDL_Surface* tr::convertSurface(SDL_Surface* surface, BitmapFormat format)
+{
+	SDL_Surface* converted{convertSurfaceRegion(surface, {{}, {surface->w, surface->h}}, format)};
+	if (converted == nullptr) {
+		const SDL_PixelFormatEnum sdlFormat{static_cast<SDL_PixelFormatEnum>(static_cast<BitmapFormat::Type>(format))};
+		converted = checkNotNull(SDL_ConvertSurfaceFormat(surface, sdlFormat, 0));
+	}
+	return converted;
+}
+
+bool tr::isCopyBlitSource(SDL_Surface* surface) noexcept
+{
+	const std::uint32_t format{surface->format->format};
+	SDL_BlendMode       blendMode;
+	std::uint8_t        r, g, b, a;
+	SDL_GetSurfaceBlendMode(surface, &blendMode);
+	SDL_GetSurfaceColorMod(surface, &r, &g, &b);
+	SDL_GetSurfaceAlphaMod(surface, &a);
+	return !SDL_HasColorKey(surface) && !SDL_MUSTLOCK(surface) && !SDL_ISPIXELFORMAT_INDEXED(format) &&
+		   SDL_BITSPERPIXEL(format) % 8 == 0 && (r & g & b & a) == 255 &&
+		   (blendMode == SDL_BLENDMODE_NONE || !SDL_ISPIXELFORMAT_ALPHA(format));
+}
+
+template <class T> void tr::copyRows(BitmapRows<const T> source, BitmapRows<T> destination) noexcept
+{
+	auto it{destination.begin()};
+	for (std::span<const T> row : source) {
+		std::ranges::copy(row, (*it++).begin());
+	}
+}
+
+template <class T> void tr::fillRows(BitmapRows<T> rows, T value) noexcept
+{
+	for (std::span<T> row : rows) {
+		std::ranges::fill(row, value);
+	}
+}
+
 const char* tr::BitmapLoadError::what() const noexcept
 {
 	static std::string str;
@@ -218,21 +288,23 @@ tr::Bitmap::Bitmap(glm::ivec2 size, BitmapFormat format)
 }
 
 tr::Bitmap::Bitmap(const Bitmap& bitmap, BitmapFormat format)
-	: _impl{checkNotNull(SDL_ConvertSurfaceFormat(
-		  bitmap._impl.get(), static_cast<SDL_PixelFormatEnum>(static_cast<BitmapFormat::Type>(format)), 0))}
+	: _impl{convertSurface(bitmap._impl.get(), format)}
 {
 }
 
 tr::Bitmap::Bitmap(const BitmapView& view, BitmapFormat format)
-	: _impl{checkNotNull(SDL_ConvertSurfaceFormat(
-		  view._impl.get(), static_cast<SDL_PixelFormatEnum>(static_cast<BitmapFormat::Type>(format)), 0))}
+	: _impl{convertSurface(view._impl.get(), format)}
 {
 }
 
 tr::Bitmap::Bitmap(const SubBitmap& source, BitmapFormat format)
-	: Bitmap{source.size(), format}
+	// The kernels only match blit() when it would copy, otherwise the source has to be blended onto an empty bitmap.
+	: _impl{isCopyBlitSource(source._bitmap) ? convertSurfaceRegion(source._bitmap, source._rect, format) : nullptr}
 {
-	blit({}, source);
+	if (_impl == nullptr) {
+		*this = Bitmap{source.size(), format};
+		blit({}, source);
+	}
 }
 
 glm::ivec2 tr::Bitmap::size() const noexcept
@@ -289,6 +361,32 @@ void tr::Bitmap::blit(glm::ivec2 tl, const SubBitmap& source) noexcept
 {
 	assert(_impl != nullptr);
 	assert(RectI2{size()}.contains(tl + source.size()));
+
+	// Plain copies and conversions are done directly, SDL is only needed for blending and the more exotic cases.
+	if (source._bitmap != _impl.get() && isCopyBlitSource(source._bitmap)) {
+		const RectI2 rect{tl, source.size()};
+		if (source.format() == format()) {
+			switch (format().pixelBytes()) {
+			case 1:
+				copyRows(source.rows<std::uint8_t>(), rows<std::uint8_t>(rect));
+				return;
+			case 2:
+				copyRows(source.rows<std::uint16_t>(), rows<std::uint16_t>(rect));
+				return;
+			case 3:
+				copyRows(source.rows<std::array<std::byte, 3>>(), rows<std::array<std::byte, 3>>(rect));
+				return;
+			case 4:
+				copyRows(source.rows<std::uint32_t>(), rows<std::uint32_t>(rect));
+				return;
+			}
+		}
+		else if (convertPixels(source.data(), source.pitch(), source.format(),
+							   data() + tl.y * pitch() + tl.x * format().pixelBytes(), pitch(), format(), rect.size)) {
+			return;
+		}
+	}
+
 	SDL_Rect sdlSource{source._rect.tl.x, source._rect.tl.y, source.size().x, source.size().y};
 	SDL_Rect sdlDest{tl.x, tl.y, source.size().x, source.size().y};
 	SDL_BlitSurface(source._bitmap, &sdlSource, _impl.get(), &sdlDest);
@@ -298,8 +396,61 @@ void tr::Bitmap::fill(const RectI2& rect, RGBA8 color) noexcept
 {
 	assert(_impl != nullptr);
 	assert(RectI2{size()}.contains(rect.tl + rect.size));
+
+	const std::uint32_t pixel{SDL_MapRGBA(_impl.get()->format, color.r, color.g, color.b, color.a)};
+	if (format().pixelBits() % 8 == 0) {
+		switch (format().pixelBytes()) {
+		case 1:
+			fillRows(rows<std::uint8_t>(rect), static_cast<std::uint8_t>(pixel));
+			return;
+		case 2:
+			fillRows(rows<std::uint16_t>(rect), static_cast<std::uint16_t>(pixel));
+			return;
+		case 4:
+			fillRows(rows<std::uint32_t>(rect), pixel);
+			return;
+		}
+	}
+
 	SDL_Rect sdlRect{rect.tl.x, rect.tl.y, rect.size.x, rect.size.y};
-	SDL_FillRect(_impl.get(), &sdlRect, SDL_MapRGBA(_impl.get()->format, color.r, color.g, color.b, color.a));
+	SDL_FillRect(_impl.get(), &sdlRect, pixel);
+}
+
+void tr::Bitmap::premultiplyAlpha() noexcept
+{
+	assert(_impl != nullptr);
+	if (!format().hasAlpha() || premultiplyPixels(data(), pitch(), format(), size())) {
+		return;
+	}
+
+	for (PixelRef pixel : *this) {
+		RGBA8 color{pixel};
+		color.r = static_cast<std::uint8_t>((color.r * color.a + 127) / 255);
+		color.g = static_cast<std::uint8_t>((color.g * color.a + 127) / 255);
+		color.b = static_cast<std::uint8_t>((color.b * color.a + 127) / 255);
+		pixel   = color;
+	}
+}
+
+void tr::Bitmap::unpremultiplyAlpha() noexcept
+{
+	assert(_impl != nullptr);
+	if (!format().hasAlpha() || unpremultiplyPixels(data(), pitch(), format(), size())) {
+		return;
+	}
+
+	for (PixelRef pixel : *this) {
+		RGBA8 color{pixel};
+		if (color.a == 0) {
+			color = {0, 0, 0, 0};
+		}
+		else {
+			color.r = static_cast<std::uint8_t>(std::min((color.r * 255 + color.a / 2) / color.a, 255));
+			color.g = static_cast<std::uint8_t>(std::min((color.g * 255 + color.a / 2) / color.a, 255));
+			color.b = static_cast<std::uint8_t>(std::min((color.b * 255 + color.a / 2) / color.a, 255));
+		}
+		pixel = color;
+	}
 }
 
 tr::Bitmap::operator SubBitmap() const noexcept
@@ -0,0 +1,622 @@
+#include "bitmap_conversion.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TR_BITMAP_CONVERSION_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(TR_BITMAP_CONVERSION_X86) &&                                                                               \
+	(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TR_BITMAP_CONVERSION_SSE2
+#endif
+
+#if defined(TR_BITMAP_CONVERSION_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TR_BITMAP_CONVERSION_AVX2
+#define TR_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(TR_BITMAP_CONVERSION_X86) && defined(_MSC_VER)
+#define TR_BITMAP_CONVERSION_AVX2
+#define TR_TARGET_AVX2
+#endif
+
+namespace tr {
+	// Memory layout of a format with 4 bytes per pixel and 8 bits per channel.
+	struct Layout32 {
+		std::array<int, 4> pos;   // The byte index of the R, G, B and A (or padding) channels within a pixel.
+		bool               alpha; // Whether the fourth channel is alpha or padding.
+	};
+
+	// Memory layout of a format with 3 bytes per pixel and 8 bits per channel.
+	struct Layout24 {
+		std::array<int, 3> pos; // The byte index of the R, G and B channels within a pixel.
+	};
+
+	// Bit layout of a format with 2 bytes per pixel.
+	struct Layout16 {
+		std::array<int, 4> shift; // The shift of the R, G, B and A channels.
+		std::array<int, 4> bits;  // The width of the R, G, B and A channels (0 if the format has no alpha).
+	};
+
+	// Gets the memory layout of a 32-bit format.
+	std::optional<Layout32> layout32(BitmapFormat format) noexcept;
+	// Gets the memory layout of a 24-bit format.
+	std::optional<Layout24> layout24(BitmapFormat format) noexcept;
+	// Gets the bit layout of a 16-bit format.
+	std::optional<Layout16> layout16(BitmapFormat format) noexcept;
+
+	// Divides a color channel by 255 with correct rounding.
+	constexpr std::uint8_t div255(unsigned int value) noexcept;
+	// Table of 16.16 fixed-point reciprocals used to unpremultiply alpha.
+	inline constexpr std::array<std::uint32_t, 256> UNPREMULTIPLY_TABLE{[] {
+		std::array<std::uint32_t, 256> table{};
+		for (std::uint32_t a = 1; a < 256; ++a) {
+			table[a] = (255 * 65536 + a / 2) / a;
+		}
+		return table;
+	}()};
+
+	// Gets whether the CPU and OS support AVX2.
+	bool cpuSupportsAVX2() noexcept;
+
+	// Reorders the bytes of a row of 32-bit pixels.
+	// map[i] is the source byte written to destination byte i, or -1 to write 255.
+	void shuffleRow32(const std::byte* src, std::byte* dst, int width, const std::array<int, 4>& map) noexcept;
+	// Expands a row of 24-bit pixels to 32-bit pixels. map is interpreted as in shuffleRow32.
+	void expandRow24(const std::byte* src, std::byte* dst, int width, const std::array<int, 4>& map) noexcept;
+	// Unpacks a row of 16-bit pixels to 32-bit pixels.
+	// map[i] is the channel (0-3 = R, G, B, A) written to destination byte i.
+	void unpackRow16(const std::byte* src, std::byte* dst, int width, const Layout16& layout,
+					 const std::array<int, 4>& map) noexcept;
+	// Premultiplies a row of 32-bit pixels with alpha in byte A.
+	template <int A> void premultiplyRow32(std::byte* data, int width) noexcept;
+	// Unpremultiplies a row of 32-bit pixels with alpha in byte alpha.
+	void unpremultiplyRow32(std::byte* data, int width, int alpha) noexcept;
+
+#ifdef TR_BITMAP_CONVERSION_SSE2
+	// SSE2 implementations of the above, processing the largest multiple of the vector width possible.
+	// Return the number of pixels processed.
+	int shuffleRow32SSE2(const std::byte* src, std::byte* dst, int width, const std::array<int, 4>& map) noexcept;
+	int unpackRow16SSE2(const std::byte* src, std::byte* dst, int width, const Layout16& layout,
+						const std::array<int, 4>& map) noexcept;
+	template <int A> int premultiplyRow32SSE2(std::byte* data, int width) noexcept;
+#endif
+
+#ifdef TR_BITMAP_CONVERSION_AVX2
+	// AVX2 implementations of the above, processing the largest multiple of the vector width possible.
+	// Return the number of pixels processed.
+	TR_TARGET_AVX2 int shuffleRow32AVX2(const std::byte* src, std::byte* dst, int width,
+										const std::array<int, 4>& map) noexcept;
+	TR_TARGET_AVX2 int expandRow24AVX2(const std::byte* src, std::byte* dst, int width,
+									   const std::array<int, 4>& map) noexcept;
+	TR_TARGET_AVX2 int unpackRow16AVX2(const std::byte* src, std::byte* dst, int width, const Layout16& layout,
+									   const std::array<int, 4>& map) noexcept;
+	template <int A> TR_TARGET_AVX2 int premultiplyRow32AVX2(std::byte* data, int width) noexcept;
+#endif
+} // namespace tr
+
+std::optional<tr::Layout32> tr::layout32(BitmapFormat format) noexcept
+{
+	// Bit offsets of the channels within the native-endian 32-bit pixel.
+	int  r, g, b, a;
+	bool alpha{true};
+	switch (static_cast<BitmapFormat::Type>(format)) {
+	case BitmapFormat::XRGB_8888:
+		alpha = false;
+		[[fallthrough]];
+	case BitmapFormat::ARGB_8888:
+		a = 24, r = 16, g = 8, b = 0;
+		break;
+	case BitmapFormat::RGBX_8888:
+		alpha = false;
+		[[fallthrough]];
+	case BitmapFormat::RGBA_8888:
+		r = 24, g = 16, b = 8, a = 0;
+		break;
+	case BitmapFormat::XBGR_8888:
+		alpha = false;
+		[[fallthrough]];
+	case BitmapFormat::ABGR_8888:
+		a = 24, b = 16, g = 8, r = 0;
+		break;
+	case BitmapFormat::BGRX_8888:
+		alpha = false;
+		[[fallthrough]];
+	case BitmapFormat::BGRA_8888:
+		b = 24, g = 16, r = 8, a = 0;
+		break;
+	default:
+		return std::nullopt;
+	}
+
+	const auto byte{[](int bit) { return std::endian::native == std::endian::little ? bit / 8 : 3 - bit / 8; }};
+	return Layout32{{byte(r), byte(g), byte(b), byte(a)}, alpha};
+}
+
+std::optional<tr::Layout24> tr::layout24(BitmapFormat format) noexcept
+{
+	switch (static_cast<BitmapFormat::Type>(format)) {
+	case BitmapFormat::RGB_24:
+		return Layout24{{0, 1, 2}};
+	case BitmapFormat::BGR_24:
+		return Layout24{{2, 1, 0}};
+	default:
+		return std::nullopt;
+	}
+}
+
+std::optional<tr::Layout16> tr::layout16(BitmapFormat format) noexcept
+{
+	switch (static_cast<BitmapFormat::Type>(format)) {
+	case BitmapFormat::RGB_565:
+		return Layout16{{11, 5, 0, 0}, {5, 6, 5, 0}};
+	case BitmapFormat::BGR_565:
+		return Layout16{{0, 5, 11, 0}, {5, 6, 5, 0}};
+	case BitmapFormat::XRGB_4444:
+		return Layout16{{8, 4, 0, 0}, {4, 4, 4, 0}};
+	case BitmapFormat::ARGB_4444:
+		return Layout16{{8, 4, 0, 12}, {4, 4, 4, 4}};
+	case BitmapFormat::RGBA_4444:
+		return Layout16{{12, 8, 4, 0}, {4, 4, 4, 4}};
+	case BitmapFormat::ABGR_4444:
+		return Layout16{{0, 4, 8, 12}, {4, 4, 4, 4}};
+	case BitmapFormat::BGRA_4444:
+		return Layout16{{4, 8, 12, 0}, {4, 4, 4, 4}};
+	case BitmapFormat::XRGB_1555:
+		return Layout16{{10, 5, 0, 0}, {5, 5, 5, 0}};
+	case BitmapFormat::XBGR_1555:
+		return Layout16{{0, 5, 10, 0}, {5, 5, 5, 0}};
+	case BitmapFormat::ARGB_1555:
+		return Layout16{{10, 5, 0, 15}, {5, 5, 5, 1}};
+	case BitmapFormat::RGBA_5551:
+		return Layout16{{11, 6, 1, 0}, {5, 5, 5, 1}};
+	case BitmapFormat::ABGR_1555:
+		return Layout16{{0, 5, 10, 15}, {5, 5, 5, 1}};
+	case BitmapFormat::BGRA_5551:
+		return Layout16{{1, 6, 11, 0}, {5, 5, 5, 1}};
+	default:
+		return std::nullopt;
+	}
+}
+
+constexpr std::uint8_t tr::div255(unsigned int value) noexcept
+{
+	value += 128;
+	return static_cast<std::uint8_t>((value + (value >> 8)) >> 8);
+}
+
+bool tr::cpuSupportsAVX2() noexcept
+{
+#if !defined(TR_BITMAP_CONVERSION_AVX2)
+	return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+	static const bool supported{[] {
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+		__cpuid(info, 1);
+		// OSXSAVE and AVX, then YMM state saving enabled by the OS.
+		if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6) {
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	}()};
+	return supported;
+#else
+	static const bool supported{static_cast<bool>(__builtin_cpu_supports("avx2"))};
+	return supported;
+#endif
+}
+
+void tr::shuffleRow32(const std::byte* src, std::byte* dst, int width, const std::array<int, 4>& map) noexcept
+{
+	int x{0};
+#ifdef TR_BITMAP_CONVERSION_AVX2
+	if (cpuSupportsAVX2()) {
+		x = shuffleRow32AVX2(src, dst, width, map);
+	}
+#endif
+#ifdef TR_BITMAP_CONVERSION_SSE2
+	x += shuffleRow32SSE2(src + x * 4, dst + x * 4, width - x, map);
+#endif
+	for (; x < width; ++x) {
+		for (int i = 0; i < 4; ++i) {
+			dst[x * 4 + i] = map[i] == -1 ? std::byte{255} : src[x * 4 + map[i]];
+		}
+	}
+}
+
+void tr::expandRow24(const std::byte* src, std::byte* dst, int width, const std::array<int, 4>& map) noexcept
+{
+	int x{0};
+#ifdef TR_BITMAP_CONVERSION_AVX2
+	if (cpuSupportsAVX2()) {
+		x = expandRow24AVX2(src, dst, width, map);
+	}
+#endif
+	for (; x < width; ++x) {
+		for (int i = 0; i < 4; ++i) {
+			dst[x * 4 + i] = map[i] == -1 ? std::byte{255} : src[x * 3 + map[i]];
+		}
+	}
+}
+
+void tr::unpackRow16(const std::byte* src, std::byte* dst, int width, const Layout16& layout,
+					 const std::array<int, 4>& map) noexcept
+{
+	int x{0};
+#ifdef TR_BITMAP_CONVERSION_AVX2
+	if (cpuSupportsAVX2()) {
+		x = unpackRow16AVX2(src, dst, width, layout, map);
+	}
+#endif
+#ifdef TR_BITMAP_CONVERSION_SSE2
+	x += unpackRow16SSE2(src + x * 2, dst + x * 4, width - x, layout, map);
+#endif
+	for (; x < width; ++x) {
+		std::uint16_t pixel;
+		std::memcpy(&pixel, src + x * 2, sizeof(pixel));
+		std::array<std::uint8_t, 4> channels;
+		for (int c = 0; c < 4; ++c) {
+			const int bits{layout.bits[c]};
+			if (bits == 0) {
+				channels[c] = 255;
+				continue;
+			}
+			// Shift the channel to the top of the byte, then replicate its bits into the vacated low bits.
+			unsigned int value{((pixel >> layout.shift[c]) & ((1u << bits) - 1)) << (8 - bits)};
+			for (int i = bits; i < 8; i *= 2) {
+				value |= value >> i;
+			}
+			channels[c] = static_cast<std::uint8_t>(value);
+		}
+		for (int i = 0; i < 4; ++i) {
+			dst[x * 4 + i] = std::byte{channels[map[i]]};
+		}
+	}
+}
+
+template <int A> void tr::premultiplyRow32(std::byte* data, int width) noexcept
+{
+	int x{0};
+#ifdef TR_BITMAP_CONVERSION_AVX2
+	if (cpuSupportsAVX2()) {
+		x = premultiplyRow32AVX2<A>(data, width);
+	}
+#endif
+#ifdef TR_BITMAP_CONVERSION_SSE2
+	x += premultiplyRow32SSE2<A>(data + x * 4, width - x);
+#endif
+	for (; x < width; ++x) {
+		std::byte* pixel{data + x * 4};
+		const unsigned int alpha{std::to_integer<unsigned int>(pixel[A])};
+		for (int i = 0; i < 4; ++i) {
+			if (i != A) {
+				pixel[i] = std::byte{div255(std::to_integer<unsigned int>(pixel[i]) * alpha)};
+			}
+		}
+	}
+}
+
+void tr::unpremultiplyRow32(std::byte* data, int width, int alpha) noexcept
+{
+	for (int x = 0; x < width; ++x) {
+		std::byte*          pixel{data + x * 4};
+		const std::uint32_t reciprocal{UNPREMULTIPLY_TABLE[std::to_integer<int>(pixel[alpha])]};
+		for (int i = 0; i < 4; ++i) {
+			if (i != alpha) {
+				const std::uint32_t value{(std::to_integer<std::uint32_t>(pixel[i]) * reciprocal + 32768) >> 16};
+				pixel[i] = std::byte(std::min(value, 255u));
+			}
+		}
+	}
+}
+
+#ifdef TR_BITMAP_CONVERSION_SSE2
+int tr::shuffleRow32SSE2(const std::byte* src, std::byte* dst, int width, const std::array<int, 4>& map) noexcept
+{
+	// Without a byte shuffle, each destination byte is moved into place with a shift and a mask.
+	__m128i       srcShifts[4];
+	__m128i       dstShifts[4];
+	std::uint32_t fill{0};
+	for (int i = 0; i < 4; ++i) {
+		srcShifts[i] = _mm_cvtsi32_si128(map[i] == -1 ? 0 : map[i] * 8);
+		dstShifts[i] = _mm_cvtsi32_si128(i * 8);
+		if (map[i] == -1) {
+			fill |= 0xFFu << (i * 8);
+		}
+	}
+	const __m128i byteMask{_mm_set1_epi32(0xFF)};
+	const __m128i fillMask{_mm_set1_epi32(static_cast<int>(fill))};
+
+	int x{0};
+	for (; x + 4 <= width; x += 4) {
+		const __m128i pixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4))};
+		__m128i       result{fillMask};
+		for (int i = 0; i < 4; ++i) {
+			if (map[i] != -1) {
+				const __m128i channel{_mm_and_si128(_mm_srl_epi32(pixels, srcShifts[i]), byteMask)};
+				result = _mm_or_si128(result, _mm_sll_epi32(channel, dstShifts[i]));
+			}
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), result);
+	}
+	return x;
+}
+
+int tr::unpackRow16SSE2(const std::byte* src, std::byte* dst, int width, const Layout16& layout,
+						const std::array<int, 4>& map) noexcept
+{
+	__m128i shifts[4];
+	__m128i masks[4];
+	__m128i widens[4];
+	for (int c = 0; c < 4; ++c) {
+		shifts[c] = _mm_cvtsi32_si128(layout.shift[c]);
+		masks[c]  = _mm_set1_epi16(static_cast<short>((1 << layout.bits[c]) - 1));
+		widens[c] = _mm_cvtsi32_si128(8 - layout.bits[c]);
+	}
+
+	int x{0};
+	for (; x + 8 <= width; x += 8) {
+		const __m128i pixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2))};
+		__m128i channels[4];
+		for (int c = 0; c < 4; ++c) {
+			const int bits{layout.bits[c]};
+			if (bits == 0) {
+				channels[c] = _mm_set1_epi16(255);
+				continue;
+			}
+			channels[c] = _mm_sll_epi16(_mm_and_si128(_mm_srl_epi16(pixels, shifts[c]), masks[c]), widens[c]);
+			for (int i = bits; i < 8; i *= 2) {
+				channels[c] = _mm_or_si128(channels[c], _mm_srl_epi16(channels[c], _mm_cvtsi32_si128(i)));
+			}
+		}
+		const __m128i lo{_mm_or_si128(channels[map[0]], _mm_slli_epi16(channels[map[1]], 8))};
+		const __m128i hi{_mm_or_si128(channels[map[2]], _mm_slli_epi16(channels[map[3]], 8))};
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), _mm_unpacklo_epi16(lo, hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4 + 16), _mm_unpackhi_epi16(lo, hi));
+	}
+	return x;
+}
+
+template <int A> int tr::premultiplyRow32SSE2(std::byte* data, int width) noexcept
+{
+	// Alpha is multiplied by 255 (a no-op after the division) instead of itself.
+	constexpr int BROADCAST{A * 0x55};
+	const __m128i alphaLanes{_mm_set_epi16(A == 3 ? -1 : 0, A == 2 ? -1 : 0, A == 1 ? -1 : 0, A == 0 ? -1 : 0,
+										   A == 3 ? -1 : 0, A == 2 ? -1 : 0, A == 1 ? -1 : 0, A == 0 ? -1 : 0)};
+	const __m128i alphaFactor{_mm_and_si128(alphaLanes, _mm_set1_epi16(255))};
+	const __m128i zero{_mm_setzero_si128()};
+	const __m128i rounding{_mm_set1_epi16(128)};
+
+	int x{0};
+	for (; x + 4 <= width; x += 4) {
+		const __m128i pixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + x * 4))};
+		__m128i halves[2]{_mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero)};
+		for (__m128i& half : halves) {
+			__m128i factors{_mm_shufflehi_epi16(_mm_shufflelo_epi16(half, BROADCAST), BROADCAST)};
+			factors = _mm_or_si128(_mm_andnot_si128(alphaLanes, factors), alphaFactor);
+			const __m128i product{_mm_add_epi16(_mm_mullo_epi16(half, factors), rounding)};
+			half = _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + x * 4), _mm_packus_epi16(halves[0], halves[1]));
+	}
+	return x;
+}
+#endif
+
+#ifdef TR_BITMAP_CONVERSION_AVX2
+TR_TARGET_AVX2 int tr::shuffleRow32AVX2(const std::byte* src, std::byte* dst, int width,
+										const std::array<int, 4>& map) noexcept
+{
+	alignas(32) std::array<std::int8_t, 32> shuffle;
+	alignas(32) std::array<std::int8_t, 32> fill;
+	for (int p = 0; p < 8; ++p) {
+		for (int i = 0; i < 4; ++i) {
+			shuffle[p * 4 + i] = static_cast<std::int8_t>(map[i] == -1 ? -128 : (p % 4) * 4 + map[i]);
+			fill[p * 4 + i]    = static_cast<std::int8_t>(map[i] == -1 ? -1 : 0);
+		}
+	}
+	const __m256i shuffleMask{_mm256_load_si256(reinterpret_cast<const __m256i*>(shuffle.data()))};
+	const __m256i fillMask{_mm256_load_si256(reinterpret_cast<const __m256i*>(fill.data()))};
+
+	int x{0};
+	for (; x + 8 <= width; x += 8) {
+		const __m256i pixels{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 4))};
+		const __m256i result{_mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffleMask), fillMask)};
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), result);
+	}
+	return x;
+}
+
+TR_TARGET_AVX2 int tr::expandRow24AVX2(const std::byte* src, std::byte* dst, int width,
+									   const std::array<int, 4>& map) noexcept
+{
+	alignas(16) std::array<std::int8_t, 16> shuffle;
+	alignas(16) std::array<std::int8_t, 16> fill;
+	for (int p = 0; p < 4; ++p) {
+		for (int i = 0; i < 4; ++i) {
+			shuffle[p * 4 + i] = static_cast<std::int8_t>(map[i] == -1 ? -128 : p * 3 + map[i]);
+			fill[p * 4 + i]    = static_cast<std::int8_t>(map[i] == -1 ? -1 : 0);
+		}
+	}
+	const __m128i shuffleMask{_mm_load_si128(reinterpret_cast<const __m128i*>(shuffle.data()))};
+	const __m128i fillMask{_mm_load_si128(reinterpret_cast<const __m128i*>(fill.data()))};
+
+	// Each 16-byte load covers 4 pixels and 4 bytes of the next one, so 2 extra pixels must remain past the block.
+	int x{0};
+	for (; x + 10 <= width; x += 8) {
+		const __m128i first{_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 3))};
+		const __m128i second{_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 3 + 12))};
+		const __m256i pixels{_mm256_set_m128i(second, first)};
+		const __m256i result{_mm256_or_si256(_mm256_shuffle_epi8(pixels, _mm256_set_m128i(shuffleMask, shuffleMask)),
+											 _mm256_set_m128i(fillMask, fillMask))};
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), result);
+	}
+	return x;
+}
+
+TR_TARGET_AVX2 int tr::unpackRow16AVX2(const std::byte* src, std::byte* dst, int width, const Layout16& layout,
+									   const std::array<int, 4>& map) noexcept
+{
+	__m128i shifts[4];
+	__m256i masks[4];
+	__m128i widens[4];
+	for (int c = 0; c < 4; ++c) {
+		shifts[c] = _mm_cvtsi32_si128(layout.shift[c]);
+		masks[c]  = _mm256_set1_epi16(static_cast<short>((1 << layout.bits[c]) - 1));
+		widens[c] = _mm_cvtsi32_si128(8 - layout.bits[c]);
+	}
+
+	int x{0};
+	for (; x + 16 <= width; x += 16) {
+		const __m256i pixels{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 2))};
+		__m256i channels[4];
+		for (int c = 0; c < 4; ++c) {
+			const int bits{layout.bits[c]};
+			if (bits == 0) {
+				channels[c] = _mm256_set1_epi16(255);
+				continue;
+			}
+			channels[c] =
+				_mm256_sll_epi16(_mm256_and_si256(_mm256_srl_epi16(pixels, shifts[c]), masks[c]), widens[c]);
+			for (int i = bits; i < 8; i *= 2) {
+				channels[c] = _mm256_or_si256(channels[c], _mm256_srl_epi16(channels[c], _mm_cvtsi32_si128(i)));
+			}
+		}
+		const __m256i lo{_mm256_or_si256(channels[map[0]], _mm256_slli_epi16(channels[map[1]], 8))};
+		const __m256i hi{_mm256_or_si256(channels[map[2]], _mm256_slli_epi16(channels[map[3]], 8))};
+		// The unpacks work within 128-bit lanes, yielding pixels 0-3 + 8-11 and 4-7 + 12-15.
+		const __m256i first{_mm256_unpacklo_epi16(lo, hi)};
+		const __m256i second{_mm256_unpackhi_epi16(lo, hi)};
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), _mm256_permute2x128_si256(first, second, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4 + 32),
+							_mm256_permute2x128_si256(first, second, 0x31));
+	}
+	return x;
+}
+
+template <int A> TR_TARGET_AVX2 int tr::premultiplyRow32AVX2(std::byte* data, int width) noexcept
+{
+	constexpr int BROADCAST{A * 0x55};
+	const __m256i alphaLanes{_mm256_set_epi16(
+		A == 3 ? -1 : 0, A == 2 ? -1 : 0, A == 1 ? -1 : 0, A == 0 ? -1 : 0, A == 3 ? -1 : 0, A == 2 ? -1 : 0,
+		A == 1 ? -1 : 0, A == 0 ? -1 : 0, A == 3 ? -1 : 0, A == 2 ? -1 : 0, A == 1 ? -1 : 0, A == 0 ? -1 : 0,
+		A == 3 ? -1 : 0, A == 2 ? -1 : 0, A == 1 ? -1 : 0, A == 0 ? -1 : 0)};
+	const __m256i alphaFactor{_mm256_and_si256(alphaLanes, _mm256_set1_epi16(255))};
+	const __m256i zero{_mm256_setzero_si256()};
+	const __m256i rounding{_mm256_set1_epi16(128)};
+
+	int x{0};
+	for (; x + 8 <= width; x += 8) {
+		// The unpacks and the pack both work within 128-bit lanes, so the pixel order is preserved.
+		const __m256i pixels{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + x * 4))};
+		__m256i halves[2]{_mm256_unpacklo_epi8(pixels, zero), _mm256_unpackhi_epi8(pixels, zero)};
+		for (__m256i& half : halves) {
+			__m256i factors{_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(half, BROADCAST), BROADCAST)};
+			factors = _mm256_or_si256(_mm256_andnot_si256(alphaLanes, factors), alphaFactor);
+			const __m256i product{_mm256_add_epi16(_mm256_mullo_epi16(half, factors), rounding)};
+			half = _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + x * 4), _mm256_packus_epi16(halves[0], halves[1]));
+	}
+	return x;
+}
+#endif
+
+bool tr::hasConversionKernel(BitmapFormat srcFormat, BitmapFormat dstFormat) noexcept
+{
+	return layout32(dstFormat).has_value() &&
+		   (layout32(srcFormat).has_value() || layout24(srcFormat).has_value() || layout16(srcFormat).has_value());
+}
+
+bool tr::convertPixels(const std::byte* src, int srcPitch, BitmapFormat srcFormat, std::byte* dst, int dstPitch,
+					   BitmapFormat dstFormat, glm::ivec2 size) noexcept
+{
+	const std::optional<Layout32> dstLayout{layout32(dstFormat)};
+	if (!dstLayout.has_value()) {
+		return false;
+	}
+
+	// Inverse of the destination layout: the channel written to each destination byte.
+	std::array<int, 4> channels;
+	for (int c = 0; c < 4; ++c) {
+		channels[dstLayout->pos[c]] = c;
+	}
+
+	if (const std::optional<Layout32> srcLayout{layout32(srcFormat)}; srcLayout.has_value()) {
+		std::array<int, 4> map;
+		for (int i = 0; i < 4; ++i) {
+			const int c{channels[i]};
+			map[i] = c == 3 && !srcLayout->alpha ? -1 : srcLayout->pos[c];
+		}
+		for (int y = 0; y < size.y; ++y) {
+			shuffleRow32(src + y * srcPitch, dst + y * dstPitch, size.x, map);
+		}
+		return true;
+	}
+	else if (const std::optional<Layout24> srcLayout{layout24(srcFormat)}; srcLayout.has_value()) {
+		std::array<int, 4> map;
+		for (int i = 0; i < 4; ++i) {
+			const int c{channels[i]};
+			map[i] = c == 3 ? -1 : srcLayout->pos[c];
+		}
+		for (int y = 0; y < size.y; ++y) {
+			expandRow24(src + y * srcPitch, dst + y * dstPitch, size.x, map);
+		}
+		return true;
+	}
+	else if (const std::optional<Layout16> srcLayout{layout16(srcFormat)}; srcLayout.has_value()) {
+		for (int y = 0; y < size.y; ++y) {
+			unpackRow16(src + y * srcPitch, dst + y * dstPitch, size.x, *srcLayout, channels);
+		}
+		return true;
+	}
+	else {
+		return false;
+	}
+}
+
+bool tr::premultiplyPixels(std::byte* data, int pitch, BitmapFormat format, glm::ivec2 size) noexcept
+{
+	const std::optional<Layout32> layout{layout32(format)};
+	if (!layout.has_value() || !layout->alpha) {
+		return false;
+	}
+
+	for (int y = 0; y < size.y; ++y) {
+		std::byte* row{data + y * pitch};
+		switch (layout->pos[3]) {
+		case 0:
+			premultiplyRow32<0>(row, size.x);
+			break;
+		case 1:
+			premultiplyRow32<1>(row, size.x);
+			break;
+		case 2:
+			premultiplyRow32<2>(row, size.x);
+			break;
+		case 3:
+			premultiplyRow32<3>(row, size.x);
+			break;
+		}
+	}
+	return true;
+}
+
+bool tr::unpremultiplyPixels(std::byte* data, int pitch, BitmapFormat format, glm::ivec2 size) noexcept
+{
+	const std::optional<Layout32> layout{layout32(format)};
+	if (!layout.has_value() || !layout->alpha) {
+		return false;
+	}
+
+	for (int y = 0; y < size.y; ++y) {
+		unpremultiplyRow32(data + y * pitch, size.x, layout->pos[3]);
+	}
+	return true;
+}
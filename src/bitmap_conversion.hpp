@@ -0,0 +1,21 @@
+#pragma once
+#include "../include/tr/bitmap_format.hpp"
+#include "../include/tr/common.hpp"
+
+namespace tr {
+	// Gets whether convertPixels() has a kernel for a format pair.
+	bool hasConversionKernel(BitmapFormat srcFormat, BitmapFormat dstFormat) noexcept;
+
+	// Converts a block of pixels between two formats using a specialized kernel.
+	// Returns false without touching the destination if there is no kernel for the format pair.
+	bool convertPixels(const std::byte* src, int srcPitch, BitmapFormat srcFormat, std::byte* dst, int dstPitch,
+					   BitmapFormat dstFormat, glm::ivec2 size) noexcept;
+
+	// Multiplies the color channels of a block of pixels by their alpha in-place.
+	// Returns false without touching the pixels if there is no kernel for the format.
+	bool premultiplyPixels(std::byte* data, int pitch, BitmapFormat format, glm::ivec2 size) noexcept;
+
+	// Divides the color channels of a block of premultiplied pixels by their alpha in-place.
+	// Returns false without touching the pixels if there is no kernel for the format.
+	bool unpremultiplyPixels(std::byte* data, int pitch, BitmapFormat format, glm::ivec2 size) noexcept;
+} // namespace tr
@@ -0,0 +1,339 @@
+#include "../include/tr/command_buffer.hpp"
+#include "../include/tr/index_buffer.hpp"
+#include "../include/tr/streaming_buffer.hpp"
+#include "../include/tr/texture_unit.hpp"
+#include "../include/tr/vertex_buffer.hpp"
+
+namespace tr {
+	// Types of recorded commands.
+	enum class CommandType : std::uint8_t {
+		PIPELINE_STATE,
+		SHADER_PIPELINE,
+		VERTEX_FORMAT,
+		VERTEX_BUFFER,
+		STREAMING_VERTEX_BUFFER,
+		INDEX_BUFFER,
+		STREAMING_INDEX_BUFFER,
+		TEXTURE,
+		VIEWPORT,
+		SCISSOR_TEST,
+		SCISSOR_BOX,
+		CLEAR_COLOR,
+		CLEAR,
+		VERTEX_BUFFER_REGION,
+		INDEX_BUFFER_REGION,
+		DRAW,
+		DRAW_INDEXED
+	};
+
+	// Payload of a vertex buffer binding command.
+	template <class Buffer> struct VertexBufferCommand {
+		const Buffer* buffer;
+		std::size_t   offset;
+		std::size_t   vertexStride;
+	};
+
+	// Payload of a texture binding command.
+	struct TextureCommand {
+		TextureUnit*   unit;
+		const Texture* texture;
+	};
+
+	// Payload header of a buffer upload command, followed by the uploaded data.
+	template <class Buffer> struct BufferRegionCommand {
+		Buffer*     buffer;
+		std::size_t offset;
+		std::size_t size; // The size of the uploaded data in bytes.
+	};
+
+	// Payload of a draw command.
+	struct DrawCommand {
+		Primitive   type;
+		std::size_t offset;
+		std::size_t count;
+		int         instances;
+	};
+
+	// Writes a command payload to its storage in the stream.
+	template <class T> void writeCommandPayload(std::byte* storage, const T& payload) noexcept;
+	// Reads a command payload from the stream and advances past it.
+	template <class T> T readCommandPayload(const std::byte*& it) noexcept;
+} // namespace tr
+
+template <class T> void tr::writeCommandPayload(std::byte* storage, const T& payload) noexcept
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	std::memcpy(storage, &payload, sizeof(T));
+}
+
+template <class T> T tr::readCommandPayload(const std::byte*& it) noexcept
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	T payload;
+	std::memcpy(&payload, it, sizeof(T));
+	it += sizeof(T);
+	return payload;
+}
+
+tr::CommandBuffer::CommandBuffer() noexcept
+	: _commands{0}
+{
+}
+
+bool tr::CommandBuffer::empty() const noexcept
+{
+	return _commands == 0;
+}
+
+std::size_t tr::CommandBuffer::commands() const noexcept
+{
+	return _commands;
+}
+
+std::size_t tr::CommandBuffer::size() const noexcept
+{
+	return _stream.size();
+}
+
+void tr::CommandBuffer::reserve(std::size_t bytes)
+{
+	_stream.reserve(bytes);
+}
+
+void tr::CommandBuffer::clear() noexcept
+{
+	_stream.clear();
+	_commands = 0;
+}
+
+std::byte* tr::CommandBuffer::append(std::uint8_t type, std::size_t payloadSize)
+{
+	const std::size_t offset{_stream.size()};
+	_stream.resize(offset + 1 + payloadSize);
+	_stream[offset] = std::byte{type};
+	++_commands;
+	return _stream.data() + offset + 1;
+}
+
+void tr::CommandBuffer::setPipelineState(const PipelineState& state)
+{
+	writeCommandPayload(append(std::uint8_t(CommandType::PIPELINE_STATE), sizeof(PipelineState)), state);
+}
+
+void tr::CommandBuffer::setShaderPipeline(const ShaderPipeline& pipeline)
+{
+	writeCommandPayload(append(std::uint8_t(CommandType::SHADER_PIPELINE), sizeof(&pipeline)), &pipeline);
+}
+
+void tr::CommandBuffer::setVertexFormat(const VertexFormat& format)
+{
+	writeCommandPayload(append(std::uint8_t(CommandType::VERTEX_FORMAT), sizeof(&format)), &format);
+}
+
+void tr::CommandBuffer::setVertexBuffer(const VertexBuffer& buffer, std::size_t offset, std::size_t vertexStride)
+{
+	const VertexBufferCommand<VertexBuffer> command{&buffer, offset, vertexStride};
+	writeCommandPayload(append(std::uint8_t(CommandType::VERTEX_BUFFER), sizeof(command)), command);
+}
+
+void tr::CommandBuffer::setVertexBuffer(const StreamingBuffer& buffer, std::size_t offset, std::size_t vertexStride)
+{
+	const VertexBufferCommand<StreamingBuffer> command{&buffer, offset, vertexStride};
+	writeCommandPayload(append(std::uint8_t(CommandType::STREAMING_VERTEX_BUFFER), sizeof(command)), command);
+}
+
+void tr::CommandBuffer::setIndexBuffer(const IndexBuffer& buffer)
+{
+	writeCommandPayload(append(std::uint8_t(CommandType::INDEX_BUFFER), sizeof(&buffer)), &buffer);
+}
+
+void tr::CommandBuffer::setIndexBuffer(const StreamingBuffer& buffer)
+{
+	writeCommandPayload(append(std::uint8_t(CommandType::STREAMING_INDEX_BUFFER), sizeof(&buffer)), &buffer);
+}
+
+void tr::CommandBuffer::setTexture(TextureUnit& unit, const Texture& texture)
+{
+	const TextureCommand command{&unit, &texture};
+	writeCommandPayload(append(std::uint8_t(CommandType::TEXTURE), sizeof(command)), command);
+}
+
+void tr::CommandBuffer::setViewport(const RectI2& viewport)
+{
+	writeCommandPayload(append(std::uint8_t(CommandType::VIEWPORT), sizeof(viewport)), viewport);
+}
+
+void tr::CommandBuffer::useScissorTest(bool use)
+{
+	writeCommandPayload(append(std::uint8_t(CommandType::SCISSOR_TEST), sizeof(use)), use);
+}
+
+void tr::CommandBuffer::setScissorBox(const RectI2& rect)
+{
+	writeCommandPayload(append(std::uint8_t(CommandType::SCISSOR_BOX), sizeof(rect)), rect);
+}
+
+void tr::CommandBuffer::setClearColor(RGBAF color)
+{
+	writeCommandPayload(append(std::uint8_t(CommandType::CLEAR_COLOR), sizeof(color)), color);
+}
+
+void tr::CommandBuffer::clear(Clear components)
+{
+	writeCommandPayload(append(std::uint8_t(CommandType::CLEAR), sizeof(components)), components);
+}
+
+void tr::CommandBuffer::setRegion(VertexBuffer& buffer, std::size_t offset, std::span<const std::byte> data)
+{
+	const BufferRegionCommand<VertexBuffer> header{&buffer, offset, data.size()};
+	std::byte* const payload{append(std::uint8_t(CommandType::VERTEX_BUFFER_REGION), sizeof(header) + data.size())};
+	writeCommandPayload(payload, header);
+	std::ranges::copy(data, payload + sizeof(header));
+}
+
+void tr::CommandBuffer::setRegion(IndexBuffer& buffer, std::size_t offset, std::span<const std::uint16_t> data)
+{
+	// The indices are padded to be aligned within the stream so that they can be uploaded in-place.
+	const BufferRegionCommand<IndexBuffer> header{&buffer, offset, data.size_bytes()};
+	const std::size_t padding{(_stream.size() + 1 + sizeof(header)) % alignof(std::uint16_t)};
+	std::byte* const  payload{append(std::uint8_t(CommandType::INDEX_BUFFER_REGION),
+									 sizeof(header) + padding + data.size_bytes())};
+	writeCommandPayload(payload, header);
+	std::memcpy(payload + sizeof(header) + padding, data.data(), data.size_bytes());
+}
+
+void tr::CommandBuffer::draw(Primitive type, std::size_t offset, std::size_t vertices)
+{
+	const DrawCommand command{type, offset, vertices, 1};
+	writeCommandPayload(append(std::uint8_t(CommandType::DRAW), sizeof(command)), command);
+}
+
+void tr::CommandBuffer::drawInstances(Primitive type, std::size_t offset, std::size_t vertices, int instances)
+{
+	const DrawCommand command{type, offset, vertices, instances};
+	writeCommandPayload(append(std::uint8_t(CommandType::DRAW), sizeof(command)), command);
+}
+
+void tr::CommandBuffer::drawIndexed(Primitive type, std::size_t offset, std::size_t indices)
+{
+	const DrawCommand command{type, offset, indices, 1};
+	writeCommandPayload(append(std::uint8_t(CommandType::DRAW_INDEXED), sizeof(command)), command);
+}
+
+void tr::CommandBuffer::drawIndexedInstances(Primitive type, std::size_t offset, std::size_t indices, int instances)
+{
+	const DrawCommand command{type, offset, indices, instances};
+	writeCommandPayload(append(std::uint8_t(CommandType::DRAW_INDEXED), sizeof(command)), command);
+}
+
+void tr::CommandBuffer::execute(GraphicsContext& context) const noexcept
+{
+	const std::byte* it{_stream.data()};
+	const std::byte* end{_stream.data() + _stream.size()};
+	while (it != end) {
+		const CommandType type{static_cast<CommandType>(*it++)};
+		switch (type) {
+		case CommandType::PIPELINE_STATE:
+			context.setPipelineState(readCommandPayload<PipelineState>(it));
+			break;
+		case CommandType::SHADER_PIPELINE:
+			context.setShaderPipeline(*readCommandPayload<const ShaderPipeline*>(it));
+			break;
+		case CommandType::VERTEX_FORMAT:
+			context.setVertexFormat(*readCommandPayload<const VertexFormat*>(it));
+			break;
+		case CommandType::VERTEX_BUFFER: {
+			const auto command{readCommandPayload<VertexBufferCommand<VertexBuffer>>(it)};
+			context.setVertexBuffer(*command.buffer, command.offset, command.vertexStride);
+			break;
+		}
+		case CommandType::STREAMING_VERTEX_BUFFER: {
+			const auto command{readCommandPayload<VertexBufferCommand<StreamingBuffer>>(it)};
+			context.setVertexBuffer(*command.buffer, command.offset, command.vertexStride);
+			break;
+		}
+		case CommandType::INDEX_BUFFER:
+			context.setIndexBuffer(*readCommandPayload<const IndexBuffer*>(it));
+			break;
+		case CommandType::STREAMING_INDEX_BUFFER:
+			context.setIndexBuffer(*readCommandPayload<const StreamingBuffer*>(it));
+			break;
+		case CommandType::TEXTURE: {
+			const TextureCommand command{readCommandPayload<TextureCommand>(it)};
+			command.unit->setTexture(*command.texture);
+			break;
+		}
+		case CommandType::VIEWPORT:
+			context.setViewport(readCommandPayload<RectI2>(it));
+			break;
+		case CommandType::SCISSOR_TEST:
+			context.useScissorTest(readCommandPayload<bool>(it));
+			break;
+		case CommandType::SCISSOR_BOX:
+			context.setScissorBox(readCommandPayload<RectI2>(it));
+			break;
+		case CommandType::CLEAR_COLOR:
+			context.setClearColor(readCommandPayload<RGBAF>(it));
+			break;
+		case CommandType::CLEAR:
+			context.clear(readCommandPayload<Clear>(it));
+			break;
+		case CommandType::VERTEX_BUFFER_REGION: {
+			const auto command{readCommandPayload<BufferRegionCommand<VertexBuffer>>(it)};
+			command.buffer->setRegion(command.offset, std::span{it, command.size});
+			it += command.size;
+			break;
+		}
+		case CommandType::INDEX_BUFFER_REGION: {
+			const auto command{readCommandPayload<BufferRegionCommand<IndexBuffer>>(it)};
+			it += (it - _stream.data()) % alignof(std::uint16_t);
+			const std::uint16_t* indices{reinterpret_cast<const std::uint16_t*>(it)};
+			command.buffer->setRegion(command.offset, std::span{indices, command.size / sizeof(std::uint16_t)});
+			it += command.size;
+			break;
+		}
+		case CommandType::DRAW: {
+			const DrawCommand command{readCommandPayload<DrawCommand>(it)};
+			if (command.instances == 1) {
+				context.draw(command.type, command.offset, command.count);
+			}
+			else {
+				context.drawInstances(command.type, command.offset, command.count, command.instances);
+			}
+			break;
+		}
+		case CommandType::DRAW_INDEXED: {
+			const DrawCommand command{readCommandPayload<DrawCommand>(it)};
+			if (command.instances == 1) {
+				context.drawIndexed(command.type, command.offset, command.count);
+			}
+			else {
+				context.drawIndexedInstances(command.type, command.offset, command.count, command.instances);
+			}
+			break;
+		}
+		}
+	}
+}
+
+tr::CommandBuffer tr::CommandBufferPool::acquire() noexcept
+{
+	std::lock_guard lock{_mutex};
+	if (_buffers.empty()) {
+		return CommandBuffer{};
+	}
+	else {
+		CommandBuffer buffer{std::move(_buffers.back())};
+		_buffers.pop_back();
+		return buffer;
+	}
+}
+
+void tr::CommandBufferPool::release(CommandBuffer&& buffer)
+{
+	std::lock_guard lock{_mutex};
+	_buffers.push_back(std::move(buffer));
+	_buffers.back().clear();
+}
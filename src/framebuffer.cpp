@@ -3,7 +3,7 @@
 #include "../include/tr/texture.hpp"
 #include "../include/tr/window.hpp"
 #include "bitmap_to_gl_format.hpp"
-#include "gl_call.hpp"
+#include "gl_state.hpp"
 #include <SDL2/SDL.h>
 
 namespace tr {
@@ -42,12 +42,16 @@ void tr::BasicFramebuffer::copyRegion(const RectI2& rect, ColorTexture2D& textur
 
 void tr::BasicFramebuffer::bindRead() const noexcept
 {
-	TR_GL_CALL(glBindFramebuffer, GL_READ_FRAMEBUFFER, _id);
+	if (_glState.change(_glState.readFramebuffer, _id)) {
+		TR_GL_CALL(glBindFramebuffer, GL_READ_FRAMEBUFFER, _id);
+	}
 }
 
 void tr::BasicFramebuffer::bindWrite() const noexcept
 {
-	TR_GL_CALL(glBindFramebuffer, GL_DRAW_FRAMEBUFFER, _id);
+	if (_glState.change(_glState.drawFramebuffer, _id)) {
+		TR_GL_CALL(glBindFramebuffer, GL_DRAW_FRAMEBUFFER, _id);
+	}
 }
 
 tr::Framebuffer::Framebuffer() noexcept
@@ -73,6 +77,7 @@ tr::Framebuffer& tr::Framebuffer::operator=(Framebuffer&& r) noexcept
 
 tr::Framebuffer::~Framebuffer() noexcept
 {
+	_glState.forgetFramebuffer(_id);
 	TR_GL_CALL(glDeleteFramebuffers, 1, &_id);
 }
 
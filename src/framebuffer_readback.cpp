@@ -0,0 +1,239 @@
+#include "../include/tr/framebuffer_readback.hpp"
+#include "bitmap_to_gl_format.hpp"
+
+using namespace magic_enum::bitwise_operators;
+
+namespace tr {
+	// Gets the pitch of a row of pixels packed by glReadPixels with the default pack alignment of 4.
+	std::size_t packedPitch(int width, BitmapFormat format) noexcept;
+	// Creates an empty vector of readback IDs with reserved capacity.
+	std::vector<std::uint64_t> reservedIds(std::size_t capacity);
+} // namespace tr
+
+std::size_t tr::packedPitch(int width, BitmapFormat format) noexcept
+{
+	return (std::size_t(width) * format.pixelBytes() + 3) / 4 * 4;
+}
+
+std::vector<std::uint64_t> tr::reservedIds(std::size_t capacity)
+{
+	std::vector<std::uint64_t> ids;
+	ids.reserve(capacity);
+	return ids;
+}
+
+tr::FramebufferReadback::FramebufferReadback(glm::ivec2 maxSize, BitmapFormat format, std::size_t slots)
+	: _buffer{GraphicsBuffer::Target::PIXEL_PACK_BUFFER, packedPitch(maxSize.x, format) * maxSize.y * slots,
+			  GraphicsBuffer::Flag::READABLE | GraphicsBuffer::Flag::PERSISTENT | GraphicsBuffer::Flag::COHERENT}
+	, _map{_buffer.mapRegion(0, _buffer.size(),
+							 GraphicsBuffer::MapFlag::READABLE | GraphicsBuffer::MapFlag::PERSISTENT |
+								 GraphicsBuffer::MapFlag::COHERENT)}
+	, _slots(slots)
+	, _maxSize{maxSize}
+	, _format{format}
+	, _slotSize{packedPitch(maxSize.x, format) * maxSize.y}
+	, _nextId{0}
+{
+	assert(maxSize.x > 0 && maxSize.y > 0 && slots > 0);
+}
+
+void tr::FramebufferReadback::FenceDeleter::operator()(void* sync) const noexcept
+{
+	TR_GL_CALL(glDeleteSync, static_cast<GLsync>(sync));
+}
+
+glm::ivec2 tr::FramebufferReadback::maxSize() const noexcept
+{
+	return _maxSize;
+}
+
+tr::BitmapFormat tr::FramebufferReadback::format() const noexcept
+{
+	return _format;
+}
+
+std::size_t tr::FramebufferReadback::inFlight() const noexcept
+{
+	return std::ranges::count_if(_slots, [](const Slot& slot) { return slot.fence != nullptr; });
+}
+
+std::optional<std::uint64_t> tr::FramebufferReadback::read(const BasicFramebuffer& framebuffer,
+														   const RectI2& rect) noexcept
+{
+	assert(rect.size.x <= _maxSize.x && rect.size.y <= _maxSize.y);
+
+	const auto it{std::ranges::find_if(_slots, [](const Slot& slot) { return slot.fence == nullptr; })};
+	if (it == _slots.end()) {
+		return std::nullopt;
+	}
+
+	const auto [glFormat, glType]{bitmapToGLFormat(_format)};
+	const std::size_t offset{std::size_t(it - _slots.begin()) * _slotSize};
+	framebuffer.bindRead();
+	_buffer.bind();
+	TR_GL_CALL(glReadPixels, rect.tl.x, rect.tl.y, rect.size.x, rect.size.y, glFormat, glType,
+			   reinterpret_cast<void*>(offset));
+	// Unbind the buffer so that client memory reads (like BasicFramebuffer::readRegion()) keep working.
+	TR_GL_CALL(glBindBuffer, GL_PIXEL_PACK_BUFFER, 0);
+
+	it->fence.reset(TR_RETURNING_GL_CALL(glFenceSync, GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	it->id = _nextId++;
+	it->size = rect.size;
+	return it->id;
+}
+
+std::size_t tr::FramebufferReadback::findSlot(std::uint64_t id) const noexcept
+{
+	const auto it{
+		std::ranges::find_if(_slots, [=](const Slot& slot) { return slot.fence != nullptr && slot.id == id; })};
+	assert(it != _slots.end());
+	return it - _slots.begin();
+}
+
+bool tr::FramebufferReadback::ready(std::uint64_t id) const noexcept
+{
+	const GLsync sync{static_cast<GLsync>(_slots[findSlot(id)].fence.get())};
+	const GLenum status{TR_RETURNING_GL_CALL(glClientWaitSync, sync, 0, 0)};
+	// GL_WAIT_FAILED doesn't mean the copy finished, so the slot must not be read yet.
+	return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+tr::Bitmap tr::FramebufferReadback::collect(std::size_t slot)
+{
+	const glm::ivec2  size{_slots[slot].size};
+	const std::size_t pitch{packedPitch(size.x, _format)};
+	const std::size_t rowBytes{std::size_t(size.x) * _format.pixelBytes()};
+	Bitmap            bitmap{size, _format};
+
+	const std::byte* src{_map.span().data() + slot * _slotSize};
+	std::byte*       dst{bitmap.data()};
+	for (int y = 0; y < size.y; ++y, src += pitch, dst += bitmap.pitch()) {
+		std::copy_n(src, rowBytes, dst);
+	}
+
+	_slots[slot].fence.reset();
+	return bitmap;
+}
+
+std::optional<tr::Bitmap> tr::FramebufferReadback::poll(std::uint64_t id)
+{
+	if (!ready(id)) {
+		return std::nullopt;
+	}
+	return collect(findSlot(id));
+}
+
+tr::Bitmap tr::FramebufferReadback::wait(std::uint64_t id)
+{
+	const std::size_t slot{findSlot(id)};
+	const GLsync      sync{static_cast<GLsync>(_slots[slot].fence.get())};
+	while (TR_RETURNING_GL_CALL(glClientWaitSync, sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000) == GL_TIMEOUT_EXPIRED) {
+	}
+	return collect(slot);
+}
+
+void tr::FramebufferReadback::cancel(std::uint64_t id) noexcept
+{
+	_slots[findSlot(id)].fence.reset();
+}
+
+void tr::FramebufferReadback::setLabel(std::string_view label) noexcept
+{
+	_buffer.setLabel(label);
+}
+
+tr::FramebufferStream::FramebufferStream(glm::ivec2 maxSize, BitmapFormat format, Encoder encoder, std::size_t slots,
+										 std::size_t maxQueued)
+	: _readback{maxSize, format, slots}
+	// Everything that can throw has to happen before the thread starts, as a joinable thread can't be destroyed.
+	, _inFlight{reservedIds(slots)}
+	, _encoder{std::move(encoder)}
+	, _maxQueued{maxQueued}
+	, _captured{0}
+	, _dropped{0}
+	, _stopping{false}
+	, _thread{&FramebufferStream::work, this}
+{
+	assert(maxQueued > 0);
+}
+
+tr::FramebufferStream::~FramebufferStream() noexcept
+{
+	{
+		std::lock_guard lock{_mutex};
+		_stopping = true;
+	}
+	_condition.notify_one();
+	_thread.join();
+}
+
+std::size_t tr::FramebufferStream::captured() const noexcept
+{
+	return _captured;
+}
+
+std::size_t tr::FramebufferStream::dropped() const noexcept
+{
+	return _dropped;
+}
+
+std::size_t tr::FramebufferStream::queued() const noexcept
+{
+	std::lock_guard lock{_mutex};
+	return _queue.size();
+}
+
+bool tr::FramebufferStream::capture(const BasicFramebuffer& framebuffer, const RectI2& rect) noexcept
+{
+	const std::optional<std::uint64_t> id{_readback.read(framebuffer, rect)};
+	if (!id.has_value()) {
+		++_dropped;
+		return false;
+	}
+	// Space for every slot was reserved on construction, so this never allocates.
+	_inFlight.push_back(*id);
+	return true;
+}
+
+void tr::FramebufferStream::update()
+{
+	// Collect in capture order so that frames reach the encoder in order.
+	while (!_inFlight.empty() && _readback.ready(_inFlight.front())) {
+		const std::uint64_t id{_inFlight.front()};
+		{
+			std::lock_guard lock{_mutex};
+			if (_queue.size() >= _maxQueued) {
+				_readback.cancel(id);
+				_inFlight.erase(_inFlight.begin());
+				++_dropped;
+				continue;
+			}
+		}
+
+		Bitmap frame{*_readback.poll(id)};
+		_inFlight.erase(_inFlight.begin());
+		{
+			std::lock_guard lock{_mutex};
+			_queue.push_back(std::move(frame));
+		}
+		++_captured;
+		_condition.notify_one();
+	}
+}
+
+void tr::FramebufferStream::work() noexcept
+{
+	std::unique_lock lock{_mutex};
+	while (true) {
+		_condition.wait(lock, [this] { return _stopping || !_queue.empty(); });
+		if (_queue.empty()) {
+			return;
+		}
+
+		Bitmap frame{std::move(_queue.front())};
+		_queue.pop_front();
+		lock.unlock();
+		_encoder(std::move(frame));
+		lock.lock();
+	}
+}
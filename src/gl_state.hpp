@@ -0,0 +1,174 @@
+#pragma once
+#include "../include/tr/color.hpp"
+#include "../include/tr/geometry.hpp"
+#include "gl_call.hpp"
+
+namespace tr {
+	// Defined by the OpenGL standard.
+	inline constexpr int GL_STATE_TEX_UNITS{80};
+
+	// Shadow copy of the GL state set through libtr, used to skip redundant state changes.
+	// An empty optional means the value isn't known and the next change to it must be issued.
+	struct GLStateCache {
+		// Stencil state of one polygon face.
+		struct StencilFaceState {
+			std::optional<std::tuple<GLenum, int, std::uint32_t>> test;      // Function, reference value and mask.
+			std::optional<std::tuple<GLenum, GLenum, GLenum>>     operation; // sfail, dfail and dpass operations.
+			std::optional<std::uint32_t>                          writeMask; // Stencil write mask.
+		};
+
+		// Blend equations and factors: rgbFn, alphaFn, rgbSrc, rgbDst, alphaSrc, alphaDst.
+		using BlendState = std::tuple<GLenum, GLenum, GLenum, GLenum, GLenum, GLenum>;
+
+		bool          enabled{true}; // Whether redundant changes are elided.
+		std::uint64_t issued{0};     // The number of state changes passed to GL.
+		std::uint64_t elided{0};     // The number of state changes skipped as redundant.
+
+		std::optional<GLuint>                                 readFramebuffer; // The bound read framebuffer.
+		std::optional<GLuint>                                 drawFramebuffer; // The bound draw framebuffer.
+		std::optional<GLuint>                                 pipeline;        // The bound program pipeline.
+		std::optional<GLuint>                                 vertexArray;     // The bound vertex array.
+		std::optional<std::tuple<GLuint, GLintptr, int>>      vertexBuffer;    // Vertex array binding 0.
+		std::optional<GLuint>                                 indexBuffer;     // The vertex array's index buffer.
+		std::optional<GLuint>                                 indirectBuffer;  // The bound draw indirect buffer.
+		std::array<std::optional<GLuint>, GL_STATE_TEX_UNITS> textures;        // The textures bound to each unit.
+		std::array<std::optional<GLuint>, GL_STATE_TEX_UNITS> samplers;        // The samplers bound to each unit.
+		std::optional<RectI2>                                 viewport;
+		std::optional<std::pair<double, double>>              depthRange;
+		std::optional<bool>                                   faceCulling;
+		std::optional<bool>                                   scissorTest;
+		std::optional<RectI2>                                 scissorBox;
+		std::optional<bool>                                   stencilTest;
+		StencilFaceState                                      stencilFront;
+		StencilFaceState                                      stencilBack;
+		std::optional<bool>                                   depthTest;
+		std::optional<GLenum>                                 depthFunc;
+		std::optional<bool>                                   blending;
+		std::optional<BlendState>                             blendMode;
+		std::optional<RGBAF>                                  blendColor;
+		std::optional<std::array<bool, 4>>                    colorMask;
+		std::optional<RGBAF>                                  clearColor;
+		std::optional<float>                                  clearDepth;
+		std::optional<int>                                    clearStencil;
+
+		// Records a state change, returning whether it must be passed to GL.
+		template <class T> bool change(std::optional<T>& cached, const T& value) noexcept;
+		// Records a stencil state change for one or both faces, returning whether it must be passed to GL.
+		template <class T>
+		bool changeStencil(GLenum face, std::optional<T> StencilFaceState::*member, const T& value) noexcept;
+
+		// Forgets everything, used when the GL state is changed behind libtr's back.
+		void invalidate() noexcept;
+
+		// Forgets bindings of objects that are about to be deleted, since GL may reuse their names.
+		void forgetFramebuffer(GLuint id) noexcept;
+		void forgetPipeline(GLuint id) noexcept;
+		void forgetVertexArray(GLuint id) noexcept;
+		void forgetBuffer(GLuint id) noexcept;
+		void forgetTexture(GLuint id) noexcept;
+		void forgetSampler(GLuint id) noexcept;
+	};
+
+	// The state cache of the graphics context.
+	inline GLStateCache _glState;
+} // namespace tr
+
+template <class T> bool tr::GLStateCache::change(std::optional<T>& cached, const T& value) noexcept
+{
+	if (enabled && cached == value) {
+		++elided;
+		return false;
+	}
+	else {
+		cached = value;
+		++issued;
+		return true;
+	}
+}
+
+template <class T>
+bool tr::GLStateCache::changeStencil(GLenum face, std::optional<T> StencilFaceState::*member, const T& value) noexcept
+{
+	const bool front{face != GL_BACK};
+	const bool back{face != GL_FRONT};
+	if (enabled && (!front || stencilFront.*member == value) && (!back || stencilBack.*member == value)) {
+		++elided;
+		return false;
+	}
+	else {
+		if (front) {
+			stencilFront.*member = value;
+		}
+		if (back) {
+			stencilBack.*member = value;
+		}
+		++issued;
+		return true;
+	}
+}
+
+inline void tr::GLStateCache::invalidate() noexcept
+{
+	GLStateCache state;
+	state.enabled = enabled;
+	state.issued  = issued;
+	state.elided  = elided;
+	*this         = state;
+}
+
+inline void tr::GLStateCache::forgetFramebuffer(GLuint id) noexcept
+{
+	if (readFramebuffer == id) {
+		readFramebuffer.reset();
+	}
+	if (drawFramebuffer == id) {
+		drawFramebuffer.reset();
+	}
+}
+
+inline void tr::GLStateCache::forgetPipeline(GLuint id) noexcept
+{
+	if (pipeline == id) {
+		pipeline.reset();
+	}
+}
+
+inline void tr::GLStateCache::forgetVertexArray(GLuint id) noexcept
+{
+	if (vertexArray == id) {
+		vertexArray.reset();
+		vertexBuffer.reset();
+		indexBuffer.reset();
+	}
+}
+
+inline void tr::GLStateCache::forgetBuffer(GLuint id) noexcept
+{
+	if (vertexBuffer.has_value() && std::get<0>(*vertexBuffer) == id) {
+		vertexBuffer.reset();
+	}
+	if (indexBuffer == id) {
+		indexBuffer.reset();
+	}
+	if (indirectBuffer == id) {
+		indirectBuffer.reset();
+	}
+}
+
+inline void tr::GLStateCache::forgetTexture(GLuint id) noexcept
+{
+	for (std::optional<GLuint>& texture : textures) {
+		if (texture == id) {
+			texture.reset();
+		}
+	}
+}
+
+inline void tr::GLStateCache::forgetSampler(GLuint id) noexcept
+{
+	for (std::optional<GLuint>& sampler : samplers) {
+		if (sampler == id) {
+			sampler.reset();
+		}
+	}
+}
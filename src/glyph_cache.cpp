@@ -0,0 +1,156 @@
+#include "../include/tr/bitmap_iterators.hpp"
+#include "../include/tr/glyph_cache.hpp"
+
+namespace tr {
+	// Finds the bounding box of the non-transparent pixels of a bitmap, or an empty rect if it is fully transparent.
+	RectI2 findInkBounds(const Bitmap& bitmap) noexcept;
+} // namespace tr
+
+tr::RectI2 tr::findInkBounds(const Bitmap& bitmap) noexcept
+{
+	glm::ivec2 min{bitmap.size()};
+	glm::ivec2 max{-1, -1};
+	for (int y = 0; y < bitmap.size().y; ++y) {
+		for (int x = 0; x < bitmap.size().x; ++x) {
+			if (static_cast<RGBA8>(bitmap[{x, y}]).a != 0) {
+				min = glm::min(min, {x, y});
+				max = glm::max(max, {x, y});
+			}
+		}
+	}
+	return max.x < 0 ? RectI2{} : RectI2{min, max - min + 1};
+}
+
+std::size_t tr::GlyphCache::KeyHash::operator()(const Key& key) const noexcept
+{
+	std::size_t hash{std::hash<const TTFont*>{}(key.font)};
+	const auto  combine{[&](std::size_t value) { hash ^= value + 0x9E3779B97F4A7C15 + (hash << 6) + (hash >> 2); }};
+	combine(key.cp);
+	combine(static_cast<std::size_t>(key.size));
+	combine(key.dpi.x);
+	combine(key.dpi.y);
+	combine(static_cast<std::size_t>(key.style));
+	combine(static_cast<std::size_t>(key.outline));
+	combine(static_cast<std::size_t>(key.hinting));
+	return hash;
+}
+
+tr::GlyphCache::GlyphCache(glm::ivec2 atlasSize)
+	: _atlas{atlasSize}, _frame{0}, _misses{0}
+{
+#ifndef NDEBUG
+	_atlas.setLabel("(tr) Glyph Cache Atlas");
+#endif
+}
+
+const tr::TextureAtlas& tr::GlyphCache::atlas() const noexcept
+{
+	return _atlas;
+}
+
+std::size_t tr::GlyphCache::size() const noexcept
+{
+	return _glyphs.size();
+}
+
+std::size_t tr::GlyphCache::misses() const noexcept
+{
+	return _misses;
+}
+
+const tr::GlyphCache::Entry& tr::GlyphCache::glyph(const TTFont& font, std::uint32_t cp)
+{
+	const Key key{&font, cp, font.size(), font.dpi(), font.style(), font.outline(), font.hinting()};
+	auto      it{_glyphs.find(key)};
+	if (it != _glyphs.end()) {
+		it->second.lastUsed = _frame;
+		return it->second;
+	}
+
+	const TTFont::Glyph metrics{font.glyph(cp)};
+	Entry&              entry{_glyphs.emplace(key, Entry{{}, {}, metrics.adv, _frame}).first->second};
+	if (metrics.max.x != metrics.min.x) {
+		try {
+			const Bitmap bitmap{font.render(cp, {255, 255, 255, 255})};
+			const RectI2 ink{findInkBounds(bitmap)};
+			if (ink.size != glm::ivec2{0, 0}) {
+				// SDL_ttf starts the pen of a rendered glyph far enough in for glyphs with a negative bearing to fit.
+				entry.rect   = insert(bitmap.sub(ink));
+				entry.offset = ink.tl - glm::ivec2{std::max(0, -metrics.min.x), 0};
+			}
+		}
+		catch (...) {
+			_glyphs.erase(key);
+			throw;
+		}
+	}
+	++_misses;
+	return entry;
+}
+
+tr::RectI2 tr::GlyphCache::insert(const SubBitmap& bitmap)
+{
+	std::optional<RectI2> rect{_atlas.insert(bitmap)};
+	if (rect.has_value()) {
+		return *rect;
+	}
+
+	std::vector<std::unordered_map<Key, Entry, KeyHash>::iterator> evictable;
+	for (auto it = _glyphs.begin(); it != _glyphs.end(); ++it) {
+		if (it->second.lastUsed != _frame && it->second.rect.size != glm::ivec2{0, 0}) {
+			evictable.push_back(it);
+		}
+	}
+	std::ranges::sort(evictable, std::less{}, [](auto it) { return it->second.lastUsed; });
+
+	for (auto it : evictable) {
+		_atlas.erase(it->second.rect);
+		_glyphs.erase(it);
+		rect = _atlas.insert(bitmap);
+		if (rect.has_value()) {
+			return *rect;
+		}
+	}
+	throw GlyphCacheOverflow{};
+}
+
+void tr::GlyphCache::addText(BatchRenderer& renderer, BatchState state, const TTFont& font, std::string_view text,
+							 glm::vec2 tl, RGBA8 color)
+{
+	state.texture = &_atlas.texture();
+	_quads.clear();
+	layout(font, text, tl, back_inserter(_quads));
+	for (const GlyphQuad& quad : _quads) {
+		renderer.addSprite(state, quad.rect, quad.uv, color);
+	}
+}
+
+void tr::GlyphCache::upload() noexcept
+{
+	_atlas.upload();
+}
+
+void tr::GlyphCache::nextFrame() noexcept
+{
+	++_frame;
+}
+
+void tr::GlyphCache::erase(const TTFont& font)
+{
+	std::erase_if(_glyphs, [&](const auto& pair) {
+		const auto& [key, entry]{pair};
+		if (key.font != &font) {
+			return false;
+		}
+		if (entry.rect.size != glm::ivec2{0, 0}) {
+			_atlas.erase(entry.rect);
+		}
+		return true;
+	});
+}
+
+void tr::GlyphCache::clear() noexcept
+{
+	_glyphs.clear();
+	_atlas.clear();
+}
@@ -0,0 +1,116 @@
+#include "../include/tr/gpu_benchmark.hpp"
+#include "gl_call.hpp"
+
+tr::GPUBenchmark::GPUBenchmark(std::size_t inFlight, Duration window, std::size_t capacity)
+	: _oldest{0}, _next{0}, _active{false}, _skipping{false}, _skipped{0}, _results{window, capacity}
+{
+	assert(inFlight > 0);
+
+	_slots.reserve(inFlight);
+	for (std::size_t i = 0; i < inFlight; ++i) {
+		GLuint ids[2];
+		TR_GL_CALL(glCreateQueries, GL_TIMESTAMP, 2, ids);
+		_slots.push_back({decltype(Slot::start){ids[0]}, decltype(Slot::end){ids[1]}, false});
+	}
+}
+
+void tr::GPUBenchmark::Deleter::operator()(unsigned int id) const noexcept
+{
+	TR_GL_CALL(glDeleteQueries, 1, &id);
+}
+
+void tr::GPUBenchmark::start() noexcept
+{
+	assert(!_active && !_skipping);
+
+	poll();
+	if (_slots[_next].pending) {
+		_skipping = true;
+		++_skipped;
+		return;
+	}
+	TR_GL_CALL(glQueryCounter, _slots[_next].start.get(), GL_TIMESTAMP);
+	_active = true;
+}
+
+void tr::GPUBenchmark::stop() noexcept
+{
+	assert(_active || _skipping);
+
+	if (_skipping) {
+		_skipping = false;
+		return;
+	}
+	TR_GL_CALL(glQueryCounter, _slots[_next].end.get(), GL_TIMESTAMP);
+	_slots[_next].pending = true;
+	_next                 = (_next + 1) % _slots.size();
+	_active               = false;
+}
+
+void tr::GPUBenchmark::poll() noexcept
+{
+	// Results are read in submission order so the benchmark window stays chronological.
+	while (_slots[_oldest].pending) {
+		Slot&  slot{_slots[_oldest]};
+		GLuint available;
+		TR_GL_CALL(glGetQueryObjectuiv, slot.end.get(), GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			return;
+		}
+
+		GLuint64 start, end;
+		TR_GL_CALL(glGetQueryObjectui64v, slot.start.get(), GL_QUERY_RESULT, &start);
+		TR_GL_CALL(glGetQueryObjectui64v, slot.end.get(), GL_QUERY_RESULT, &end);
+		_results.add(std::chrono::duration_cast<Duration>(NanosecondsI(end - start)));
+		slot.pending = false;
+		_oldest      = (_oldest + 1) % _slots.size();
+	}
+}
+
+void tr::GPUBenchmark::clear() noexcept
+{
+	for (Slot& slot : _slots) {
+		slot.pending = false;
+	}
+	_oldest   = 0;
+	_next     = 0;
+	_active   = false;
+	_skipping = false;
+	_skipped  = 0;
+	_results.clear();
+}
+
+std::size_t tr::GPUBenchmark::skipped() const noexcept
+{
+	return _skipped;
+}
+
+tr::Duration tr::GPUBenchmark::latest() const noexcept
+{
+	return _results.latest();
+}
+
+tr::Duration tr::GPUBenchmark::min() const noexcept
+{
+	return _results.min();
+}
+
+tr::Duration tr::GPUBenchmark::max() const noexcept
+{
+	return _results.max();
+}
+
+tr::Duration tr::GPUBenchmark::average() const noexcept
+{
+	return _results.average();
+}
+
+tr::Duration tr::GPUBenchmark::percentile(double fraction) const noexcept
+{
+	return _results.percentile(fraction);
+}
+
+const tr::Benchmark& tr::GPUBenchmark::results() const noexcept
+{
+	return _results;
+}
@@ -1,5 +1,5 @@
 #include "../include/tr/graphics_buffer.hpp"
-#include "gl_call.hpp"
+#include "gl_state.hpp"
 
 tr::GraphicsBuffer::GraphicsBuffer(Target target, std::size_t size, Flag flags)
 	: _target{target}, _size{size}
@@ -33,6 +33,7 @@ tr::GraphicsBuffer::GraphicsBuffer(Target target, std::span<const std::byte> dat
 
 void tr::GraphicsBuffer::Deleter::operator()(unsigned int id) const noexcept
 {
+	_glState.forgetBuffer(id);
 	TR_GL_CALL(glDeleteBuffers, 1, &id);
 }
 
@@ -92,7 +93,23 @@ void tr::GraphicsBuffer::resetTarget(Target newTarget) noexcept
 
 void tr::GraphicsBuffer::bind(std::optional<Target> target) const noexcept
 {
-	TR_GL_CALL(glBindBuffer, static_cast<GLenum>(target.value_or(_target)), _id.get());
+	const Target           bindTarget{target.value_or(_target)};
+	std::optional<GLuint>* cached{nullptr};
+	switch (bindTarget) {
+	case Target::ELEMENT_ARRAY_BUFFER:
+		cached = &_glState.indexBuffer;
+		break;
+	case Target::DRAW_INDIRECT_BUFFER:
+		cached = &_glState.indirectBuffer;
+		break;
+	default:
+		break;
+	}
+	if (cached != nullptr && !_glState.change(*cached, _id.get())) {
+		return;
+	}
+
+	TR_GL_CALL(glBindBuffer, static_cast<GLenum>(bindTarget), _id.get());
 }
 
 void tr::GraphicsBuffer::bindIndexed(std::optional<Target> target, std::uint32_t index) const noexcept
@@ -1,11 +1,15 @@
 #include "../include/tr/framebuffer.hpp"
 #include "../include/tr/graphics_context.hpp"
 #include "../include/tr/index_buffer.hpp"
+#include "../include/tr/indirect_buffer.hpp"
+#include "../include/tr/pipeline_state.hpp"
 #include "../include/tr/shader_pipeline.hpp"
+#include "../include/tr/streaming_buffer.hpp"
 #include "../include/tr/vertex_buffer.hpp"
 #include "../include/tr/vertex_format.hpp"
 #include "../include/tr/window.hpp"
-#include "gl_call.hpp"
+#include "bindless_texture.hpp"
+#include "gl_state.hpp"
 #include <SDL2/SDL.h>
 
 namespace tr {
@@ -22,12 +26,51 @@ SDL_GLContext tr::createContext(SDL_Window* window)
 	else if (!gladLoadGLLoader(SDL_GL_GetProcAddress)) {
 		throw WindowOpenError{"Failed to load OpenGL 4.6."};
 	}
+	loadBindlessTextureFunctions();
 	return context;
 }
 
+void tr::loadBindlessTextureFunctions() noexcept
+{
+	_bindlessTexture.reset();
+	if (SDL_GL_ExtensionSupported("GL_ARB_bindless_texture")) {
+		_bindlessTexture = BindlessTextureFunctions{
+			reinterpret_cast<decltype(BindlessTextureFunctions::getTextureHandle)>(
+				SDL_GL_GetProcAddress("glGetTextureHandleARB")),
+			reinterpret_cast<decltype(BindlessTextureFunctions::makeTextureHandleResident)>(
+				SDL_GL_GetProcAddress("glMakeTextureHandleResidentARB")),
+			reinterpret_cast<decltype(BindlessTextureFunctions::makeTextureHandleNonResident)>(
+				SDL_GL_GetProcAddress("glMakeTextureHandleNonResidentARB")),
+			{},
+		};
+	}
+}
+
+void tr::acquireTextureHandle(GLuint64 handle)
+{
+	assert(_bindlessTexture.has_value());
+
+	if (++_bindlessTexture->residentHandles[handle] == 1) {
+		TR_GL_CALL(_bindlessTexture->makeTextureHandleResident, handle);
+	}
+}
+
+void tr::releaseTextureHandle(GLuint64 handle) noexcept
+{
+	assert(_bindlessTexture.has_value());
+
+	const auto it{_bindlessTexture->residentHandles.find(handle)};
+	assert(it != _bindlessTexture->residentHandles.end());
+	if (--it->second == 0) {
+		_bindlessTexture->residentHandles.erase(it);
+		TR_GL_CALL(_bindlessTexture->makeTextureHandleNonResident, handle);
+	}
+}
+
 tr::GraphicsContext::GraphicsContext(SDL_Window* window)
 	: _impl{createContext(window)}
 {
+	_glState.invalidate();
 }
 
 void tr::GraphicsContext::Deleter::operator()(SDL_GLContext ptr) const noexcept
@@ -50,14 +93,39 @@ const char* tr::GraphicsContext::versionInfo() const noexcept
 	return reinterpret_cast<const char*>(TR_RETURNING_GL_CALL(glGetString, GL_VERSION));
 }
 
+void tr::GraphicsContext::useStateCache(bool use) noexcept
+{
+	_glState.enabled = use;
+}
+
+void tr::GraphicsContext::invalidateStateCache() noexcept
+{
+	_glState.invalidate();
+}
+
+tr::StateCacheStats tr::GraphicsContext::stateCacheStats() const noexcept
+{
+	return {_glState.issued, _glState.elided};
+}
+
+void tr::GraphicsContext::resetStateCacheStats() noexcept
+{
+	_glState.issued = 0;
+	_glState.elided = 0;
+}
+
 void tr::GraphicsContext::setViewport(const RectI2& viewport) noexcept
 {
-	TR_GL_CALL(glViewport, viewport.tl.x, viewport.tl.y, viewport.size.x, viewport.size.y);
+	if (_glState.change(_glState.viewport, viewport)) {
+		TR_GL_CALL(glViewport, viewport.tl.x, viewport.tl.y, viewport.size.x, viewport.size.y);
+	}
 }
 
 void tr::GraphicsContext::setDepthRange(double min, double max) noexcept
 {
-	TR_GL_CALL(glDepthRange, min, max);
+	if (_glState.change(_glState.depthRange, {min, max})) {
+		TR_GL_CALL(glDepthRange, min, max);
+	}
 }
 
 void tr::GraphicsContext::setFramebuffer(BasicFramebuffer& framebuffer) noexcept
@@ -70,8 +138,54 @@ void tr::GraphicsContext::setShaderPipeline(const ShaderPipeline& pipeline) noex
 	pipeline.bind();
 }
 
+void tr::GraphicsContext::setPipelineState(const PipelineState& state) noexcept
+{
+	if (state.pipeline != nullptr) {
+		setShaderPipeline(*state.pipeline);
+	}
+	if (state.vertexFormat != nullptr) {
+		setVertexFormat(*state.vertexFormat);
+	}
+
+	useBlending(state.blending);
+	if (state.blending) {
+		setBlendingMode(state.blendMode);
+	}
+
+	useDepthTest(state.depthTest);
+	if (state.depthTest) {
+		setDepthTest(state.depthFunc);
+	}
+
+	useStencilTest(state.stencilTest);
+	if (state.stencilTest) {
+		const StencilState& front{state.stencilFront};
+		const StencilState& back{state.stencilBack};
+		if (front == back) {
+			setStencilTest(StencilFace::BOTH, front.func, front.ref, front.readMask);
+			setStencilOperation(StencilFace::BOTH, front.sfail, front.dfail, front.dpass);
+			setStencilMask(StencilFace::BOTH, front.writeMask);
+		}
+		else {
+			setStencilTest(StencilFace::FRONT, front.func, front.ref, front.readMask);
+			setStencilOperation(StencilFace::FRONT, front.sfail, front.dfail, front.dpass);
+			setStencilMask(StencilFace::FRONT, front.writeMask);
+			setStencilTest(StencilFace::BACK, back.func, back.ref, back.readMask);
+			setStencilOperation(StencilFace::BACK, back.sfail, back.dfail, back.dpass);
+			setStencilMask(StencilFace::BACK, back.writeMask);
+		}
+	}
+
+	useFaceCulling(state.faceCulling);
+	setColorMask(state.colorMask[0], state.colorMask[1], state.colorMask[2], state.colorMask[3]);
+}
+
 void tr::GraphicsContext::useFaceCulling(bool use) noexcept
 {
+	if (!_glState.change(_glState.faceCulling, use)) {
+		return;
+	}
+
 	if (use) {
 		TR_GL_CALL(glEnable, GL_CULL_FACE);
 	}
@@ -82,6 +196,10 @@ void tr::GraphicsContext::useFaceCulling(bool use) noexcept
 
 void tr::GraphicsContext::useScissorTest(bool use) noexcept
 {
+	if (!_glState.change(_glState.scissorTest, use)) {
+		return;
+	}
+
 	if (use) {
 		TR_GL_CALL(glEnable, GL_SCISSOR_TEST);
 	}
@@ -92,11 +210,17 @@ void tr::GraphicsContext::useScissorTest(bool use) noexcept
 
 void tr::GraphicsContext::setScissorBox(const RectI2& rect) noexcept
 {
-	TR_GL_CALL(glScissor, rect.tl.x, rect.tl.y, rect.size.x, rect.size.y);
+	if (_glState.change(_glState.scissorBox, rect)) {
+		TR_GL_CALL(glScissor, rect.tl.x, rect.tl.y, rect.size.x, rect.size.y);
+	}
 }
 
 void tr::GraphicsContext::useStencilTest(bool use) noexcept
 {
+	if (!_glState.change(_glState.stencilTest, use)) {
+		return;
+	}
+
 	if (use) {
 		TR_GL_CALL(glEnable, GL_STENCIL_TEST);
 	}
@@ -107,23 +231,35 @@ void tr::GraphicsContext::useStencilTest(bool use) noexcept
 
 void tr::GraphicsContext::setStencilTest(StencilFace face, Compare func, int comp, std::uint32_t mask) noexcept
 {
-	TR_GL_CALL(glStencilFuncSeparate, static_cast<GLenum>(face), static_cast<GLenum>(func), comp, mask);
+	if (_glState.changeStencil(static_cast<GLenum>(face), &GLStateCache::StencilFaceState::test,
+							   {static_cast<GLenum>(func), comp, mask})) {
+		TR_GL_CALL(glStencilFuncSeparate, static_cast<GLenum>(face), static_cast<GLenum>(func), comp, mask);
+	}
 }
 
 void tr::GraphicsContext::setStencilOperation(StencilFace face, StencilOperation sfail, StencilOperation dfail,
 											  StencilOperation dpass) noexcept
 {
-	TR_GL_CALL(glStencilOpSeparate, static_cast<GLenum>(face), static_cast<GLenum>(sfail), static_cast<GLenum>(dfail),
-			   static_cast<GLenum>(dpass));
+	if (_glState.changeStencil(static_cast<GLenum>(face), &GLStateCache::StencilFaceState::operation,
+							   {static_cast<GLenum>(sfail), static_cast<GLenum>(dfail), static_cast<GLenum>(dpass)})) {
+		TR_GL_CALL(glStencilOpSeparate, static_cast<GLenum>(face), static_cast<GLenum>(sfail),
+				   static_cast<GLenum>(dfail), static_cast<GLenum>(dpass));
+	}
 }
 
 void tr::GraphicsContext::setStencilMask(StencilFace face, std::uint32_t mask) noexcept
 {
-	TR_GL_CALL(glStencilMaskSeparate, static_cast<GLenum>(face), mask);
+	if (_glState.changeStencil(static_cast<GLenum>(face), &GLStateCache::StencilFaceState::writeMask, mask)) {
+		TR_GL_CALL(glStencilMaskSeparate, static_cast<GLenum>(face), mask);
+	}
 }
 
 void tr::GraphicsContext::useDepthTest(bool use) noexcept
 {
+	if (!_glState.change(_glState.depthTest, use)) {
+		return;
+	}
+
 	if (use) {
 		TR_GL_CALL(glEnable, GL_DEPTH_TEST);
 	}
@@ -134,11 +270,17 @@ void tr::GraphicsContext::useDepthTest(bool use) noexcept
 
 void tr::GraphicsContext::setDepthTest(Compare func) noexcept
 {
-	TR_GL_CALL(glDepthFunc, static_cast<GLenum>(func));
+	if (_glState.change(_glState.depthFunc, static_cast<GLenum>(func))) {
+		TR_GL_CALL(glDepthFunc, static_cast<GLenum>(func));
+	}
 }
 
 void tr::GraphicsContext::useBlending(bool use) noexcept
 {
+	if (!_glState.change(_glState.blending, use)) {
+		return;
+	}
+
 	if (use) {
 		TR_GL_CALL(glEnable, GL_BLEND);
 	}
@@ -149,6 +291,14 @@ void tr::GraphicsContext::useBlending(bool use) noexcept
 
 void tr::GraphicsContext::setBlendingMode(BlendMode blendMode) noexcept
 {
+	const GLStateCache::BlendState state{
+		static_cast<GLenum>(blendMode.rgbFn),  static_cast<GLenum>(blendMode.alphaFn),
+		static_cast<GLenum>(blendMode.rgbSrc), static_cast<GLenum>(blendMode.rgbDst),
+		static_cast<GLenum>(blendMode.alphaSrc), static_cast<GLenum>(blendMode.alphaDst)};
+	if (!_glState.change(_glState.blendMode, state)) {
+		return;
+	}
+
 	TR_GL_CALL(glBlendEquationSeparate, static_cast<GLenum>(blendMode.rgbFn), static_cast<GLenum>(blendMode.alphaFn));
 	TR_GL_CALL(glBlendFuncSeparate, static_cast<GLenum>(blendMode.rgbSrc), static_cast<GLenum>(blendMode.rgbDst),
 			   static_cast<GLenum>(blendMode.alphaSrc), static_cast<GLenum>(blendMode.alphaDst));
@@ -156,27 +306,37 @@ void tr::GraphicsContext::setBlendingMode(BlendMode blendMode) noexcept
 
 void tr::GraphicsContext::setBlendingColor(RGBAF clr)
 {
-	TR_GL_CALL(glBlendColor, clr.r, clr.g, clr.b, clr.a);
+	if (_glState.change(_glState.blendColor, clr)) {
+		TR_GL_CALL(glBlendColor, clr.r, clr.g, clr.b, clr.a);
+	}
 }
 
 void tr::GraphicsContext::setColorMask(bool red, bool green, bool blue, bool alpha) noexcept
 {
-	TR_GL_CALL(glColorMask, red, green, blue, alpha);
+	if (_glState.change(_glState.colorMask, {red, green, blue, alpha})) {
+		TR_GL_CALL(glColorMask, red, green, blue, alpha);
+	}
 }
 
 void tr::GraphicsContext::setClearColor(RGBAF clr) noexcept
 {
-	TR_GL_CALL(glClearColor, clr.r, clr.g, clr.b, clr.a);
+	if (_glState.change(_glState.clearColor, clr)) {
+		TR_GL_CALL(glClearColor, clr.r, clr.g, clr.b, clr.a);
+	}
 }
 
 void tr::GraphicsContext::setClearDepth(float depth) noexcept
 {
-	TR_GL_CALL(glClearDepth, depth);
+	if (_glState.change(_glState.clearDepth, depth)) {
+		TR_GL_CALL(glClearDepth, depth);
+	}
 }
 
 void tr::GraphicsContext::setClearStencil(int stencil) noexcept
 {
-	TR_GL_CALL(glClearStencil, stencil);
+	if (_glState.change(_glState.clearStencil, stencil)) {
+		TR_GL_CALL(glClearStencil, stencil);
+	}
 }
 
 void tr::GraphicsContext::clear(Clear components) noexcept
@@ -195,7 +355,10 @@ void tr::GraphicsContext::setVertexBuffer(const VertexBuffer& buffer, std::size_
 	assert(buffer._buffer.has_value());
 	assert(offset < buffer.size());
 
-	TR_GL_CALL(glBindVertexBuffer, 0, buffer._buffer->_id.get(), offset, vertexStride);
+	const GLuint id{buffer._buffer->_id.get()};
+	if (_glState.change(_glState.vertexBuffer, {id, GLintptr(offset), int(vertexStride)})) {
+		TR_GL_CALL(glBindVertexBuffer, 0, id, offset, vertexStride);
+	}
 }
 
 void tr::GraphicsContext::setIndexBuffer(const IndexBuffer& buffer) noexcept
@@ -205,6 +368,29 @@ void tr::GraphicsContext::setIndexBuffer(const IndexBuffer& buffer) noexcept
 	buffer._buffer->bind();
 }
 
+void tr::GraphicsContext::setVertexBuffer(const StreamingBuffer& buffer, std::size_t offset,
+										  std::size_t vertexStride) noexcept
+{
+	assert(offset < buffer.capacity());
+
+	const GLuint id{buffer._buffer._id.get()};
+	if (_glState.change(_glState.vertexBuffer, {id, GLintptr(offset), int(vertexStride)})) {
+		TR_GL_CALL(glBindVertexBuffer, 0, id, offset, vertexStride);
+	}
+}
+
+void tr::GraphicsContext::setIndexBuffer(const StreamingBuffer& buffer) noexcept
+{
+	buffer._buffer.bind(GraphicsBuffer::Target::ELEMENT_ARRAY_BUFFER);
+}
+
+void tr::GraphicsContext::setIndirectBuffer(const IndirectBuffer& buffer) noexcept
+{
+	assert(buffer._buffer.has_value());
+
+	buffer._buffer->bind(GraphicsBuffer::Target::DRAW_INDIRECT_BUFFER);
+}
+
 void tr::GraphicsContext::draw(Primitive type, std::size_t offset, std::size_t vertices) noexcept
 {
 	TR_GL_CALL(glDrawArrays, static_cast<GLenum>(type), offset, vertices);
@@ -229,6 +415,18 @@ void tr::GraphicsContext::drawIndexedInstances(Primitive type, std::size_t offse
 			   reinterpret_cast<const void*>(offset * sizeof(std::uint16_t)), instances);
 }
 
+void tr::GraphicsContext::drawIndirect(Primitive type, std::size_t offset, std::size_t draws) noexcept
+{
+	TR_GL_CALL(glMultiDrawArraysIndirect, static_cast<GLenum>(type),
+			   reinterpret_cast<const void*>(offset * sizeof(DrawIndirectCommand)), draws, 0);
+}
+
+void tr::GraphicsContext::drawIndexedIndirect(Primitive type, std::size_t offset, std::size_t draws) noexcept
+{
+	TR_GL_CALL(glMultiDrawElementsIndirect, static_cast<GLenum>(type), GL_UNSIGNED_SHORT,
+			   reinterpret_cast<const void*>(offset * sizeof(DrawIndexedIndirectCommand)), draws, 0);
+}
+
 void tr::GraphicsContext::swap() noexcept
 {
 	SDL_GL_SwapWindow(window()._impl.get());
@@ -0,0 +1,150 @@
+#include "../include/tr/indirect_buffer.hpp"
+#include "../include/tr/graphics_context.hpp"
+#include "../include/tr/ranges.hpp"
+
+namespace tr {
+	// The bitmask operators of graphics_context.hpp would otherwise hide these from unqualified lookup within tr.
+	using magic_enum::bitwise_operators::operator|;
+} // namespace tr
+
+static_assert(sizeof(tr::DrawIndirectCommand) == 16, "DrawIndirectCommand must match the OpenGL layout.");
+static_assert(sizeof(tr::DrawIndexedIndirectCommand) == 20, "DrawIndexedIndirectCommand must match the OpenGL layout.");
+
+tr::IndirectDrawBuilder::IndirectDrawBuilder() noexcept
+	: _primitiveSize{0}
+{
+}
+
+tr::IndirectDrawBuilder::IndirectDrawBuilder(Primitive primitive) noexcept
+{
+	assert(primitive == Primitive::POINTS || primitive == Primitive::LINES || primitive == Primitive::TRIS);
+
+	switch (primitive) {
+	case Primitive::POINTS:
+		_primitiveSize = 1;
+		break;
+	case Primitive::LINES:
+		_primitiveSize = 2;
+		break;
+	case Primitive::TRIS:
+		_primitiveSize = 3;
+		break;
+	default:
+		_primitiveSize = 0;
+		break;
+	}
+}
+
+void tr::IndirectDrawBuilder::addDraw(std::size_t offset, std::size_t vertices, int instances,
+									  std::uint32_t baseInstance)
+{
+	if (_primitiveSize != 0 && !_draws.empty() && vertices % _primitiveSize == 0) {
+		DrawIndirectCommand& last{_draws.back()};
+		if (last.vertices % _primitiveSize == 0 && last.firstVertex + last.vertices == offset &&
+			last.instances == std::uint32_t(instances) && last.baseInstance == baseInstance) {
+			last.vertices += vertices;
+			return;
+		}
+	}
+	_draws.push_back({std::uint32_t(vertices), std::uint32_t(instances), std::uint32_t(offset), baseInstance});
+}
+
+void tr::IndirectDrawBuilder::addIndexedDraw(std::size_t offset, std::size_t indices, std::int32_t baseVertex,
+											 int instances, std::uint32_t baseInstance)
+{
+	if (_primitiveSize != 0 && !_indexedDraws.empty() && indices % _primitiveSize == 0) {
+		DrawIndexedIndirectCommand& last{_indexedDraws.back()};
+		if (last.indices % _primitiveSize == 0 && last.firstIndex + last.indices == offset &&
+			last.baseVertex == baseVertex && last.instances == std::uint32_t(instances) &&
+			last.baseInstance == baseInstance) {
+			last.indices += indices;
+			return;
+		}
+	}
+	_indexedDraws.push_back(
+		{std::uint32_t(indices), std::uint32_t(instances), std::uint32_t(offset), baseVertex, baseInstance});
+}
+
+std::span<const tr::DrawIndirectCommand> tr::IndirectDrawBuilder::draws() const noexcept
+{
+	return _draws;
+}
+
+std::span<const tr::DrawIndexedIndirectCommand> tr::IndirectDrawBuilder::indexedDraws() const noexcept
+{
+	return _indexedDraws;
+}
+
+void tr::IndirectDrawBuilder::clear() noexcept
+{
+	_draws.clear();
+	_indexedDraws.clear();
+}
+
+tr::IndirectBuffer::IndirectBuffer() noexcept
+	: _size{0}
+{
+}
+
+tr::IndirectBuffer::IndirectBuffer(std::size_t capacity)
+	: _buffer{{GraphicsBuffer::Target::DRAW_INDIRECT_BUFFER, capacity,
+			   GraphicsBuffer::Flag::DYNAMIC_STORAGE | GraphicsBuffer::Flag::WRITABLE}}
+	, _size{0}
+{
+}
+
+bool tr::IndirectBuffer::empty() const noexcept
+{
+	return _size == 0;
+}
+
+std::size_t tr::IndirectBuffer::size() const noexcept
+{
+	return _size;
+}
+
+std::size_t tr::IndirectBuffer::capacity() const noexcept
+{
+	return _buffer.has_value() ? _buffer->size() : 0;
+}
+
+void tr::IndirectBuffer::clear() noexcept
+{
+	_size = 0;
+}
+
+void tr::IndirectBuffer::set(std::span<const DrawIndirectCommand> commands)
+{
+	assert(!commands.empty());
+
+	resize(commands.size_bytes());
+	_buffer->setRegion(0, rangeBytes(commands));
+}
+
+void tr::IndirectBuffer::set(std::span<const DrawIndexedIndirectCommand> commands)
+{
+	assert(!commands.empty());
+
+	resize(commands.size_bytes());
+	_buffer->setRegion(0, rangeBytes(commands));
+}
+
+void tr::IndirectBuffer::resize(std::size_t newSize)
+{
+	if (newSize > capacity()) {
+		_buffer = GraphicsBuffer{GraphicsBuffer::Target::DRAW_INDIRECT_BUFFER, newSize,
+								 GraphicsBuffer::Flag::DYNAMIC_STORAGE | GraphicsBuffer::Flag::WRITABLE};
+		if (!_label.empty()) {
+			_buffer->setLabel(_label);
+		}
+	}
+	_size = newSize;
+}
+
+void tr::IndirectBuffer::setLabel(std::string label) noexcept
+{
+	_label = std::move(label);
+	if (_buffer.has_value()) {
+		_buffer->setLabel(_label);
+	}
+}
@@ -0,0 +1,236 @@
+#include "../include/tr/mip_chain.hpp"
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TR_MIP_CHAIN_SSE2
+#include <immintrin.h>
+#endif
+
+namespace tr {
+	// Separable 2:1 downsampling kernel.
+	// Destination texel i is the weighted sum of source texels 2i + first to 2i + first + taps - 1.
+	struct MipKernel {
+		std::array<float, 6> weights; // The tap weights, summing to 1.
+		int                  taps;    // The number of taps.
+		int                  first;   // The offset of the first tap relative to 2i.
+	};
+
+	// Gets the kernel of a filter.
+	const MipKernel& mipKernel(MipFilter filter) noexcept;
+	// Gets the sRGB to linear conversion table.
+	const std::array<float, 256>& srgbToLinearTable() noexcept;
+	// Gets the linear to sRGB conversion table, indexed by the linear value scaled to [0, LINEAR_TO_SRGB_STEPS).
+	inline constexpr int LINEAR_TO_SRGB_STEPS{16384};
+	const std::array<std::uint8_t, LINEAR_TO_SRGB_STEPS>& linearToSrgbTable() noexcept;
+
+	// Decodes a bitmap in the RGBA8 pixel format into linear premultiplied texels.
+	void decodeMipLevel(const SubBitmap& bitmap, std::span<glm::vec4> texels, bool srgb) noexcept;
+	// Encodes linear premultiplied texels into a bitmap in the RGBA8 pixel format.
+	void encodeMipLevel(std::span<const glm::vec4> texels, Bitmap& bitmap, bool srgb) noexcept;
+	// Downsamples every row of a level horizontally.
+	void downsampleRows(const glm::vec4* src, glm::ivec2 srcSize, glm::vec4* dst, int dstWidth,
+						const MipKernel& kernel) noexcept;
+	// Downsamples the columns of a level vertically.
+	void downsampleColumns(const glm::vec4* src, glm::ivec2 srcSize, glm::vec4* dst, int dstHeight,
+						   const MipKernel& kernel) noexcept;
+} // namespace tr
+
+const tr::MipKernel& tr::mipKernel(MipFilter filter) noexcept
+{
+	static const MipKernel BOX{{0.5f, 0.5f}, 2, 0};
+	static const MipKernel KAISER{[] {
+		// Modified Bessel function of the first kind of order 0.
+		const auto bessel0{[](double x) {
+			double sum{1}, term{1};
+			for (int k = 1; k < 32; ++k) {
+				term *= (x / (2 * k)) * (x / (2 * k));
+				sum += term;
+			}
+			return sum;
+		}};
+		constexpr double ALPHA{4};
+		constexpr double RADIUS{3};
+
+		MipKernel kernel{{}, 6, -2};
+		double    total{0};
+		for (int k = 0; k < kernel.taps; ++k) {
+			// Distance from the destination texel center in source texels.
+			const double d{k + kernel.first - 0.5};
+			const double x{std::numbers::pi * d / 2};
+			const double t{d / RADIUS};
+			const double weight{std::sin(x) / x * bessel0(ALPHA * std::sqrt(1 - t * t)) / bessel0(ALPHA)};
+			kernel.weights[k] = static_cast<float>(weight);
+			total += weight;
+		}
+		for (int k = 0; k < kernel.taps; ++k) {
+			kernel.weights[k] = static_cast<float>(kernel.weights[k] / total);
+		}
+		return kernel;
+	}()};
+
+	return filter == MipFilter::KAISER ? KAISER : BOX;
+}
+
+const std::array<float, 256>& tr::srgbToLinearTable() noexcept
+{
+	static const std::array<float, 256> TABLE{[] {
+		std::array<float, 256> table;
+		for (int i = 0; i < 256; ++i) {
+			const float c{i / 255.0f};
+			table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+		return table;
+	}()};
+	return TABLE;
+}
+
+const std::array<std::uint8_t, tr::LINEAR_TO_SRGB_STEPS>& tr::linearToSrgbTable() noexcept
+{
+	static const std::array<std::uint8_t, LINEAR_TO_SRGB_STEPS> TABLE{[] {
+		std::array<std::uint8_t, LINEAR_TO_SRGB_STEPS> table;
+		for (int i = 0; i < LINEAR_TO_SRGB_STEPS; ++i) {
+			const float c{float(i) / (LINEAR_TO_SRGB_STEPS - 1)};
+			const float s{c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1 / 2.4f) - 0.055f};
+			table[i] = static_cast<std::uint8_t>(std::lround(std::clamp(s, 0.0f, 1.0f) * 255));
+		}
+		return table;
+	}()};
+	return TABLE;
+}
+
+void tr::decodeMipLevel(const SubBitmap& bitmap, std::span<glm::vec4> texels, bool srgb) noexcept
+{
+	const std::array<float, 256>& table{srgbToLinearTable()};
+	const glm::ivec2              size{bitmap.size()};
+	for (int y = 0; y < size.y; ++y) {
+		const RGBA8* row{reinterpret_cast<const RGBA8*>(bitmap.data() + y * bitmap.pitch())};
+		glm::vec4*   dst{texels.data() + std::size_t(y) * size.x};
+		for (int x = 0; x < size.x; ++x) {
+			const RGBA8 texel{row[x]};
+			const float alpha{texel.a / 255.0f};
+			if (srgb) {
+				dst[x] = {table[texel.r] * alpha, table[texel.g] * alpha, table[texel.b] * alpha, alpha};
+			}
+			else {
+				dst[x] = {texel.r / 255.0f * alpha, texel.g / 255.0f * alpha, texel.b / 255.0f * alpha, alpha};
+			}
+		}
+	}
+}
+
+void tr::encodeMipLevel(std::span<const glm::vec4> texels, Bitmap& bitmap, bool srgb) noexcept
+{
+	const std::array<std::uint8_t, LINEAR_TO_SRGB_STEPS>& table{linearToSrgbTable()};
+	const auto encode{[&](float value) {
+		value = std::clamp(value, 0.0f, 1.0f);
+		return srgb ? table[static_cast<int>(value * (LINEAR_TO_SRGB_STEPS - 1) + 0.5f)]
+					: static_cast<std::uint8_t>(value * 255 + 0.5f);
+	}};
+
+	const glm::ivec2 size{bitmap.size()};
+	for (int y = 0; y < size.y; ++y) {
+		RGBA8*           row{reinterpret_cast<RGBA8*>(bitmap.data() + y * bitmap.pitch())};
+		const glm::vec4* src{texels.data() + std::size_t(y) * size.x};
+		for (int x = 0; x < size.x; ++x) {
+			const float     alpha{std::clamp(src[x].w, 0.0f, 1.0f)};
+			const glm::vec3 color{alpha > 0 ? glm::vec3{src[x]} / alpha : glm::vec3{0}};
+			row[x] = {encode(color.x), encode(color.y), encode(color.z),
+					  static_cast<std::uint8_t>(alpha * 255 + 0.5f)};
+		}
+	}
+}
+
+void tr::downsampleRows(const glm::vec4* src, glm::ivec2 srcSize, glm::vec4* dst, int dstWidth,
+						const MipKernel& kernel) noexcept
+{
+	for (int y = 0; y < srcSize.y; ++y, src += srcSize.x, dst += dstWidth) {
+		for (int x = 0; x < dstWidth; ++x) {
+#ifdef TR_MIP_CHAIN_SSE2
+			__m128 sum{_mm_setzero_ps()};
+			for (int k = 0; k < kernel.taps; ++k) {
+				const int    sx{std::clamp(2 * x + kernel.first + k, 0, srcSize.x - 1)};
+				const __m128 texel{_mm_loadu_ps(&src[sx].x)};
+				sum = _mm_add_ps(sum, _mm_mul_ps(texel, _mm_set1_ps(kernel.weights[k])));
+			}
+			_mm_storeu_ps(&dst[x].x, sum);
+#else
+			glm::vec4 sum{0};
+			for (int k = 0; k < kernel.taps; ++k) {
+				sum += src[std::clamp(2 * x + kernel.first + k, 0, srcSize.x - 1)] * kernel.weights[k];
+			}
+			dst[x] = sum;
+#endif
+		}
+	}
+}
+
+void tr::downsampleColumns(const glm::vec4* src, glm::ivec2 srcSize, glm::vec4* dst, int dstHeight,
+						   const MipKernel& kernel) noexcept
+{
+	// Whole rows are accumulated at a time to keep memory accesses sequential.
+	for (int y = 0; y < dstHeight; ++y, dst += srcSize.x) {
+		std::fill_n(dst, srcSize.x, glm::vec4{0});
+		for (int k = 0; k < kernel.taps; ++k) {
+			const int        sy{std::clamp(2 * y + kernel.first + k, 0, srcSize.y - 1)};
+			const glm::vec4* row{src + std::size_t(sy) * srcSize.x};
+			const float      weight{kernel.weights[k]};
+#ifdef TR_MIP_CHAIN_SSE2
+			const __m128 factor{_mm_set1_ps(weight)};
+			for (int x = 0; x < srcSize.x; ++x) {
+				const __m128 texel{_mm_loadu_ps(&row[x].x)};
+				_mm_storeu_ps(&dst[x].x, _mm_add_ps(_mm_loadu_ps(&dst[x].x), _mm_mul_ps(texel, factor)));
+			}
+#else
+			for (int x = 0; x < srcSize.x; ++x) {
+				dst[x] += row[x] * weight;
+			}
+#endif
+		}
+	}
+}
+
+int tr::mipLevelCount(glm::ivec2 size) noexcept
+{
+	assert(size.x > 0 && size.y > 0);
+
+	return std::bit_width(static_cast<unsigned int>(std::max(size.x, size.y)));
+}
+
+std::vector<tr::Bitmap> tr::buildMipChain(const SubBitmap& bitmap, MipFilter filter, bool srgb)
+{
+	const BitmapFormat FORMAT{BITMAP_PIXEL_FORMAT<RGBA8>};
+
+	std::optional<Bitmap> converted;
+	if (bitmap.format() != FORMAT) {
+		converted.emplace(bitmap, FORMAT);
+	}
+
+	glm::ivec2             size{bitmap.size()};
+	std::vector<glm::vec4> level(std::size_t(size.x) * size.y);
+	std::vector<glm::vec4> temp;
+	std::vector<Bitmap>    chain;
+	chain.reserve(mipLevelCount(size) - 1);
+	decodeMipLevel(converted.has_value() ? SubBitmap{*converted} : bitmap, level, srgb);
+
+	const MipKernel& kernel{mipKernel(filter)};
+	while (size.x > 1 || size.y > 1) {
+		const glm::ivec2 next{glm::max(size / 2, glm::ivec2{1})};
+
+		// An axis of size 1 is left as is, the other one is downsampled on its own.
+		if (next.x != size.x) {
+			temp.resize(std::size_t(next.x) * size.y);
+			downsampleRows(level.data(), size, temp.data(), next.x, kernel);
+			std::swap(level, temp);
+		}
+		if (next.y != size.y) {
+			temp.resize(std::size_t(next.x) * next.y);
+			downsampleColumns(level.data(), {next.x, size.y}, temp.data(), next.y, kernel);
+			std::swap(level, temp);
+		}
+		size = next;
+
+		Bitmap& output{chain.emplace_back(size, FORMAT)};
+		encodeMipLevel(level, output, srgb);
+	}
+	return chain;
+}
@@ -0,0 +1,68 @@
+#include "../include/tr/pipeline_state.hpp"
+#include "../include/tr/shader_pipeline.hpp"
+#include "../include/tr/vertex_format.hpp"
+
+namespace tr {
+	// Hashes a sequence of values with FNV-1a and folds the hash down to a number of bits.
+	std::uint64_t foldedStateHash(std::initializer_list<std::uint32_t> values, int bits) noexcept;
+} // namespace tr
+
+std::uint64_t tr::foldedStateHash(std::initializer_list<std::uint32_t> values, int bits) noexcept
+{
+	std::uint64_t hash{0xCBF29CE484222325};
+	for (std::uint32_t value : values) {
+		hash = (hash ^ value) * 0x100000001B3;
+	}
+
+	std::uint64_t folded{0};
+	for (; hash != 0; hash >>= bits) {
+		folded ^= hash;
+	}
+	return folded & ((std::uint64_t{1} << bits) - 1);
+}
+
+std::uint64_t tr::PipelineState::sortKey() const noexcept
+{
+	// Layout, from the most significant bit:
+	// 18 bits: shader pipeline name.
+	// 10 bits: vertex format name.
+	//  1 bit:  blending,       12 bits: blending mode hash.
+	//  1 bit:  depth test,      3 bits: depth function.
+	//  1 bit:  stencil test,   10 bits: stencil state hash.
+	//  1 bit:  face culling.
+	//  4 bits: color mask.
+	//  3 bits: unused.
+	std::uint64_t key{0};
+	key |= std::uint64_t{pipeline != nullptr ? pipeline->_id.get() & 0x3FFFF : 0} << 46;
+	key |= std::uint64_t{vertexFormat != nullptr ? vertexFormat->_id.get() & 0x3FF : 0} << 36;
+	if (blending) {
+		const std::uint64_t hash{foldedStateHash(
+			{static_cast<std::uint32_t>(blendMode.rgbSrc), static_cast<std::uint32_t>(blendMode.rgbFn),
+			 static_cast<std::uint32_t>(blendMode.rgbDst), static_cast<std::uint32_t>(blendMode.alphaSrc),
+			 static_cast<std::uint32_t>(blendMode.alphaFn), static_cast<std::uint32_t>(blendMode.alphaDst)},
+			12)};
+		key |= (std::uint64_t{1} << 35) | (hash << 23);
+	}
+	if (depthTest) {
+		key |= (std::uint64_t{1} << 22) | ((static_cast<std::uint64_t>(depthFunc) & 0x7) << 19);
+	}
+	if (stencilTest) {
+		const std::uint64_t hash{foldedStateHash(
+			{static_cast<std::uint32_t>(stencilFront.func), static_cast<std::uint32_t>(stencilFront.ref),
+			 stencilFront.readMask, static_cast<std::uint32_t>(stencilFront.sfail),
+			 static_cast<std::uint32_t>(stencilFront.dfail), static_cast<std::uint32_t>(stencilFront.dpass),
+			 stencilFront.writeMask, static_cast<std::uint32_t>(stencilBack.func),
+			 static_cast<std::uint32_t>(stencilBack.ref), stencilBack.readMask,
+			 static_cast<std::uint32_t>(stencilBack.sfail), static_cast<std::uint32_t>(stencilBack.dfail),
+			 static_cast<std::uint32_t>(stencilBack.dpass), stencilBack.writeMask},
+			10)};
+		key |= (std::uint64_t{1} << 18) | (hash << 8);
+	}
+	if (faceCulling) {
+		key |= std::uint64_t{1} << 7;
+	}
+	for (std::size_t i = 0; i < colorMask.size(); ++i) {
+		key |= std::uint64_t{colorMask[i]} << (6 - i);
+	}
+	return key;
+}
@@ -0,0 +1,212 @@
+#include "../include/tr/profiler.hpp"
+#include <atomic>
+
+namespace tr {
+	// A completed zone as stored in a thread buffer.
+	struct ZoneRecord {
+		const char* name;
+		TimePoint   start;
+		TimePoint   end;
+	};
+
+	// Single-producer single-consumer ring buffer of the completed zones of a thread.
+	struct ProfileThreadBuffer {
+		static constexpr std::size_t CAPACITY{8192};
+
+		std::uint32_t                    index;      // The profiler-assigned index of the thread.
+		std::array<ZoneRecord, CAPACITY> records;    // The record ring buffer.
+		std::atomic<std::size_t>         head{0};    // Advanced by the collector.
+		std::atomic<std::size_t>         tail{0};    // Advanced by the owning thread.
+		std::atomic<std::size_t>         dropped{0}; // The number of zones dropped since the last collection.
+	};
+
+	// Guards the buffer registry; never locked on the zone recording path.
+	std::mutex                                        _profilerMutex;
+	std::vector<std::shared_ptr<ProfileThreadBuffer>> _profilerBuffers;
+	std::uint32_t                                     _profilerThreadCount{0};
+	TimePoint                                         _profilerFrameStart{Clock::now()};
+
+	thread_local std::shared_ptr<ProfileThreadBuffer> _profilerThreadBuffer;
+	thread_local bool                                 _profilerThreadBufferFailed{false};
+
+	// Gets the buffer of the calling thread, registering it if necessary. Returns nullptr if registration failed.
+	ProfileThreadBuffer* profilerThreadBuffer() noexcept;
+	// Builds a call tree out of zone records.
+	std::vector<ProfileNode> buildCallTree(std::vector<ZoneRecord>& records);
+	// Writes a JSON-escaped string.
+	void writeJsonString(std::ostream& os, std::string_view str);
+	// Writes a call tree node and its children as complete trace events.
+	void writeChromeTraceNode(std::ostream& os, const ProfileNode& node, std::uint32_t thread, TimePoint origin,
+							  bool& first);
+} // namespace tr
+
+tr::ProfileThreadBuffer* tr::profilerThreadBuffer() noexcept
+{
+	if (_profilerThreadBuffer == nullptr && !_profilerThreadBufferFailed) {
+		try {
+			std::shared_ptr<ProfileThreadBuffer> buffer{std::make_shared<ProfileThreadBuffer>()};
+			std::lock_guard                      lock{_profilerMutex};
+			buffer->index = _profilerThreadCount;
+			_profilerBuffers.push_back(buffer);
+			++_profilerThreadCount;
+			_profilerThreadBuffer = std::move(buffer);
+		}
+		catch (std::bad_alloc&) {
+			// Profiling is silently disabled for this thread.
+			_profilerThreadBufferFailed = true;
+		}
+	}
+	return _profilerThreadBuffer.get();
+}
+
+tr::ProfileZone::ProfileZone(const char* name) noexcept
+	: _name{name}
+{
+	atomic_thread_fence(std::memory_order::relaxed);
+	_start = Clock::now();
+	atomic_thread_fence(std::memory_order::relaxed);
+}
+
+tr::ProfileZone::~ProfileZone() noexcept
+{
+	atomic_thread_fence(std::memory_order::relaxed);
+	const TimePoint end{Clock::now()};
+	atomic_thread_fence(std::memory_order::relaxed);
+
+	ProfileThreadBuffer* buffer{profilerThreadBuffer()};
+	if (buffer == nullptr) {
+		return;
+	}
+
+	const std::size_t tail{buffer->tail.load(std::memory_order::relaxed)};
+	if (tail - buffer->head.load(std::memory_order::acquire) == ProfileThreadBuffer::CAPACITY) {
+		buffer->dropped.fetch_add(1, std::memory_order::relaxed);
+		return;
+	}
+	buffer->records[tail % ProfileThreadBuffer::CAPACITY] = {_name, _start, end};
+	buffer->tail.store(tail + 1, std::memory_order::release);
+}
+
+tr::Duration tr::ProfileNode::selfDuration() const noexcept
+{
+	Duration self{duration};
+	for (const ProfileNode& child : children) {
+		self -= child.duration;
+	}
+	return self;
+}
+
+std::vector<tr::ProfileNode> tr::buildCallTree(std::vector<ZoneRecord>& records)
+{
+	// Parents start no later than their children, and are longer if both start at the same time.
+	std::ranges::sort(records, [](const ZoneRecord& l, const ZoneRecord& r) {
+		return l.start != r.start ? l.start < r.start : l.end > r.end;
+	});
+
+	// Only the last child of a node can be on the stack, so pushing into a parent never invalidates the stack.
+	std::vector<ProfileNode>                        roots;
+	std::vector<std::pair<ProfileNode*, TimePoint>> stack;
+	for (const ZoneRecord& record : records) {
+		while (!stack.empty() && stack.back().second < record.end) {
+			stack.pop_back();
+		}
+		std::vector<ProfileNode>& siblings{stack.empty() ? roots : stack.back().first->children};
+		siblings.push_back({record.name, record.start, record.end - record.start, {}});
+		stack.emplace_back(&siblings.back(), record.end);
+	}
+	return roots;
+}
+
+tr::ProfileFrame tr::collectProfileFrame()
+{
+	ProfileFrame            frame{.start = {}, .end = Clock::now(), .threads = {}, .droppedZones = 0};
+	std::vector<ZoneRecord> records;
+
+	std::lock_guard lock{_profilerMutex};
+	frame.start         = _profilerFrameStart;
+	_profilerFrameStart = frame.end;
+	for (auto it = _profilerBuffers.begin(); it != _profilerBuffers.end();) {
+		ProfileThreadBuffer& buffer{**it};
+		const std::size_t    head{buffer.head.load(std::memory_order::relaxed)};
+		const std::size_t    tail{buffer.tail.load(std::memory_order::acquire)};
+
+		records.clear();
+		for (std::size_t i = head; i < tail; ++i) {
+			records.push_back(buffer.records[i % ProfileThreadBuffer::CAPACITY]);
+		}
+		buffer.head.store(tail, std::memory_order::release);
+		frame.droppedZones += buffer.dropped.exchange(0, std::memory_order::relaxed);
+
+		if (!records.empty()) {
+			frame.threads.push_back({buffer.index, buildCallTree(records)});
+		}
+
+		// The owning thread has exited and everything it recorded has been collected.
+		if (it->use_count() == 1) {
+			it = _profilerBuffers.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	return frame;
+}
+
+void tr::writeJsonString(std::ostream& os, std::string_view str)
+{
+	os << '"';
+	for (char chr : str) {
+		switch (chr) {
+		case '"':
+			os << "\\\"";
+			break;
+		case '\\':
+			os << "\\\\";
+			break;
+		default:
+			if (static_cast<unsigned char>(chr) < 0x20) {
+				os << std::format("\\u{:04x}", chr);
+			}
+			else {
+				os << chr;
+			}
+			break;
+		}
+	}
+	os << '"';
+}
+
+void tr::writeChromeTraceNode(std::ostream& os, const ProfileNode& node, std::uint32_t thread, TimePoint origin,
+							  bool& first)
+{
+	os << (first ? "\n" : ",\n") << "{\"name\":";
+	writeJsonString(os, node.name);
+	os << std::format(R"(,"ph":"X","pid":0,"tid":{},"ts":{:.3f},"dur":{:.3f}}})", thread,
+					  MicrosecondsD{node.start - origin}.count(), MicrosecondsD{node.duration}.count());
+	first = false;
+
+	for (const ProfileNode& child : node.children) {
+		writeChromeTraceNode(os, child, thread, origin, first);
+	}
+}
+
+void tr::writeChromeTrace(std::ostream& os, std::span<const ProfileFrame> frames)
+{
+	const TimePoint origin{!frames.empty() ? frames.front().start : TimePoint{}};
+	bool            first{true};
+
+	os << "{\"traceEvents\":[";
+	for (const ProfileFrame& frame : frames) {
+		os << (first ? "\n" : ",\n")
+		   << std::format(R"({{"name":"Frame","ph":"i","s":"g","pid":0,"tid":0,"ts":{:.3f}}})",
+						  MicrosecondsD{frame.end - origin}.count());
+		first = false;
+
+		for (const ProfileThread& thread : frame.threads) {
+			for (const ProfileNode& root : thread.roots) {
+				writeChromeTraceNode(os, root, thread.index, origin, first);
+			}
+		}
+	}
+	os << "\n]}\n";
+}
@@ -0,0 +1,56 @@
+#include "../include/tr/sampler.hpp"
+#include "gl_state.hpp"
+
+tr::Sampler::Sampler(const SamplerState& state) noexcept
+	: _state{state}
+{
+	assert(state.maxAnisotropy >= 1);
+
+	GLuint id;
+	TR_GL_CALL(glCreateSamplers, 1, &id);
+	_id.reset(id);
+	TR_GL_CALL(glSamplerParameteri, id, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(state.minFilter));
+	TR_GL_CALL(glSamplerParameteri, id, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(state.magFilter));
+	TR_GL_CALL(glSamplerParameteri, id, GL_TEXTURE_WRAP_S, static_cast<GLint>(state.wrap));
+	TR_GL_CALL(glSamplerParameteri, id, GL_TEXTURE_WRAP_T, static_cast<GLint>(state.wrap));
+	TR_GL_CALL(glSamplerParameteri, id, GL_TEXTURE_WRAP_R, static_cast<GLint>(state.wrap));
+	TR_GL_CALL(glSamplerParameterfv, id, GL_TEXTURE_BORDER_COLOR, &state.borderColor.r);
+	if (state.maxAnisotropy > 1) {
+		TR_GL_CALL(glSamplerParameterf, id, GL_TEXTURE_MAX_ANISOTROPY, state.maxAnisotropy);
+	}
+}
+
+void tr::Sampler::Deleter::operator()(unsigned int id) const noexcept
+{
+	_glState.forgetSampler(id);
+	TR_GL_CALL(glDeleteSamplers, 1, &id);
+}
+
+const tr::SamplerState& tr::Sampler::state() const noexcept
+{
+	return _state;
+}
+
+void tr::Sampler::setLabel(std::string_view label) noexcept
+{
+	TR_GL_CALL(glObjectLabel, GL_SAMPLER, _id.get(), label.size(), label.data());
+}
+
+const tr::Sampler& tr::SamplerCache::get(const SamplerState& state)
+{
+	auto it{_samplers.find(state)};
+	if (it == _samplers.end()) {
+		it = _samplers.emplace(state, Sampler{state}).first;
+	}
+	return it->second;
+}
+
+std::size_t tr::SamplerCache::size() const noexcept
+{
+	return _samplers.size();
+}
+
+void tr::SamplerCache::clear() noexcept
+{
+	_samplers.clear();
+}
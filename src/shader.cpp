@@ -1,23 +1,171 @@
 #include "../include/tr/shader.hpp"
 #include "../include/tr/shader_buffer.hpp"
 #include "../include/tr/texture_unit.hpp"
+#include "../include/tr/uniform_buffer.hpp"
 #include "gl_call.hpp"
 
 namespace tr {
-	// Loads, compiles and links a shader program. Returns 0 on failure.
-	GLuint constructProgram(std::span<const std::byte> data, ShaderType type) noexcept;
+	using ShaderHandle  = Handle<GLuint, 0, decltype([](GLuint id) { TR_GL_CALL(glDeleteShader, id); })>;
+	using ProgramHandle = Handle<GLuint, 0, decltype([](GLuint id) { TR_GL_CALL(glDeleteProgram, id); })>;
+
+	// Magic number at the start of cached program binary files.
+	inline constexpr std::array<char, 4> SHADER_BINARY_MAGIC{'T', 'R', 'P', 'B'};
+
+	// Header of a cached program binary file.
+	struct ShaderBinaryHeader {
+		std::array<char, 4> magic;  // SHADER_BINARY_MAGIC.
+		std::uint32_t       format; // The program binary format.
+		std::uint64_t       key;    // The cache key the binary was stored under.
+	};
+
+	// State of the on-disk program binary cache.
+	struct ShaderBinaryCache {
+		std::filesystem::path dir;        // The directory the binaries are stored in.
+		std::vector<GLint>    formats;    // The program binary formats supported by the driver.
+		std::uint64_t         driverHash; // Hash of the driver vendor, renderer and version strings.
+		ShaderCacheStats      stats;      // The cache statistics.
+	};
+
+	// The program binary cache, if enabled.
+	std::optional<ShaderBinaryCache> _shaderBinaryCache;
+
+	// Continues an FNV-1a hash over a sequence of bytes.
+	std::uint64_t shaderCacheHash(std::uint64_t hash, std::span<const std::byte> data) noexcept;
+	// Computes the cache key of a shader.
+	std::uint64_t shaderCacheKey(std::span<const std::byte> data, ShaderType type,
+								 std::span<const SpecializationConstant> constants) noexcept;
+	// Gets the path of a cached program binary.
+	std::filesystem::path shaderCachePath(std::uint64_t key);
+	// Loads a program from the cache. Returns 0 if the program isn't cached or the driver rejects the binary.
+	GLuint loadCachedProgram(std::uint64_t key) noexcept;
+	// Saves a linked program to the cache, silently giving up on failure.
+	void storeCachedProgram(GLuint program, std::uint64_t key) noexcept;
+	// Specializes and links a SPIR-V shader program. Returns 0 on failure.
+	GLuint compileProgram(std::span<const std::byte> data, ShaderType type,
+						  std::span<const SpecializationConstant> constants) noexcept;
+	// Loads, compiles and links a shader program, going through the program binary cache if enabled. Returns 0 on
+	// failure.
+	GLuint constructProgram(std::span<const std::byte> data, ShaderType type,
+							std::span<const SpecializationConstant> constants) noexcept;
 } // namespace tr
 
-GLuint tr::constructProgram(std::span<const std::byte> data, ShaderType type) noexcept
+std::uint64_t tr::shaderCacheHash(std::uint64_t hash, std::span<const std::byte> data) noexcept
 {
-	using ShaderHandle  = Handle<GLuint, 0, decltype([](GLuint id) { TR_GL_CALL(glDeleteShader, id); })>;
-	using ProgramHandle = Handle<GLuint, 0, decltype([](GLuint id) { TR_GL_CALL(glDeleteShader, id); })>;
+	for (std::byte byte : data) {
+		hash = (hash ^ static_cast<std::uint64_t>(byte)) * 0x100000001B3;
+	}
+	return hash;
+}
+
+std::uint64_t tr::shaderCacheKey(std::span<const std::byte> data, ShaderType type,
+								 std::span<const SpecializationConstant> constants) noexcept
+{
+	std::uint64_t hash{_shaderBinaryCache->driverHash};
+	hash = shaderCacheHash(hash, asBytes(type));
+	hash = shaderCacheHash(hash, asBytes(data.size()));
+	hash = shaderCacheHash(hash, data);
+	return shaderCacheHash(hash, std::as_bytes(constants));
+}
+
+std::filesystem::path tr::shaderCachePath(std::uint64_t key)
+{
+	return _shaderBinaryCache->dir / std::format("{:016x}.bin", key);
+}
+
+GLuint tr::loadCachedProgram(std::uint64_t key) noexcept
+{
+	try {
+		const std::filesystem::path path{shaderCachePath(key)};
+		std::ifstream               file{path, std::ios::binary};
+		if (!file.is_open()) {
+			return 0;
+		}
+		const std::vector<std::byte> data{flushBinary(file)};
+		file.close();
+
+		ShaderBinaryHeader header;
+		if (data.size() > sizeof(ShaderBinaryHeader)) {
+			std::memcpy(&header, data.data(), sizeof(ShaderBinaryHeader));
+			// Binaries in a format the driver no longer supports would raise GL_INVALID_ENUM, so filter them out.
+			if (header.magic == SHADER_BINARY_MAGIC && header.key == key &&
+				std::ranges::find(_shaderBinaryCache->formats, static_cast<GLint>(header.format)) !=
+					_shaderBinaryCache->formats.end()) {
+				ProgramHandle program{TR_RETURNING_GL_CALL(glCreateProgram)};
+				TR_GL_CALL(glProgramParameteri, program.get(), GL_PROGRAM_SEPARABLE, GL_TRUE);
+				TR_GL_CALL(glProgramBinary, program.get(), header.format, data.data() + sizeof(ShaderBinaryHeader),
+						   data.size() - sizeof(ShaderBinaryHeader));
+
+				int linked;
+				TR_GL_CALL(glGetProgramiv, program.get(), GL_LINK_STATUS, &linked);
+				if (linked) {
+					++_shaderBinaryCache->stats.hits;
+					return program.release();
+				}
+			}
+		}
+
+		++_shaderBinaryCache->stats.rejected;
+		std::error_code ec;
+		std::filesystem::remove(path, ec);
+	}
+	catch (...) {
+	}
+	return 0;
+}
+
+void tr::storeCachedProgram(GLuint program, std::uint64_t key) noexcept
+{
+	try {
+		int size;
+		TR_GL_CALL(glGetProgramiv, program, GL_PROGRAM_BINARY_LENGTH, &size);
+		if (size <= 0) {
+			return;
+		}
+
+		std::vector<std::byte> data(sizeof(ShaderBinaryHeader) + size);
+		ShaderBinaryHeader     header{SHADER_BINARY_MAGIC, 0, key};
+		GLenum                 format;
+		TR_GL_CALL(glGetProgramBinary, program, size, nullptr, &format, data.data() + sizeof(ShaderBinaryHeader));
+		header.format = format;
+		std::memcpy(data.data(), &header, sizeof(ShaderBinaryHeader));
+
+		// Write to a temporary file first so that a crash or a concurrent loader never sees a partial binary.
+		const std::filesystem::path path{shaderCachePath(key)};
+		std::filesystem::path       tempPath{path};
+		tempPath += ".tmp";
+		std::ofstream file{tempPath, std::ios::binary | std::ios::trunc};
+		if (!file.is_open()) {
+			return;
+		}
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+		file.close();
+
+		std::error_code ec;
+		if (file.fail()) {
+			std::filesystem::remove(tempPath, ec);
+			return;
+		}
+		std::filesystem::rename(tempPath, path, ec);
+	}
+	catch (...) {
+	}
+}
+
+GLuint tr::compileProgram(std::span<const std::byte> data, ShaderType type,
+						  std::span<const SpecializationConstant> constants) noexcept
+{
+	std::vector<GLuint> ids(constants.size());
+	std::vector<GLuint> values(constants.size());
+	for (std::size_t i = 0; i < constants.size(); ++i) {
+		ids[i] = constants[i].id;
+		values[i] = constants[i].value;
+	}
 
 	ShaderHandle  shader{TR_RETURNING_GL_CALL(glCreateShader, static_cast<GLenum>(type))};
 	ProgramHandle program{TR_RETURNING_GL_CALL(glCreateProgram)};
 
 	TR_GL_CALL(glShaderBinary, 1, &shader.get(), GL_SHADER_BINARY_FORMAT_SPIR_V, data.data(), data.size());
-	TR_GL_CALL(glSpecializeShader, shader.get(), "main", 0, nullptr, nullptr);
+	TR_GL_CALL(glSpecializeShader, shader.get(), "main", constants.size(), ids.data(), values.data());
 
 	int compiled;
 	TR_GL_CALL(glGetShaderiv, shader.get(), GL_COMPILE_STATUS, &compiled);
@@ -26,6 +174,9 @@ GLuint tr::constructProgram(std::span<const std::byte> data, ShaderType type) no
 	}
 
 	TR_GL_CALL(glProgramParameteri, program.get(), GL_PROGRAM_SEPARABLE, GL_TRUE);
+	if (_shaderBinaryCache.has_value()) {
+		TR_GL_CALL(glProgramParameteri, program.get(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
 	TR_GL_CALL(glAttachShader, program.get(), shader.get());
 	TR_GL_CALL(glLinkProgram, program.get());
 	TR_GL_CALL(glDetachShader, program.get(), shader.get());
@@ -39,6 +190,25 @@ GLuint tr::constructProgram(std::span<const std::byte> data, ShaderType type) no
 	return program.release();
 }
 
+GLuint tr::constructProgram(std::span<const std::byte> data, ShaderType type,
+							std::span<const SpecializationConstant> constants) noexcept
+{
+	if (!_shaderBinaryCache.has_value()) {
+		return compileProgram(data, type, constants);
+	}
+
+	const std::uint64_t key{shaderCacheKey(data, type, constants)};
+	GLuint              program{loadCachedProgram(key)};
+	if (program == 0) {
+		++_shaderBinaryCache->stats.misses;
+		program = compileProgram(data, type, constants);
+		if (program != 0) {
+			storeCachedProgram(program, key);
+		}
+	}
+	return program;
+}
+
 const char* tr::ShaderLoadError::what() const noexcept
 {
 	static std::string str;
@@ -342,23 +512,60 @@ void tr::Shader::setStorageBuffer(unsigned int index, ShaderBuffer& buffer) noex
 	buffer.bindIndexedRange(GraphicsBuffer::Target::SHADER_STORAGE_BUFFER, index, 0, buffer._headerSize + buffer._size);
 }
 
+void tr::Shader::setUniformBlock(unsigned int index, const UniformBuffer& buffer, UniformBufferBlock block) noexcept
+{
+	buffer.bind(index, block);
+}
+
 void tr::Shader::setLabel(std::string_view label) noexcept
 {
 	TR_GL_CALL(glObjectLabel, GL_PROGRAM, _id.get(), label.size(), label.data());
 }
 
-tr::Shader tr::loadEmbeddedShader(std::span<const std::byte> data, ShaderType type) noexcept
+tr::Shader tr::loadEmbeddedShader(std::span<const std::byte> data, ShaderType type,
+								  std::span<const SpecializationConstant> constants) noexcept
 {
-	return Shader{constructProgram(data, type), type};
+	return Shader{constructProgram(data, type, constants), type};
 }
 
-tr::Shader tr::loadShaderFile(const std::filesystem::path& path, ShaderType type)
+tr::Shader tr::loadShaderFile(const std::filesystem::path& path, ShaderType type,
+							  std::span<const SpecializationConstant> constants)
 {
 	std::ifstream          file{openFileR(path, std::ios::binary)};
 	std::vector<std::byte> data{flushBinary(file)};
-	GLuint                 id{constructProgram(data, type)};
+	GLuint                 id{constructProgram(data, type, constants)};
 	if (id == 0) {
 		throw ShaderLoadError{path};
 	}
 	return Shader{id, type};
-}
\ No newline at end of file
+}
+
+void tr::enableShaderCache(const std::filesystem::path& dir)
+{
+	int formatCount;
+	TR_GL_CALL(glGetIntegerv, GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	if (formatCount <= 0) {
+		return;
+	}
+
+	ShaderBinaryCache cache{dir, std::vector<GLint>(formatCount), 0xCBF29CE484222325, {}};
+	TR_GL_CALL(glGetIntegerv, GL_PROGRAM_BINARY_FORMATS, cache.formats.data());
+	for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+		const char* string{reinterpret_cast<const char*>(TR_RETURNING_GL_CALL(glGetString, name))};
+		// Include the terminator so that strings can't bleed into each other.
+		const std::span<const char> bytes{string, std::strlen(string) + 1};
+		cache.driverHash = shaderCacheHash(cache.driverHash, std::as_bytes(bytes));
+	}
+	std::filesystem::create_directories(dir);
+	_shaderBinaryCache = std::move(cache);
+}
+
+void tr::disableShaderCache() noexcept
+{
+	_shaderBinaryCache.reset();
+}
+
+tr::ShaderCacheStats tr::shaderCacheStats() noexcept
+{
+	return _shaderBinaryCache.has_value() ? _shaderBinaryCache->stats : ShaderCacheStats{0, 0, 0};
+}
@@ -1,5 +1,5 @@
 #include "../include/tr/shader_pipeline.hpp"
-#include "gl_call.hpp"
+#include "gl_state.hpp"
 
 tr::ShaderPipeline::ShaderPipeline(const Shader& vertexShader, const Shader& fragmentShader) noexcept
 {
@@ -15,6 +15,7 @@ tr::ShaderPipeline::ShaderPipeline(const Shader& vertexShader, const Shader& fra
 
 void tr::ShaderPipeline::Deleter::operator()(unsigned int id) const noexcept
 {
+	_glState.forgetPipeline(id);
 	TR_GL_CALL(glDeleteProgramPipelines, 1, &id);
 }
 
@@ -25,7 +26,9 @@ void tr::ShaderPipeline::setLabel(std::string_view label) noexcept
 
 void tr::ShaderPipeline::bind() const noexcept
 {
-	TR_GL_CALL(glBindProgramPipeline, _id.get());
+	if (_glState.change(_glState.pipeline, _id.get())) {
+		TR_GL_CALL(glBindProgramPipeline, _id.get());
+	}
 }
 
 tr::OwningShaderPipeline::OwningShaderPipeline(Shader&& vertexShader, Shader&& fragmentShader) noexcept
@@ -0,0 +1,123 @@
+#include "../include/tr/shader_variant_cache.hpp"
+
+tr::ShaderVariantCache::ShaderVariantCache()
+	: _totalTime{0}
+{
+}
+
+std::size_t tr::ShaderVariantCache::addModule(std::vector<std::byte> data, ShaderType type)
+{
+	_modules.push_back({std::move(data), type, {}});
+	return _modules.size() - 1;
+}
+
+std::size_t tr::ShaderVariantCache::addModuleFile(const std::filesystem::path& path, ShaderType type)
+{
+	std::ifstream file{openFileR(path, std::ios::binary)};
+	_modules.push_back({flushBinary(file), type, path});
+	return _modules.size() - 1;
+}
+
+std::size_t tr::ShaderVariantCache::modules() const noexcept
+{
+	return _modules.size();
+}
+
+std::size_t tr::ShaderVariantCache::variants() const noexcept
+{
+	return _variants.size();
+}
+
+std::size_t tr::ShaderVariantCache::pending() const noexcept
+{
+	return _pending.size();
+}
+
+std::string_view tr::ShaderVariantCache::buildKey(std::size_t module, std::span<const SpecializationConstant> constants)
+{
+	assert(module < _modules.size());
+
+	_constantBuffer.assign(constants.begin(), constants.end());
+	std::ranges::sort(_constantBuffer, std::less{}, &SpecializationConstant::id);
+
+	const std::span<const std::byte> moduleBytes{asBytes(module)};
+	const std::span<const std::byte> constantBytes{rangeBytes(_constantBuffer)};
+	_keyBuffer.clear();
+	_keyBuffer.append(reinterpret_cast<const char*>(moduleBytes.data()), moduleBytes.size());
+	_keyBuffer.append(reinterpret_cast<const char*>(constantBytes.data()), constantBytes.size());
+	return _keyBuffer;
+}
+
+tr::Shader& tr::ShaderVariantCache::compile(std::string key)
+{
+	std::size_t module;
+	std::memcpy(&module, key.data(), sizeof(module));
+	std::vector<SpecializationConstant> constants((key.size() - sizeof(module)) / sizeof(SpecializationConstant));
+	std::copy(key.begin() + sizeof(module), key.end(), reinterpret_cast<char*>(constants.data()));
+
+	const TimePoint start{Clock::now()};
+	Shader          shader{loadEmbeddedShader(_modules[module].data, _modules[module].type, constants)};
+	const Duration  time{Clock::now() - start};
+	_benchmark.add(time);
+	_totalTime += time;
+	// Failed variants aren't cached, so that the error isn't hidden behind an invalid shader on later lookups.
+	if (shader._id.get() == 0) {
+		throw ShaderLoadError{_modules[module].path};
+	}
+
+	return _variants.emplace(std::move(key), std::move(shader)).first->second;
+}
+
+tr::Shader& tr::ShaderVariantCache::get(std::size_t module, std::span<const SpecializationConstant> constants)
+{
+	const std::string_view key{buildKey(module, constants)};
+	const auto             it{_variants.find(key)};
+	return it != _variants.end() ? it->second : compile(std::string{key});
+}
+
+void tr::ShaderVariantCache::prefetch(std::size_t module, std::span<const SpecializationConstant> constants)
+{
+	const std::string_view key{buildKey(module, constants)};
+	if (!_variants.contains(key)) {
+		_pending.emplace_back(key);
+	}
+}
+
+std::size_t tr::ShaderVariantCache::compilePending(Duration budget)
+{
+	const TimePoint end{Clock::now() + budget};
+	std::size_t     compiled{0};
+	std::size_t     next{0};
+	try {
+		while (next < _pending.size() && (compiled == 0 || Clock::now() < end)) {
+			std::string& key{_pending[next++]};
+			// The same variant may have been queued more than once or requested through get() in the meantime.
+			if (!_variants.contains(key)) {
+				compile(std::move(key));
+				++compiled;
+			}
+		}
+	}
+	catch (...) {
+		_pending.erase(_pending.begin(), _pending.begin() + next);
+		throw;
+	}
+	_pending.erase(_pending.begin(), _pending.begin() + next);
+	return compiled;
+}
+
+const tr::Benchmark& tr::ShaderVariantCache::creationTimes() const noexcept
+{
+	return _benchmark;
+}
+
+tr::Duration tr::ShaderVariantCache::totalCreationTime() const noexcept
+{
+	return _totalTime;
+}
+
+void tr::ShaderVariantCache::clear() noexcept
+{
+	_variants.clear();
+	_pending.clear();
+}
@@ -0,0 +1,113 @@
+#include "../include/tr/streaming_buffer.hpp"
+#include "gl_call.hpp"
+
+using namespace magic_enum::bitwise_operators;
+
+tr::StreamingBuffer::StreamingBuffer(std::size_t capacity, std::size_t framesInFlight)
+	: _buffer{GraphicsBuffer::Target::ARRAY_BUFFER, capacity,
+			  GraphicsBuffer::Flag::WRITABLE | GraphicsBuffer::Flag::PERSISTENT | GraphicsBuffer::Flag::COHERENT}
+	, _map{_buffer.mapRegion(0, capacity,
+							 GraphicsBuffer::MapFlag::WRITABLE | GraphicsBuffer::MapFlag::PERSISTENT |
+								 GraphicsBuffer::MapFlag::COHERENT)}
+	, _frames(framesInFlight)
+	, _firstFrame{0}
+	, _frameCount{0}
+	, _head{0}
+	, _used{0}
+	, _frameSize{0}
+	, _stalls{0}
+{
+	assert(framesInFlight > 0);
+}
+
+void tr::StreamingBuffer::FenceDeleter::operator()(void* sync) const noexcept
+{
+	TR_GL_CALL(glDeleteSync, static_cast<GLsync>(sync));
+}
+
+std::size_t tr::StreamingBuffer::capacity() const noexcept
+{
+	return _buffer.size();
+}
+
+std::size_t tr::StreamingBuffer::frameSize() const noexcept
+{
+	return _frameSize;
+}
+
+std::size_t tr::StreamingBuffer::stalls() const noexcept
+{
+	return _stalls;
+}
+
+void tr::StreamingBuffer::retireFrames(bool wait) noexcept
+{
+	while (_frameCount != 0) {
+		Frame&       frame{_frames[_firstFrame]};
+		const GLsync sync{static_cast<GLsync>(frame.fence.get())};
+		GLenum       status{TR_RETURNING_GL_CALL(glClientWaitSync, sync, 0, 0)};
+		if (status == GL_TIMEOUT_EXPIRED) {
+			if (!wait) {
+				return;
+			}
+			++_stalls;
+			do {
+				status = TR_RETURNING_GL_CALL(glClientWaitSync, sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000);
+			} while (status == GL_TIMEOUT_EXPIRED);
+			wait = false;
+		}
+
+		_used -= frame.size;
+		frame.fence.reset();
+		_firstFrame = (_firstFrame + 1) % _frames.size();
+		--_frameCount;
+	}
+}
+
+std::size_t tr::StreamingBuffer::allocateBytes(std::size_t size, std::size_t alignment) noexcept
+{
+	assert(size > 0 && alignment > 0);
+	assert(_frameSize + size <= capacity());
+
+	retireFrames(false);
+	if (_used == 0) {
+		// Nothing is in use, so start from the beginning to avoid wrapping.
+		_head = 0;
+	}
+
+	std::size_t offset{(_head + alignment - 1) / alignment * alignment};
+	if (offset + size > capacity()) {
+		// Wrap around, wasting the end of the buffer.
+		offset = 0;
+	}
+	const std::size_t consumed{offset + size - _head + (offset < _head ? capacity() : 0)};
+	while (_used + consumed > capacity() && _frameCount != 0) {
+		retireFrames(true);
+	}
+	assert(_used + consumed <= capacity());
+
+	_head = offset + size;
+	_used += consumed;
+	_frameSize += consumed;
+	return offset;
+}
+
+void tr::StreamingBuffer::endFrame() noexcept
+{
+	if (_frameSize == 0) {
+		return;
+	}
+
+	if (_frameCount == _frames.size()) {
+		retireFrames(true);
+	}
+	Frame& frame{_frames[(_firstFrame + _frameCount++) % _frames.size()]};
+	frame.fence.reset(TR_RETURNING_GL_CALL(glFenceSync, GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	frame.size = _frameSize;
+	_frameSize = 0;
+}
+
+void tr::StreamingBuffer::setLabel(std::string_view label) noexcept
+{
+	_buffer.setLabel(label);
+}
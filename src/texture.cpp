@@ -1,7 +1,7 @@
 #include "../include/tr/bitmap.hpp"
 #include "../include/tr/texture.hpp"
 #include "bitmap_to_gl_format.hpp"
-#include "gl_call.hpp"
+#include "gl_state.hpp"
 
 namespace tr {
 	// Determines the size of the array texture from a spam of bitmaps.
@@ -25,6 +25,7 @@ tr::Texture::Texture(unsigned int target) noexcept
 
 void tr::Texture::Deleter::operator()(unsigned int id) const noexcept
 {
+	_glState.forgetTexture(id);
 	glDeleteTextures(1, &id);
 }
 
@@ -99,6 +100,18 @@ void tr::ColorTexture::clearRegion(const RectI3& region, const RGBAF& color) noe
 			   region.size.z, GL_RGBA, GL_FLOAT, &color);
 }
 
+int tr::ColorTexture::levels() const noexcept
+{
+	int levels;
+	TR_GL_CALL(glGetTextureParameteriv, _id.get(), GL_TEXTURE_IMMUTABLE_LEVELS, &levels);
+	return levels;
+}
+
+void tr::ColorTexture::generateMipmaps() noexcept
+{
+	TR_GL_CALL(glGenerateTextureMipmap, _id.get());
+}
+
 // void tr::Texture::disableComparison() noexcept
 // {
 // 	TR_GL_CALL(glTextureParameteri, _id.get(), GL_TEXTURE_COMPARE_MODE, GL_NONE);
@@ -278,6 +291,29 @@ void tr::ColorTexture2D::setRegion(glm::ivec2 tl, SubBitmap bitmap) noexcept
 	TR_GL_CALL(glGenerateTextureMipmap, _id.get());
 }
 
+void tr::ColorTexture2D::setLevelRegion(int level, glm::ivec2 tl, SubBitmap bitmap) noexcept
+{
+	assert(level >= 0 && level < levels());
+	assert(RectI2{glm::max(size() / (1 << level), glm::ivec2{1})}.contains(tl + bitmap.size()));
+	auto [format, type]{bitmapToGLFormat(bitmap.format())};
+	TR_GL_CALL(glPixelStorei, GL_UNPACK_ROW_LENGTH, bitmap.pitch() / bitmap.format().pixelBytes());
+	TR_GL_CALL(glTextureSubImage2D, _id.get(), level, tl.x, tl.y, bitmap.size().x, bitmap.size().y, format, type,
+			   bitmap.data());
+}
+
+void tr::ColorTexture2D::setCompressedRegion(int level, glm::ivec2 tl, glm::ivec2 size,
+											  std::span<const std::byte> blocks) noexcept
+{
+	assert(level >= 0 && level < levels());
+	assert(tl.x % 4 == 0 && tl.y % 4 == 0);
+	assert(RectI2{glm::max(this->size() / (1 << level), glm::ivec2{1})}.contains(tl + size));
+
+	int format;
+	TR_GL_CALL(glGetTextureLevelParameteriv, _id.get(), level, GL_TEXTURE_INTERNAL_FORMAT, &format);
+	TR_GL_CALL(glCompressedTextureSubImage2D, _id.get(), level, tl.x, tl.y, size.x, size.y, format,
+			   static_cast<GLsizei>(blocks.size()), blocks.data());
+}
+
 tr::ArrayColorTexture2D::ArrayColorTexture2D(glm::ivec2 size, int layers, bool mipmapped, ColorTextureFormat format)
 	: ColorTexture{GL_TEXTURE_2D_ARRAY}
 {
@@ -0,0 +1,250 @@
+#include "../include/tr/bitmap_iterators.hpp"
+#include "../include/tr/texture_atlas.hpp"
+#include "bitmap_conversion.hpp"
+
+namespace tr {
+	// Determines whether two atlas rects overlap (rects that merely touch don't).
+	bool atlasRectsOverlap(const RectI2& l, const RectI2& r) noexcept;
+
+	// Determines whether an atlas rect is entirely contained within another.
+	bool atlasRectContains(const RectI2& outer, const RectI2& inner) noexcept;
+
+	// Gets the bounding box of two atlas rects.
+	RectI2 atlasBoundingBox(const RectI2& l, const RectI2& r) noexcept;
+
+	// Finds the best free rect to place a rect of a given size in using the best short side fit heuristic.
+	std::vector<RectI2>::const_iterator findAtlasFreeRect(const std::vector<RectI2>& free, glm::ivec2 size) noexcept;
+
+	// Removes the rects in [first, free.end()) contained within another free rect.
+	void pruneAtlasFreeRects(std::vector<RectI2>& free, std::size_t first) noexcept;
+
+	// Splits every free rect overlapping a newly occupied rect into up to four maximal rects around it.
+	void splitAtlasFreeRects(std::vector<RectI2>& free, const RectI2& occupied);
+} // namespace tr
+
+bool tr::atlasRectsOverlap(const RectI2& l, const RectI2& r) noexcept
+{
+	return l.tl.x < r.tl.x + r.size.x && r.tl.x < l.tl.x + l.size.x && l.tl.y < r.tl.y + r.size.y &&
+		   r.tl.y < l.tl.y + l.size.y;
+}
+
+bool tr::atlasRectContains(const RectI2& outer, const RectI2& inner) noexcept
+{
+	return inner.tl.x >= outer.tl.x && inner.tl.y >= outer.tl.y &&
+		   inner.tl.x + inner.size.x <= outer.tl.x + outer.size.x &&
+		   inner.tl.y + inner.size.y <= outer.tl.y + outer.size.y;
+}
+
+tr::RectI2 tr::atlasBoundingBox(const RectI2& l, const RectI2& r) noexcept
+{
+	const glm::ivec2 tl{glm::min(l.tl, r.tl)};
+	const glm::ivec2 br{glm::max(l.tl + l.size, r.tl + r.size)};
+	return {tl, br - tl};
+}
+
+std::vector<tr::RectI2>::const_iterator tr::findAtlasFreeRect(const std::vector<RectI2>& free,
+															   glm::ivec2 size) noexcept
+{
+	auto best{free.end()};
+	int  bestShortSide{std::numeric_limits<int>::max()};
+	int  bestLongSide{std::numeric_limits<int>::max()};
+	for (auto it = free.begin(); it != free.end(); ++it) {
+		if (it->size.x < size.x || it->size.y < size.y) {
+			continue;
+		}
+
+		const glm::ivec2 leftover{it->size - size};
+		const int        shortSide{std::min(leftover.x, leftover.y)};
+		const int        longSide{std::max(leftover.x, leftover.y)};
+		if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+			best          = it;
+			bestShortSide = shortSide;
+			bestLongSide  = longSide;
+		}
+	}
+	return best;
+}
+
+void tr::pruneAtlasFreeRects(std::vector<RectI2>& free, std::size_t first) noexcept
+{
+	// The rects before first are known not to contain one another, and can't be contained within the rects after
+	// it either, as those are pieces of rects that were themselves not contained in any other.
+	for (std::size_t i = first; i < free.size();) {
+		bool contained{false};
+		for (std::size_t j = 0; j < free.size(); ++j) {
+			// Of two identical rects, only the later one is removed.
+			if (i != j && atlasRectContains(free[j], free[i]) && (free[i] != free[j] || j < i)) {
+				contained = true;
+				break;
+			}
+		}
+
+		if (contained) {
+			free[i] = free.back();
+			free.pop_back();
+		}
+		else {
+			++i;
+		}
+	}
+}
+
+void tr::splitAtlasFreeRects(std::vector<RectI2>& free, const RectI2& occupied)
+{
+	const glm::ivec2    occupiedBr{occupied.tl + occupied.size};
+	std::size_t         kept{0};
+	std::vector<RectI2> pieces;
+	for (const RectI2& rect : free) {
+		if (!atlasRectsOverlap(rect, occupied)) {
+			free[kept++] = rect;
+			continue;
+		}
+
+		const glm::ivec2 rectBr{rect.tl + rect.size};
+		if (occupied.tl.x > rect.tl.x) {
+			pieces.push_back({rect.tl, {occupied.tl.x - rect.tl.x, rect.size.y}});
+		}
+		if (occupiedBr.x < rectBr.x) {
+			pieces.push_back({{occupiedBr.x, rect.tl.y}, {rectBr.x - occupiedBr.x, rect.size.y}});
+		}
+		if (occupied.tl.y > rect.tl.y) {
+			pieces.push_back({rect.tl, {rect.size.x, occupied.tl.y - rect.tl.y}});
+		}
+		if (occupiedBr.y < rectBr.y) {
+			pieces.push_back({{rect.tl.x, occupiedBr.y}, {rect.size.x, rectBr.y - occupiedBr.y}});
+		}
+	}
+	free.resize(kept);
+	free.insert(free.end(), pieces.begin(), pieces.end());
+	pruneAtlasFreeRects(free, kept);
+}
+
+tr::TextureAtlas::TextureAtlas(glm::ivec2 size, int padding, ColorTextureFormat format)
+	: _texture{size, false, format}
+	, _bitmap{size}
+	, _padding{padding}
+	, _free{{{padding, padding}, size - padding}}
+	, _usedArea{0}
+	, _dirty{{0, 0}, {0, 0}}
+{
+	assert(padding >= 0 && size.x > padding && size.y > padding);
+
+	_bitmap.fill({size}, {0, 0, 0, 0});
+	_texture.clear({0, 0, 0, 0});
+}
+
+glm::ivec2 tr::TextureAtlas::size() const noexcept
+{
+	return _bitmap.size();
+}
+
+const tr::ColorTexture2D& tr::TextureAtlas::texture() const noexcept
+{
+	return _texture;
+}
+
+double tr::TextureAtlas::occupancy() const noexcept
+{
+	return static_cast<double>(_usedArea) / (static_cast<double>(size().x) * size().y);
+}
+
+std::optional<tr::RectI2> tr::TextureAtlas::insert(const SubBitmap& bitmap)
+{
+	assert(bitmap.size().x > 0 && bitmap.size().y > 0);
+
+	const glm::ivec2 paddedSize{bitmap.size() + _padding};
+	const auto       freeIt{findAtlasFreeRect(_free, paddedSize)};
+	if (freeIt == _free.end()) {
+		return std::nullopt;
+	}
+	const RectI2 placed{freeIt->tl, paddedSize};
+
+	std::vector<RectI2> free{_free};
+	splitAtlasFreeRects(free, placed);
+	_used.push_back(placed);
+	_free = std::move(free);
+
+	_usedArea += static_cast<std::int64_t>(paddedSize.x) * paddedSize.y;
+	_bitmap.fill(placed, {0, 0, 0, 0});
+	// Bitmap::blit() blends the source onto the destination, which would premultiply it by its alpha, so the pixels
+	// are copied over directly instead.
+	std::byte* const destination{_bitmap.data() + placed.tl.y * _bitmap.pitch() +
+								 placed.tl.x * _bitmap.format().pixelBytes()};
+	if (!convertPixels(bitmap.data(), bitmap.pitch(), bitmap.format(), destination, _bitmap.pitch(), _bitmap.format(),
+					   bitmap.size())) {
+		for (int y = 0; y < bitmap.size().y; ++y) {
+			for (int x = 0; x < bitmap.size().x; ++x) {
+				_bitmap[placed.tl + glm::ivec2{x, y}] = static_cast<RGBA8>(bitmap[{x, y}]);
+			}
+		}
+	}
+	_dirty = _dirty.size == glm::ivec2{0, 0} ? placed : atlasBoundingBox(_dirty, placed);
+	return RectI2{placed.tl, bitmap.size()};
+}
+
+void tr::TextureAtlas::erase(const RectI2& rect)
+{
+	const RectI2 freed{rect.tl, rect.size + _padding};
+	const auto   usedIt{std::ranges::find(_used, freed)};
+	assert(usedIt != _used.end());
+
+	if (_used.size() == 1) {
+		clear();
+		return;
+	}
+
+	// Only the maximal free rects that intersect the freed rect can be new, so only those are recomputed: starting
+	// from the whole atlas, every other occupied rect is cut out while discarding pieces that miss the freed rect.
+	std::vector<RectI2> grown{{{_padding, _padding}, size() - _padding}};
+	for (auto it = _used.begin(); it != _used.end(); ++it) {
+		if (it != usedIt) {
+			splitAtlasFreeRects(grown, *it);
+			std::erase_if(grown, [&](const RectI2& piece) { return !atlasRectsOverlap(piece, freed); });
+		}
+	}
+
+	// Old free rects that can now grow into the freed rect are contained in one of the new ones.
+	std::vector<RectI2> free;
+	free.reserve(_free.size() + grown.size());
+	for (const RectI2& old : _free) {
+		if (std::ranges::none_of(grown, [&](const RectI2& piece) { return atlasRectContains(piece, old); })) {
+			free.push_back(old);
+		}
+	}
+	free.insert(free.end(), grown.begin(), grown.end());
+	_free = std::move(free);
+
+	*usedIt = _used.back();
+	_used.pop_back();
+	_usedArea -= static_cast<std::int64_t>(freed.size.x) * freed.size.y;
+}
+
+void tr::TextureAtlas::clear() noexcept
+{
+	// The vector always has room for at least one rect, so this never allocates.
+	_free.clear();
+	_free.push_back({{_padding, _padding}, size() - _padding});
+	_used.clear();
+	_usedArea = 0;
+}
+
+tr::RectF2 tr::TextureAtlas::uv(const RectI2& rect) const noexcept
+{
+	const glm::vec2 atlasSize{size()};
+	return {glm::vec2{rect.tl} / atlasSize, glm::vec2{rect.size} / atlasSize};
+}
+
+void tr::TextureAtlas::upload() noexcept
+{
+	if (_dirty.size == glm::ivec2{0, 0}) {
+		return;
+	}
+
+	_texture.setRegion(_dirty.tl, _bitmap.sub(_dirty));
+	_dirty = {{0, 0}, {0, 0}};
+}
+
+void tr::TextureAtlas::setLabel(std::string_view label) noexcept
+{
+	_texture.setLabel(label);
+}
@@ -0,0 +1,572 @@
+#include "../include/tr/texture_compression.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TR_TEXTURE_COMPRESSION_SSE2
+#include <immintrin.h>
+#endif
+
+namespace tr {
+	// A channel of a 4x4 block, in row-major order.
+	using BlockChannel = std::array<float, 16>;
+
+	// 4x4 block of texels, stored channel by channel.
+	struct TexelBlock {
+		std::array<BlockChannel, 4> channels; // The R, G, B and A values of the texels in [0, 255].
+	};
+
+	// Palette of values a block's texels can take, stored channel by channel.
+	struct BlockPalette {
+		std::array<BlockChannel, 4> channels; // The channel values of the palette entries.
+		int                         size;     // The number of entries in the palette.
+	};
+
+	// Writes a little-endian stream of bits into a zero-initialized block.
+	struct BlockBitWriter {
+		std::byte* out; // The block being written.
+		int        bit; // The index of the next bit to write.
+
+		// Writes the lowest bits of a value.
+		void write(std::uint32_t value, int bits) noexcept;
+	};
+
+	// The interpolation weights of 4-bit BC7 indices, out of 64.
+	inline constexpr std::array<int, 16> BC7_WEIGHTS{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+	// Gets the size of a block of a compressed format in bytes.
+	std::size_t compressedBlockBytes(ColorTextureFormat format) noexcept;
+	// Loads a block, replicating the edge texels of the bitmap for blocks that extend past it.
+	void loadTexelBlock(const SubBitmap& bitmap, glm::ivec2 tl, TexelBlock& block) noexcept;
+	// Fits a line through the weighted texels of a block along their principal axis.
+	// Returns the extreme points of the texels projected onto the line.
+	std::pair<glm::vec4, glm::vec4> fitBlockLine(const TexelBlock& block, int channels,
+												 const BlockChannel& weights) noexcept;
+	// Finds the nearest palette entry to every texel of a block.
+	// Returns the total squared error of the texels, scaled by their weights.
+	float findBlockIndices(const BlockChannel* channels, int count, const BlockPalette& palette,
+						   const BlockChannel& weights, std::array<std::uint8_t, 16>& indices) noexcept;
+	// Solves for the endpoints that minimize the squared error of a block, given per-texel fractions of the first.
+	// Returns false if the system is degenerate (all texels share an index).
+	bool solveBlockEndpoints(const TexelBlock& block, const BlockChannel& fractions, const BlockChannel& weights,
+							 glm::vec4& e0, glm::vec4& e1) noexcept;
+
+	// Encodes the color of a block as a BC1 block.
+	// With punchthrough alpha, texels with an alpha below 128 are encoded as transparent.
+	void encodeBC1Block(const TexelBlock& block, bool punchthrough, std::byte* out) noexcept;
+	// Encodes a channel of a block as a BC4 block.
+	void encodeBC4Block(const TexelBlock& block, int channel, std::byte* out) noexcept;
+	// Encodes a block as a mode 6 BC7 block.
+	void encodeBC7Block(const TexelBlock& block, std::byte* out) noexcept;
+	// Encodes a range of block rows of a bitmap in the RGBA8 pixel format.
+	void encodeBlockRows(const SubBitmap& bitmap, ColorTextureFormat format, int first, int last,
+						 std::byte* out) noexcept;
+} // namespace tr
+
+void tr::BlockBitWriter::write(std::uint32_t value, int bits) noexcept
+{
+	for (int i = 0; i < bits; ++i, ++bit) {
+		if ((value >> i) & 1) {
+			out[bit / 8] |= std::byte(1 << (bit % 8));
+		}
+	}
+}
+
+std::size_t tr::compressedBlockBytes(ColorTextureFormat format) noexcept
+{
+	switch (format) {
+	case ColorTextureFormat::BC1_RGB:
+	case ColorTextureFormat::BC1_RGBA:
+	case ColorTextureFormat::BC1_SRGB:
+	case ColorTextureFormat::BC1_SRGBA:
+	case ColorTextureFormat::BC4_R:
+	case ColorTextureFormat::BC4_R_SNORM:
+	case ColorTextureFormat::ETC2_RGB8:
+	case ColorTextureFormat::ETC2_SRGB8:
+	case ColorTextureFormat::ETC2_RGB8A1:
+		return 8;
+	default:
+		return 16;
+	}
+}
+
+void tr::loadTexelBlock(const SubBitmap& bitmap, glm::ivec2 tl, TexelBlock& block) noexcept
+{
+	const glm::ivec2 size{bitmap.size()};
+	for (int y = 0; y < 4; ++y) {
+		const int    sy{std::min(tl.y + y, size.y - 1)};
+		const RGBA8* row{reinterpret_cast<const RGBA8*>(bitmap.data() + sy * bitmap.pitch())};
+		for (int x = 0; x < 4; ++x) {
+			const RGBA8 texel{row[std::min(tl.x + x, size.x - 1)]};
+			block.channels[0][y * 4 + x] = texel.r;
+			block.channels[1][y * 4 + x] = texel.g;
+			block.channels[2][y * 4 + x] = texel.b;
+			block.channels[3][y * 4 + x] = texel.a;
+		}
+	}
+}
+
+std::pair<glm::vec4, glm::vec4> tr::fitBlockLine(const TexelBlock& block, int channels,
+												 const BlockChannel& weights) noexcept
+{
+	glm::vec4 mean{0};
+	float     total{0};
+	for (int i = 0; i < 16; ++i) {
+		for (int c = 0; c < channels; ++c) {
+			mean[c] += block.channels[c][i] * weights[i];
+		}
+		total += weights[i];
+	}
+	if (total == 0) {
+		return {mean, mean};
+	}
+	mean /= total;
+
+	std::array<std::array<float, 4>, 4> covariance{};
+	for (int i = 0; i < 16; ++i) {
+		for (int a = 0; a < channels; ++a) {
+			for (int b = 0; b < channels; ++b) {
+				covariance[a][b] +=
+					(block.channels[a][i] - mean[a]) * (block.channels[b][i] - mean[b]) * weights[i];
+			}
+		}
+	}
+
+	// Power iteration, starting from the row of the channel with the largest variance.
+	int largest{0};
+	for (int c = 1; c < channels; ++c) {
+		if (covariance[c][c] > covariance[largest][largest]) {
+			largest = c;
+		}
+	}
+	glm::vec4 axis{covariance[largest][0], covariance[largest][1], covariance[largest][2], covariance[largest][3]};
+	for (int iteration = 0; iteration < 8; ++iteration) {
+		glm::vec4 next{0};
+		float     scale{0};
+		for (int a = 0; a < channels; ++a) {
+			for (int b = 0; b < channels; ++b) {
+				next[a] += covariance[a][b] * axis[b];
+			}
+			scale = std::max(scale, std::abs(next[a]));
+		}
+		if (scale == 0) {
+			break;
+		}
+		axis = next / scale;
+	}
+	if (glm::length(axis) == 0) {
+		return {mean, mean};
+	}
+	axis = glm::normalize(axis);
+
+	float min{std::numeric_limits<float>::max()};
+	float max{std::numeric_limits<float>::lowest()};
+	for (int i = 0; i < 16; ++i) {
+		if (weights[i] > 0) {
+			float t{0};
+			for (int c = 0; c < channels; ++c) {
+				t += (block.channels[c][i] - mean[c]) * axis[c];
+			}
+			min = std::min(min, t);
+			max = std::max(max, t);
+		}
+	}
+	return {mean + axis * min, mean + axis * max};
+}
+
+float tr::findBlockIndices(const BlockChannel* channels, int count, const BlockPalette& palette,
+						   const BlockChannel& weights, std::array<std::uint8_t, 16>& indices) noexcept
+{
+	float error{0};
+#ifdef TR_TEXTURE_COMPRESSION_SSE2
+	// Four texels are matched against the palette at a time.
+	for (int i = 0; i < 16; i += 4) {
+		__m128 best{_mm_set1_ps(std::numeric_limits<float>::max())};
+		__m128 bestIndex{_mm_setzero_ps()};
+		for (int p = 0; p < palette.size; ++p) {
+			__m128 distance{_mm_setzero_ps()};
+			for (int c = 0; c < count; ++c) {
+				const __m128 delta{_mm_sub_ps(_mm_loadu_ps(&channels[c][i]), _mm_set1_ps(palette.channels[c][p]))};
+				distance = _mm_add_ps(distance, _mm_mul_ps(delta, delta));
+			}
+			const __m128 closer{_mm_cmplt_ps(distance, best)};
+			best = _mm_min_ps(distance, best);
+			bestIndex = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps(float(p))), _mm_andnot_ps(closer, bestIndex));
+		}
+
+		alignas(16) std::array<float, 4> bestIndices;
+		alignas(16) std::array<float, 4> errors;
+		_mm_store_ps(bestIndices.data(), bestIndex);
+		_mm_store_ps(errors.data(), _mm_mul_ps(best, _mm_loadu_ps(&weights[i])));
+		for (int j = 0; j < 4; ++j) {
+			indices[i + j] = static_cast<std::uint8_t>(bestIndices[j]);
+			error += errors[j];
+		}
+	}
+#else
+	for (int i = 0; i < 16; ++i) {
+		float best{std::numeric_limits<float>::max()};
+		for (int p = 0; p < palette.size; ++p) {
+			float distance{0};
+			for (int c = 0; c < count; ++c) {
+				const float delta{channels[c][i] - palette.channels[c][p]};
+				distance += delta * delta;
+			}
+			if (distance < best) {
+				best = distance;
+				indices[i] = static_cast<std::uint8_t>(p);
+			}
+		}
+		error += best * weights[i];
+	}
+#endif
+	return error;
+}
+
+bool tr::solveBlockEndpoints(const TexelBlock& block, const BlockChannel& fractions, const BlockChannel& weights,
+							 glm::vec4& e0, glm::vec4& e1) noexcept
+{
+	float     aa{0}, ab{0}, bb{0};
+	glm::vec4 ax{0}, bx{0};
+	for (int i = 0; i < 16; ++i) {
+		const float     a{fractions[i] * weights[i]};
+		const float     b{(1 - fractions[i]) * weights[i]};
+		const glm::vec4 texel{block.channels[0][i], block.channels[1][i], block.channels[2][i], block.channels[3][i]};
+		aa += a * fractions[i];
+		ab += a * (1 - fractions[i]);
+		bb += b * (1 - fractions[i]);
+		ax += texel * a;
+		bx += texel * b;
+	}
+
+	const float determinant{aa * bb - ab * ab};
+	if (std::abs(determinant) < 1e-6f) {
+		return false;
+	}
+	e0 = glm::clamp((ax * bb - bx * ab) / determinant, 0.0f, 255.0f);
+	e1 = glm::clamp((bx * aa - ax * ab) / determinant, 0.0f, 255.0f);
+	return true;
+}
+
+void tr::encodeBC1Block(const TexelBlock& block, bool punchthrough, std::byte* out) noexcept
+{
+	const auto pack{[](glm::vec4 color) {
+		const glm::ivec3 c{glm::clamp(glm::round(glm::vec3{color} * glm::vec3{31, 63, 31} / 255.0f),
+									  glm::vec3{0}, glm::vec3{31, 63, 31})};
+		return static_cast<std::uint16_t>((c.x << 11) | (c.y << 5) | c.z);
+	}};
+	const auto unpack{[](std::uint16_t color) {
+		const int r{(color >> 11) & 31}, g{(color >> 5) & 63}, b{color & 31};
+		return glm::vec4{(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255};
+	}};
+
+	BlockChannel weights;
+	bool         transparent{false};
+	for (int i = 0; i < 16; ++i) {
+		weights[i] = !punchthrough || block.channels[3][i] >= 128;
+		transparent |= weights[i] == 0;
+	}
+
+	// Blocks with transparent texels use the 3-color mode, whose fourth index is transparent black.
+	const std::array<float, 4> fractions{1, 0, transparent ? 0.5f : 2 / 3.0f, 1 / 3.0f};
+	const auto evaluate{[&](std::uint16_t c0, std::uint16_t c1, std::array<std::uint8_t, 16>& indices) {
+		const glm::vec4 e0{unpack(c0)}, e1{unpack(c1)};
+		BlockPalette    palette{{}, transparent ? 3 : 4};
+		for (int p = 0; p < palette.size; ++p) {
+			const glm::vec4 color{glm::round(e0 * fractions[p] + e1 * (1 - fractions[p]))};
+			for (int c = 0; c < 3; ++c) {
+				palette.channels[c][p] = color[c];
+			}
+		}
+		return findBlockIndices(block.channels.data(), 3, palette, weights, indices);
+	}};
+
+	std::uint16_t                c0{0}, c1{0};
+	std::array<std::uint8_t, 16> indices{};
+	if (std::ranges::any_of(weights, [](float weight) { return weight > 0; })) {
+		auto [min, max]{fitBlockLine(block, 3, weights)};
+		// Insetting the endpoints slightly reduces the error of texels near the middle of the line.
+		const glm::vec4 inset{(max - min) / 16.0f};
+		c0 = pack(max - inset);
+		c1 = pack(min + inset);
+		float error{evaluate(c0, c1, indices)};
+
+		for (int iteration = 0; iteration < 2 && error > 0; ++iteration) {
+			BlockChannel texelFractions;
+			for (int i = 0; i < 16; ++i) {
+				texelFractions[i] = fractions[indices[i]];
+			}
+			glm::vec4 e0, e1;
+			if (!solveBlockEndpoints(block, texelFractions, weights, e0, e1)) {
+				break;
+			}
+
+			std::array<std::uint8_t, 16> refinedIndices;
+			const std::uint16_t          r0{pack(e0)}, r1{pack(e1)};
+			const float                  refinedError{evaluate(r0, r1, refinedIndices)};
+			if (refinedError >= error) {
+				break;
+			}
+			c0 = r0;
+			c1 = r1;
+			indices = refinedIndices;
+			error = refinedError;
+		}
+	}
+
+	// The mode is selected by the order of the endpoints: c0 > c1 for 4 colors, c0 <= c1 for 3 colors.
+	if (transparent ? c0 > c1 : c0 < c1) {
+		std::swap(c0, c1);
+		for (std::uint8_t& index : indices) {
+			if (index < 2 || !transparent) {
+				index ^= 1;
+			}
+		}
+	}
+	std::uint32_t bits{0};
+	for (int i = 0; i < 16; ++i) {
+		bits |= std::uint32_t(weights[i] > 0 ? indices[i] : 3) << (2 * i);
+	}
+
+	BlockBitWriter writer{out, 0};
+	writer.write(c0, 16);
+	writer.write(c1, 16);
+	writer.write(bits, 32);
+}
+
+void tr::encodeBC4Block(const TexelBlock& block, int channel, std::byte* out) noexcept
+{
+	const BlockChannel& values{block.channels[channel]};
+	const auto [min, max]{std::ranges::minmax(values)};
+	const int a0{static_cast<int>(std::lround(max))};
+	const int a1{static_cast<int>(std::lround(min))};
+	out[0] = std::byte(a0);
+	out[1] = std::byte(a1);
+	if (a0 == a1) {
+		return;
+	}
+
+	// 8-value mode (a0 > a1): the endpoints followed by 6 interpolated values.
+	BlockPalette palette{{}, 8};
+	palette.channels[0][0] = float(a0);
+	palette.channels[0][1] = float(a1);
+	for (int p = 2; p < 8; ++p) {
+		palette.channels[0][p] = float(((8 - p) * a0 + (p - 1) * a1) / 7);
+	}
+
+	BlockChannel weights;
+	weights.fill(1);
+	std::array<std::uint8_t, 16> indices;
+	findBlockIndices(&values, 1, palette, weights, indices);
+
+	BlockBitWriter writer{out + 2, 0};
+	for (std::uint8_t index : indices) {
+		writer.write(index, 3);
+	}
+}
+
+void tr::encodeBC7Block(const TexelBlock& block, std::byte* out) noexcept
+{
+	// Mode 6 endpoints are 7 bits per channel plus a parity bit shared by the channels of an endpoint.
+	struct Endpoint {
+		glm::ivec4 value; // The 7-bit channel values.
+		int        parity; // The parity bit shared by the channels.
+
+		glm::ivec4 expand() const noexcept
+		{
+			return value * 2 + parity;
+		}
+	};
+	const auto quantize{[](glm::vec4 color) {
+		Endpoint best{};
+		float    bestError{std::numeric_limits<float>::max()};
+		for (int parity = 0; parity < 2; ++parity) {
+			const glm::ivec4 value{glm::round((color - float(parity)) / 2.0f)};
+			const Endpoint   endpoint{glm::clamp(value, 0, 127), parity};
+			const glm::vec4  delta{glm::vec4{endpoint.expand()} - color};
+			const float      error{glm::dot(delta, delta)};
+			if (error < bestError) {
+				best = endpoint;
+				bestError = error;
+			}
+		}
+		return best;
+	}};
+
+	BlockChannel weights;
+	weights.fill(1);
+	const auto evaluate{[&](const Endpoint& e0, const Endpoint& e1, std::array<std::uint8_t, 16>& indices) {
+		const glm::ivec4 a{e0.expand()}, b{e1.expand()};
+		BlockPalette     palette{{}, 16};
+		for (int p = 0; p < 16; ++p) {
+			const glm::ivec4 color{(a * (64 - BC7_WEIGHTS[p]) + b * BC7_WEIGHTS[p] + 32) / 64};
+			for (int c = 0; c < 4; ++c) {
+				palette.channels[c][p] = float(color[c]);
+			}
+		}
+		return findBlockIndices(block.channels.data(), 4, palette, weights, indices);
+	}};
+
+	auto [min, max]{fitBlockLine(block, 4, weights)};
+	Endpoint                     e0{quantize(min)}, e1{quantize(max)};
+	std::array<std::uint8_t, 16> indices;
+	float                        error{evaluate(e0, e1, indices)};
+	for (int iteration = 0; iteration < 2 && error > 0; ++iteration) {
+		BlockChannel fractions;
+		for (int i = 0; i < 16; ++i) {
+			fractions[i] = 1 - BC7_WEIGHTS[indices[i]] / 64.0f;
+		}
+		glm::vec4 r0, r1;
+		if (!solveBlockEndpoints(block, fractions, weights, r0, r1)) {
+			break;
+		}
+
+		std::array<std::uint8_t, 16> refinedIndices;
+		const Endpoint               q0{quantize(r0)}, q1{quantize(r1)};
+		const float                  refinedError{evaluate(q0, q1, refinedIndices)};
+		if (refinedError >= error) {
+			break;
+		}
+		e0 = q0;
+		e1 = q1;
+		indices = refinedIndices;
+		error = refinedError;
+	}
+
+	// The most significant bit of the first index is implicitly 0, so the endpoints are swapped if it's set.
+	if (indices[0] >= 8) {
+		std::swap(e0, e1);
+		for (std::uint8_t& index : indices) {
+			index = 15 - index;
+		}
+	}
+
+	BlockBitWriter writer{out, 0};
+	writer.write(1 << 6, 7);
+	for (int c = 0; c < 4; ++c) {
+		writer.write(e0.value[c], 7);
+		writer.write(e1.value[c], 7);
+	}
+	writer.write(e0.parity, 1);
+	writer.write(e1.parity, 1);
+	writer.write(indices[0], 3);
+	for (int i = 1; i < 16; ++i) {
+		writer.write(indices[i], 4);
+	}
+}
+
+void tr::encodeBlockRows(const SubBitmap& bitmap, ColorTextureFormat format, int first, int last,
+						 std::byte* out) noexcept
+{
+	const int         blocksPerRow{(bitmap.size().x + 3) / 4};
+	const std::size_t blockBytes{compressedBlockBytes(format)};
+	TexelBlock        block;
+	for (int y = first; y < last; ++y) {
+		for (int x = 0; x < blocksPerRow; ++x) {
+			std::byte* const dst{out + (std::size_t(y) * blocksPerRow + x) * blockBytes};
+			loadTexelBlock(bitmap, {x * 4, y * 4}, block);
+			switch (format) {
+			case ColorTextureFormat::BC1_RGB:
+			case ColorTextureFormat::BC1_SRGB:
+				encodeBC1Block(block, false, dst);
+				break;
+			case ColorTextureFormat::BC1_RGBA:
+			case ColorTextureFormat::BC1_SRGBA:
+				encodeBC1Block(block, true, dst);
+				break;
+			case ColorTextureFormat::BC3_RGBA:
+			case ColorTextureFormat::BC3_SRGBA:
+				encodeBC4Block(block, 3, dst);
+				encodeBC1Block(block, false, dst + 8);
+				break;
+			case ColorTextureFormat::BC4_R:
+				encodeBC4Block(block, 0, dst);
+				break;
+			case ColorTextureFormat::BC5_RG:
+				encodeBC4Block(block, 0, dst);
+				encodeBC4Block(block, 1, dst + 8);
+				break;
+			case ColorTextureFormat::BC7_RGBA:
+			case ColorTextureFormat::BC7_SRGBA:
+				encodeBC7Block(block, dst);
+				break;
+			default:
+				assert(false);
+			}
+		}
+	}
+}
+
+bool tr::compressedFormat(ColorTextureFormat format) noexcept
+{
+	switch (format) {
+	case ColorTextureFormat::BC1_RGB:
+	case ColorTextureFormat::BC1_RGBA:
+	case ColorTextureFormat::BC1_SRGB:
+	case ColorTextureFormat::BC1_SRGBA:
+	case ColorTextureFormat::BC3_RGBA:
+	case ColorTextureFormat::BC3_SRGBA:
+	case ColorTextureFormat::BC4_R:
+	case ColorTextureFormat::BC4_R_SNORM:
+	case ColorTextureFormat::BC5_RG:
+	case ColorTextureFormat::BC5_RG_SNORM:
+	case ColorTextureFormat::BC7_RGBA:
+	case ColorTextureFormat::BC7_SRGBA:
+	case ColorTextureFormat::ETC2_RGB8:
+	case ColorTextureFormat::ETC2_SRGB8:
+	case ColorTextureFormat::ETC2_RGB8A1:
+	case ColorTextureFormat::ETC2_RGBA8:
+	case ColorTextureFormat::ETC2_SRGBA8:
+		return true;
+	default:
+		return false;
+	}
+}
+
+std::size_t tr::compressedImageBytes(glm::ivec2 size, ColorTextureFormat format) noexcept
+{
+	assert(size.x > 0 && size.y > 0);
+	assert(compressedFormat(format));
+
+	return std::size_t((size.x + 3) / 4) * ((size.y + 3) / 4) * compressedBlockBytes(format);
+}
+
+tr::CompressedImage tr::compressBitmap(const SubBitmap& bitmap, ColorTextureFormat format, int threads)
+{
+	assert(compressedFormat(format) && format != ColorTextureFormat::BC4_R_SNORM &&
+		   format != ColorTextureFormat::BC5_RG_SNORM && format < ColorTextureFormat::ETC2_RGB8);
+	assert(threads >= 0);
+
+	const BitmapFormat    FORMAT{BITMAP_PIXEL_FORMAT<RGBA8>};
+	std::optional<Bitmap> converted;
+	if (bitmap.format() != FORMAT) {
+		converted.emplace(bitmap, FORMAT);
+	}
+	const SubBitmap source{converted.has_value() ? SubBitmap{*converted} : bitmap};
+
+	CompressedImage image{bitmap.size(), format, std::vector<std::byte>(compressedImageBytes(bitmap.size(), format))};
+	const int       rows{(bitmap.size().y + 3) / 4};
+	if (threads == 0) {
+		threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+	}
+	threads = std::min(threads, rows);
+
+	// The calling thread encodes the first share of the rows itself.
+	std::vector<std::thread> workers;
+	try {
+		workers.reserve(threads - 1);
+		for (int i = 1; i < threads; ++i) {
+			workers.emplace_back(encodeBlockRows, std::cref(source), format, rows * i / threads,
+								 rows * (i + 1) / threads, image.blocks.data());
+		}
+	}
+	catch (...) {
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+		throw;
+	}
+	encodeBlockRows(source, format, 0, rows / threads, image.blocks.data());
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	return image;
+}
@@ -0,0 +1,156 @@
+#include "../include/tr/texture_table.hpp"
+#include "../include/tr/ranges.hpp"
+#include "bindless_texture.hpp"
+
+bool tr::bindlessTexturesSupported() noexcept
+{
+	return _bindlessTexture.has_value();
+}
+
+tr::TextureTable::TextureTable(std::size_t capacity, glm::ivec2 fallbackLayerSize, ColorTextureFormat fallbackFormat)
+	: _buffer{0, capacity * sizeof(TextureTableEntry), ShaderBuffer::Access::WRITE_ONLY}
+	, _dirty{false}
+	, _mipsDirty{false}
+{
+	assert(capacity > 0);
+
+	if (!bindlessTexturesSupported()) {
+		_fallback.emplace(fallbackLayerSize, static_cast<int>(capacity), true, fallbackFormat);
+	}
+	_entries.reserve(capacity);
+	_slots.reserve(capacity);
+	_free.reserve(capacity);
+}
+
+tr::TextureTable::~TextureTable() noexcept
+{
+	if (_fallback.has_value()) {
+		return;
+	}
+	for (const Slot& slot : _slots) {
+		if (slot.texture != 0) {
+			releaseTextureHandle(slot.handle);
+		}
+	}
+}
+
+tr::TextureTable& tr::TextureTable::operator=(TextureTable&& r) noexcept
+{
+	std::ignore = TextureTable{std::move(*this)};
+	_buffer    = std::move(r._buffer);
+	_fallback  = std::move(r._fallback);
+	_entries   = std::move(r._entries);
+	_slots     = std::move(r._slots);
+	_free      = std::move(r._free);
+	_indices   = std::move(r._indices);
+	_dirty     = r._dirty;
+	_mipsDirty = r._mipsDirty;
+	return *this;
+}
+
+bool tr::TextureTable::bindless() const noexcept
+{
+	return !_fallback.has_value();
+}
+
+std::size_t tr::TextureTable::size() const noexcept
+{
+	return _indices.size();
+}
+
+std::size_t tr::TextureTable::capacity() const noexcept
+{
+	return _buffer.arrayCapacity() / sizeof(TextureTableEntry);
+}
+
+std::uint32_t tr::TextureTable::add(const ColorTexture2D& texture)
+{
+	const unsigned int id{static_cast<const Texture&>(texture)._id.get()};
+	if (const auto it{_indices.find(id)}; it != _indices.end()) {
+		return it->second;
+	}
+	assert(size() < capacity());
+
+	std::uint64_t handle{0};
+	if (bindless()) {
+		handle = TR_RETURNING_GL_CALL(_bindlessTexture->getTextureHandle, id);
+		acquireTextureHandle(handle);
+	}
+	const std::uint32_t index{_free.empty() ? static_cast<std::uint32_t>(_slots.size()) : _free.back()};
+	try {
+		_indices.emplace(id, index);
+	}
+	catch (...) {
+		if (bindless()) {
+			releaseTextureHandle(handle);
+		}
+		throw;
+	}
+	if (_free.empty()) {
+		_slots.emplace_back();
+		_entries.emplace_back();
+	}
+	else {
+		_free.pop_back();
+	}
+
+	Slot&              slot{_slots[index]};
+	TextureTableEntry& entry{_entries[index]};
+	slot.texture = id;
+	slot.handle  = handle;
+	if (bindless()) {
+		entry = {{static_cast<std::uint32_t>(handle), static_cast<std::uint32_t>(handle >> 32)}, {1, 1}};
+	}
+	else {
+		const glm::ivec2 textureSize{texture.size()};
+		const glm::ivec2 layerSize{_fallback->size()};
+		assert(RectI2{layerSize}.contains(textureSize));
+
+		TR_GL_CALL(glCopyImageSubData, id, GL_TEXTURE_2D, 0, 0, 0, 0, static_cast<const Texture&>(*_fallback)._id.get(),
+				   GL_TEXTURE_2D_ARRAY, 0, 0, 0, index, textureSize.x, textureSize.y, 1);
+		entry = {{index, 0}, glm::vec2{textureSize} / glm::vec2{layerSize}};
+		_mipsDirty = true;
+	}
+	_dirty = true;
+	return index;
+}
+
+void tr::TextureTable::remove(std::uint32_t index) noexcept
+{
+	assert(index < _slots.size() && _slots[index].texture != 0);
+
+	Slot& slot{_slots[index]};
+	if (bindless()) {
+		releaseTextureHandle(slot.handle);
+	}
+	_indices.erase(slot.texture);
+	slot = {};
+	_entries[index] = {};
+	// The free list never needs to grow past the capacity reserved in the constructor.
+	_free.push_back(index);
+	_dirty = true;
+}
+
+void tr::TextureTable::update() noexcept
+{
+	if (_dirty) {
+		_buffer.setArray(_entries);
+		_dirty = false;
+	}
+	if (_mipsDirty) {
+		_fallback->generateMipmaps();
+		_mipsDirty = false;
+	}
+}
+
+tr::ShaderBuffer& tr::TextureTable::buffer() noexcept
+{
+	return _buffer;
+}
+
+const tr::ArrayColorTexture2D& tr::TextureTable::fallbackTexture() const noexcept
+{
+	assert(!bindless());
+
+	return *_fallback;
+}
@@ -1,33 +1,124 @@
+#include "../include/tr/sampler.hpp"
 #include "../include/tr/texture.hpp"
 #include "../include/tr/texture_unit.hpp"
-#include "gl_call.hpp"
-#include <bitset>
+#include "gl_state.hpp"
 
 namespace tr {
-	// Defined by the OpenGL standard.
-	inline constexpr int MAX_TEX_UNITS{80};
-	// Bitset where used up units are marked as bit flags.
-	std::bitset<MAX_TEX_UNITS> _texUnitPool;
+	// Stack of unused texture units.
+	struct TextureUnitPool {
+		std::array<unsigned int, GL_STATE_TEX_UNITS> free;         // The unused units, next unit to hand out last.
+		std::size_t                                  size;         // The number of unused units.
+		std::array<bool, GL_STATE_TEX_UNITS>         samplerBound; // Whether a sampler was bound through each unit.
+	};
+
+	// Pool of unused texture units, handing out the lowest units first so that allocations stay contiguous.
+	TextureUnitPool _texUnitPool{[] {
+		TextureUnitPool pool{{}, GL_STATE_TEX_UNITS, {}};
+		for (std::size_t i = 0; i < pool.free.size(); ++i) {
+			pool.free[i] = static_cast<unsigned int>(pool.free.size() - 1 - i);
+		}
+		return pool;
+	}()};
 } // namespace tr
 
 tr::TextureUnit::TextureUnit() noexcept
 {
-	assert(!_texUnitPool.all());
-	for (std::size_t i = 0; i < _texUnitPool.size(); ++i) {
-		if (!_texUnitPool[i]) {
-			_texUnitPool[i] = true;
-			_id.reset(i);
-			return;
-		}
-	}
+	assert(_texUnitPool.size > 0);
+	_id.reset(_texUnitPool.free[--_texUnitPool.size]);
 }
 
 void tr::TextureUnit::Deleter::operator()(GLuint id) noexcept
 {
-	_texUnitPool[id] = false;
+	// The unit is handed out again next, so it must not keep overriding the sampling state of textures.
+	// Units that never had a sampler are left alone, keeping their release free of GL calls.
+	if (_texUnitPool.samplerBound[id]) {
+		_texUnitPool.samplerBound[id] = false;
+		if (_glState.change(_glState.samplers[id], 0U)) {
+			TR_GL_CALL(glBindSampler, id, 0);
+		}
+	}
+	_texUnitPool.free[_texUnitPool.size++] = id;
 }
 
 void tr::TextureUnit::setTexture(const Texture& texture) noexcept
 {
-	TR_GL_CALL(glBindTextures, _id.get(), 1, &texture._id.get());
+	if (_glState.change(_glState.textures[_id.get()], texture._id.get())) {
+		TR_GL_CALL(glBindTextures, _id.get(), 1, &texture._id.get());
+	}
+}
+
+void tr::TextureUnit::setSampler(const Sampler& sampler) noexcept
+{
+	_texUnitPool.samplerBound[_id.get()] = true;
+	if (_glState.change(_glState.samplers[_id.get()], sampler._id.get())) {
+		TR_GL_CALL(glBindSampler, _id.get(), sampler._id.get());
+	}
+}
+
+void tr::TextureUnit::clearSampler() noexcept
+{
+	_texUnitPool.samplerBound[_id.get()] = false;
+	if (_glState.change(_glState.samplers[_id.get()], 0U)) {
+		TR_GL_CALL(glBindSampler, _id.get(), 0);
+	}
+}
+
+tr::TextureBinder::TextureBinder() noexcept
+	: _pending{}, _first{GL_STATE_TEX_UNITS}, _last{-1}, _calls{0}
+{
+	static_assert(std::tuple_size_v<decltype(_pending)> == GL_STATE_TEX_UNITS);
+}
+
+void tr::TextureBinder::set(const TextureUnit& unit, const Texture& texture) noexcept
+{
+	const int id{static_cast<int>(unit._id.get())};
+	_pending[id] = texture._id.get();
+	_first = std::min(_first, id);
+	_last = std::max(_last, id);
+}
+
+void tr::TextureBinder::flush() noexcept
+{
+	if (_last == -1) {
+		return;
+	}
+
+	std::array<bool, GL_STATE_TEX_UNITS> dirty{};
+	for (int unit = _first; unit <= _last; ++unit) {
+		dirty[unit] = _pending[unit] != 0 && _glState.change(_glState.textures[unit], _pending[unit]);
+	}
+
+	std::array<GLuint, GL_STATE_TEX_UNITS> ids;
+	for (int unit = _first; unit <= _last;) {
+		if (!dirty[unit]) {
+			++unit;
+			continue;
+		}
+
+		// Extend the range over units whose binding is known, as long as another changed unit follows.
+		int last{unit};
+		for (int next = unit + 1; next <= _last; ++next) {
+			if (dirty[next]) {
+				last = next;
+			}
+			else if (!_glState.enabled || !_glState.textures[next].has_value()) {
+				break;
+			}
+		}
+		for (int i = unit; i <= last; ++i) {
+			ids[i] = *_glState.textures[i];
+		}
+		TR_GL_CALL(glBindTextures, unit, last - unit + 1, ids.data() + unit);
+		++_calls;
+		unit = last + 1;
+	}
+
+	std::fill(_pending.begin() + _first, _pending.begin() + _last + 1, 0);
+	_first = GL_STATE_TEX_UNITS;
+	_last = -1;
+}
+
+std::size_t tr::TextureBinder::calls() const noexcept
+{
+	return _calls;
 }
@@ -0,0 +1,69 @@
+#include "../include/tr/texture_upload_queue.hpp"
+#include "../include/tr/texture.hpp"
+#include "bitmap_to_gl_format.hpp"
+
+tr::TextureUploadQueue::TextureUploadQueue(std::size_t capacity, std::size_t framesInFlight)
+	: _ring{capacity, framesInFlight}
+{
+}
+
+std::size_t tr::TextureUploadQueue::capacity() const noexcept
+{
+	return _ring.capacity();
+}
+
+std::size_t tr::TextureUploadQueue::frameSize() const noexcept
+{
+	return _ring.frameSize();
+}
+
+std::size_t tr::TextureUploadQueue::stalls() const noexcept
+{
+	return _ring.stalls();
+}
+
+tr::TextureStagingRegion tr::TextureUploadQueue::stage(glm::ivec2 size, BitmapFormat format) noexcept
+{
+	assert(size.x > 0 && size.y > 0);
+
+	// Rows are laid out the way OpenGL expects them with the default unpack alignment of 4 and no row length.
+	const int                             pitch{(size.x * format.pixelBytes() + 3) / 4 * 4};
+	const StreamingBufferRange<std::byte> range{_ring.allocate<std::byte>(std::size_t(pitch) * size.y, 4)};
+	return {range.data, pitch, size, format, range.offset};
+}
+
+void tr::TextureUploadQueue::submit(ColorTexture2D& texture, glm::ivec2 tl, const TextureStagingRegion& region) noexcept
+{
+	assert(RectI2{texture.size()}.contains(tl + region.size));
+
+	const auto [format, type]{bitmapToGLFormat(region.format)};
+	_ring._buffer.bind(GraphicsBuffer::Target::PIXEL_UNPACK_BUFFER);
+	TR_GL_CALL(glPixelStorei, GL_UNPACK_ROW_LENGTH, 0);
+	TR_GL_CALL(glTextureSubImage2D, static_cast<Texture&>(texture)._id.get(), 0, tl.x, tl.y, region.size.x,
+			   region.size.y, format, type, reinterpret_cast<const void*>(region.offset));
+	TR_GL_CALL(glGenerateTextureMipmap, static_cast<Texture&>(texture)._id.get());
+	// Unbind the buffer so that client memory uploads (like ColorTexture2D::setRegion()) keep working.
+	TR_GL_CALL(glBindBuffer, GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void tr::TextureUploadQueue::upload(ColorTexture2D& texture, glm::ivec2 tl, SubBitmap bitmap) noexcept
+{
+	const TextureStagingRegion region{stage(bitmap.size(), bitmap.format())};
+	const std::size_t          rowBytes{std::size_t(bitmap.size().x) * bitmap.format().pixelBytes()};
+	const std::byte*           src{bitmap.data()};
+	std::byte*                 dst{region.data.data()};
+	for (int y = 0; y < bitmap.size().y; ++y, src += bitmap.pitch(), dst += region.pitch) {
+		std::copy_n(src, rowBytes, dst);
+	}
+	submit(texture, tl, region);
+}
+
+void tr::TextureUploadQueue::endFrame() noexcept
+{
+	_ring.endFrame();
+}
+
+void tr::TextureUploadQueue::setLabel(std::string_view label) noexcept
+{
+	_ring.setLabel(label);
+}
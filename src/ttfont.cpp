@@ -9,13 +9,12 @@ namespace tr {
 
 void tr::fixAlphaArtifacts(Bitmap& bitmap, std::uint8_t maxAlpha) noexcept
 {
-	// We know the bitmap is ARGB_8888.
-	std::uint8_t* it{reinterpret_cast<std::uint8_t*>(bitmap.data())};
-	for (int y = 0; y < bitmap.size().y; ++y) {
-		for (int x = 0; x < bitmap.size().x; ++x) {
-			it[x * 4] = std::min(it[x * 4], maxAlpha);
+	// We know the bitmap is ARGB_8888, so alpha is in the top byte of each native-endian pixel.
+	const std::uint32_t maxAlphaBits{static_cast<std::uint32_t>(maxAlpha) << 24};
+	for (std::span<std::uint32_t> row : bitmap.rows<std::uint32_t>()) {
+		for (std::uint32_t& pixel : row) {
+			pixel = std::min(pixel & 0xFF'00'00'00, maxAlphaBits) | (pixel & 0x00'FF'FF'FF);
 		}
-		it += bitmap.pitch();
 	}
 }
 
@@ -149,6 +148,22 @@ tr::TTFont::Glyph tr::TTFont::glyph(std::uint32_t cp) const noexcept
 	return glyph;
 }
 
+int tr::TTFont::kerning(std::uint32_t left, std::uint32_t right) const noexcept
+{
+	assert(contains(left) && contains(right));
+	return TTF_GetFontKerningSizeGlyphs32(_impl.get(), left, right);
+}
+
+int tr::TTFont::size() const noexcept
+{
+	return _size;
+}
+
+glm::uvec2 tr::TTFont::dpi() const noexcept
+{
+	return _dpi;
+}
+
 void tr::TTFont::resize(int size, glm::uvec2 dpi)
 {
 	if (size == _size && dpi == _dpi) {
@@ -0,0 +1,84 @@
+#include "../include/tr/uniform_buffer.hpp"
+#include "gl_call.hpp"
+
+namespace tr {
+	// Queries the uniform buffer offset alignment of the context.
+	std::size_t uniformBufferOffsetAlignment() noexcept;
+} // namespace tr
+
+std::size_t tr::uniformBufferOffsetAlignment() noexcept
+{
+	GLint alignment;
+	TR_GL_CALL(glGetIntegerv, GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	return std::size_t(std::max(alignment, 1));
+}
+
+tr::UniformBuffer::UniformBuffer(std::size_t capacity, std::size_t framesInFlight)
+	: _ring{capacity, framesInFlight}, _alignment{uniformBufferOffsetAlignment()}, _base{0}, _uploaded{false}
+{
+}
+
+std::size_t tr::UniformBuffer::capacity() const noexcept
+{
+	return _ring.capacity();
+}
+
+std::size_t tr::UniformBuffer::alignment() const noexcept
+{
+	return _alignment;
+}
+
+std::size_t tr::UniformBuffer::stagedSize() const noexcept
+{
+	return _staging.size();
+}
+
+std::size_t tr::UniformBuffer::stalls() const noexcept
+{
+	return _ring.stalls();
+}
+
+tr::UniformBufferBlock tr::UniformBuffer::push(std::span<const std::byte> data)
+{
+	assert(!data.empty());
+	assert(!_uploaded);
+
+	const std::size_t offset{(_staging.size() + _alignment - 1) / _alignment * _alignment};
+	_staging.resize(offset + data.size());
+	std::ranges::copy(data, _staging.begin() + offset);
+	return {offset, data.size()};
+}
+
+void tr::UniformBuffer::upload() noexcept
+{
+	assert(!_uploaded);
+
+	_uploaded = true;
+	if (_staging.empty()) {
+		return;
+	}
+	const StreamingBufferRange<std::byte> range{_ring.allocate<std::byte>(_staging.size(), _alignment)};
+	std::ranges::copy(_staging, range.data.begin());
+	_base = range.offset;
+}
+
+void tr::UniformBuffer::endFrame() noexcept
+{
+	_ring.endFrame();
+	_staging.clear();
+	_base = 0;
+	_uploaded = false;
+}
+
+void tr::UniformBuffer::setLabel(std::string_view label) noexcept
+{
+	_ring.setLabel(label);
+}
+
+void tr::UniformBuffer::bind(std::uint32_t index, UniformBufferBlock block) const noexcept
+{
+	assert(_uploaded);
+	assert(block.offset + block.size <= _staging.size());
+
+	_ring._buffer.bindIndexedRange(GraphicsBuffer::Target::UNIFORM_BUFFER, index, _base + block.offset, block.size);
+}
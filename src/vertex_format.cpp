@@ -1,6 +1,6 @@
 #include "../include/tr/overloaded_lambda.hpp"
 #include "../include/tr/vertex_format.hpp"
-#include "gl_call.hpp"
+#include "gl_state.hpp"
 
 tr::VertexFormat::VertexFormat(std::span<const VertexAttribute> attrs) noexcept
 {
@@ -27,6 +27,7 @@ tr::VertexFormat::VertexFormat(std::span<const VertexAttribute> attrs) noexcept
 
 void tr::VertexFormat::Deleter::operator()(unsigned int id) const noexcept
 {
+	_glState.forgetVertexArray(id);
 	TR_GL_CALL(glDeleteVertexArrays, 1, &id);
 }
 
@@ -37,5 +38,10 @@ void tr::VertexFormat::setLabel(std::string_view label) noexcept
 
 void tr::VertexFormat::bind() const noexcept
 {
-	TR_GL_CALL(glBindVertexArray, _id.get());
+	if (_glState.change(_glState.vertexArray, _id.get())) {
+		// The vertex buffer and index buffer bindings are part of the vertex array state.
+		_glState.vertexBuffer.reset();
+		_glState.indexBuffer.reset();
+		TR_GL_CALL(glBindVertexArray, _id.get());
+	}
 }